@@ -0,0 +1,76 @@
+#include "BenchHarness.h"
+#include "AnalyticWaves.h"
+#include "WaveStore.h"
+
+#include <string>
+
+namespace {
+
+constexpr float MAX_WAVE_RADIUS = 300.0f;
+constexpr float WAVE_SPEED = 150.0f * 1.5f;
+constexpr double FRAME_TIME = 0.016;
+
+} // namespace
+
+// Замеры волн, заданных моментом рождения
+void RunAnalyticWaveBenchmarks()
+{
+    const size_t counts[] = { 10, 1000, 100000, 1000000 };
+
+    for (size_t count : counts) {
+        AnalyticWaveList waves(WAVE_SPEED, MAX_WAVE_RADIUS);
+
+        // Рождения равномерно распределены по времени жизни, поэтому
+        // в каждом кадре гаснет и пересоздаётся постоянная доля волн
+        double now = 0.0;
+        double spawnInterval = waves.Lifetime() / static_cast<double>(count);
+        double nextSpawn = 0.0;
+        auto frame = [&]() {
+            now += FRAME_TIME;
+            waves.DropExpired(now);
+            for (; nextSpawn <= now; nextSpawn += spawnInterval) {
+                waves.Add(0.0f, 0.0f, nextSpawn);
+            }
+        };
+        while (now < waves.Lifetime() * 2.0) {
+            frame();
+        }
+
+        // Малый список обновляется за десятки наносекунд: больше итераций на один замер
+        size_t iterations = count < 1000 ? 20000 : 200;
+        std::string name = "analytic_waves.update/" + std::to_string(count);
+        RunBenchmark(name.c_str(), iterations, waves.Size(), frame);
+
+        // Вычисление состояния при отрисовке - единственный проход по всем волнам
+        float sink = 0.0f;
+        name = "analytic_waves.evaluate/" + std::to_string(count);
+        RunBenchmark(name.c_str(), iterations, waves.Size(), [&]() {
+            waves.ForEach([&](float x, float y, double birthTime) {
+                AnalyticWave wave = { x, y, birthTime };
+                sink += waves.RadiusAt(wave, now) * waves.OpacityAt(wave, now);
+            });
+        });
+        DoNotOptimize(sink);
+    }
+
+    // Хранилище на общем пуле: у части волн собственная скорость
+    for (size_t count : counts) {
+        WaveStore store(WAVE_SPEED, MAX_WAVE_RADIUS);
+        double now = 0.0;
+        size_t spawned = 0;
+        auto frame = [&]() {
+            now += FRAME_TIME;
+            store.Update(now);
+            while (store.Size() < count) {
+                float speed = WAVE_SPEED * (0.5f + static_cast<float>(spawned++ % 97) / 97.0f);
+                store.Add(0.0f, 0.0f, now, speed, MAX_WAVE_RADIUS);
+            }
+        };
+        for (int i = 0; i < 200; ++i) {
+            frame();
+        }
+
+        std::string name = "wave_store.pool_fallback/" + std::to_string(count);
+        RunBenchmark(name.c_str(), count < 1000 ? 20000 : 200, count, frame);
+    }
+}
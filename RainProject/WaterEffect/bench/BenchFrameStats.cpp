@@ -0,0 +1,34 @@
+#include "BenchHarness.h"
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Замеры гистограмм времени кадра
+void RunFrameStatsBenchmarks()
+{
+    const size_t batch = 1024;
+    std::unique_ptr<FrameStats> stats(new FrameStats());
+    std::mt19937_64 random(3);
+    std::vector<uint64_t> samples(batch);
+    for (uint64_t& sample : samples) {
+        sample = 1000 + random() % 20000000;
+    }
+
+    // Запись значения: номер старшего бита, сдвиг и инкремент счётчика
+    RunBenchmark("latency_histogram.record", 1000, batch, [&]() {
+        for (uint64_t sample : samples) {
+            stats->Record(FrameMetric::Update, sample);
+        }
+    });
+
+    // Сводка p50..p99.9 - проход по всем счётчикам на каждый процентиль
+    uint64_t sink = 0;
+    RunBenchmark("latency_histogram.summarize", 1000, 1, [&]() {
+        sink += stats->Histogram(FrameMetric::Update).Summarize().p999;
+    });
+    DoNotOptimize(sink);
+}
@@ -0,0 +1,256 @@
+#include "BenchHarness.h"
+#include "CpuFeatures.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Результат одного замера: время на итерацию в каждом повторе
+struct BenchResult {
+    std::string name;
+    size_t iterations;
+    size_t itemsPerIteration;
+    std::vector<double> iterationNs;
+};
+
+std::vector<BenchResult> g_results;
+
+#ifndef _WIN32
+// Маска процесса до привязки главного потока
+cpu_set_t g_processCpus;
+#endif
+
+// Разбор неотрицательного целого значения аргумента
+bool ParseCount(const char* text, size_t& value)
+{
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (end == text || *end != '\0') {
+        return false;
+    }
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+// Медиана значений (копия сортируется)
+double Median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : 0.5 * (values[middle - 1] + values[middle]);
+}
+
+// Запись строки JSON с экранированием кавычек и обратной косой черты
+void WriteJsonString(FILE* file, const char* text)
+{
+    std::fputc('"', file);
+    for (; *text; ++text) {
+        if (*text == '"' || *text == '\\') {
+            std::fputc('\\', file);
+        }
+        std::fputc(*text, file);
+    }
+    std::fputc('"', file);
+}
+
+void PrintUsage()
+{
+    std::printf("Использование: water_bench [--json=путь] [--warmup=N] [--repetitions=N] [--pin=cpu] [--filter=подстрока]\n");
+}
+
+} // namespace
+
+// Настройки запуска
+BenchSettings& GetBenchSettings()
+{
+    static BenchSettings settings;
+    return settings;
+}
+
+// Разбор аргументов командной строки
+bool ParseBenchSettings(int argc, char** argv)
+{
+    BenchSettings& settings = GetBenchSettings();
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        size_t value = 0;
+        bool ok = true;
+        if (std::strncmp(arg, "--json=", 7) == 0) {
+            settings.jsonPath = arg + 7;
+        } else if (std::strncmp(arg, "--filter=", 9) == 0) {
+            settings.filter = arg + 9;
+        } else if (std::strncmp(arg, "--warmup=", 9) == 0) {
+            ok = ParseCount(arg + 9, settings.warmup);
+        } else if (std::strncmp(arg, "--repetitions=", 14) == 0) {
+            ok = ParseCount(arg + 14, settings.repetitions) && settings.repetitions > 0;
+        } else if (std::strncmp(arg, "--pin=", 6) == 0) {
+            ok = ParseCount(arg + 6, value) && value < 64;
+            settings.pinCpu = static_cast<int>(value);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::printf("Неверный аргумент: %s\n", arg);
+            PrintUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Привязка вызывающего потока к процессору
+bool ApplyCpuPinning()
+{
+    const BenchSettings& settings = GetBenchSettings();
+    if (settings.pinCpu < 0) {
+        return true;
+    }
+
+#ifdef _WIN32
+    DWORD_PTR mask = static_cast<DWORD_PTR>(1) << settings.pinCpu;
+    bool pinned = SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(settings.pinCpu, &set);
+    bool pinned = pthread_getaffinity_np(pthread_self(), sizeof(g_processCpus), &g_processCpus) == 0 &&
+                  pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+
+    if (!pinned) {
+        std::printf("Не удалось привязать поток к процессору %d\n", settings.pinCpu);
+    }
+    return pinned;
+}
+
+// Возврат исходной маски вызывающему потоку. Под Windows новые потоки получают маску
+// процесса, а не создавшего потока, поэтому снимать привязку не нужно
+CpuPinningPause::CpuPinningPause()
+{
+#ifndef _WIN32
+    if (GetBenchSettings().pinCpu >= 0) {
+        pthread_setaffinity_np(pthread_self(), sizeof(g_processCpus), &g_processCpus);
+    }
+#endif
+}
+
+// Повторная привязка вызывающего потока
+CpuPinningPause::~CpuPinningPause()
+{
+#ifndef _WIN32
+    int cpu = GetBenchSettings().pinCpu;
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+}
+
+// Проверка фильтра по имени
+bool IsBenchmarkSelected(const char* name)
+{
+    const char* filter = GetBenchSettings().filter;
+    return !filter || std::strstr(name, filter) != nullptr;
+}
+
+// Учёт одного повтора замера
+void ReportBenchmark(const char* name, double totalNs, size_t iterations, size_t itemsPerIteration)
+{
+    auto found = std::find_if(g_results.begin(), g_results.end(),
+                              [&](const BenchResult& result) { return result.name == name; });
+    if (found == g_results.end()) {
+        g_results.push_back({ name, iterations, itemsPerIteration, {} });
+        found = g_results.end() - 1;
+    }
+    found->iterationNs.push_back(totalNs / static_cast<double>(iterations ? iterations : 1));
+
+    if (found->iterationNs.size() != GetBenchSettings().repetitions) {
+        return;
+    }
+
+    auto range = std::minmax_element(found->iterationNs.begin(), found->iterationNs.end());
+    double perIterationNs = Median(found->iterationNs);
+    double perItemNs = perIterationNs / static_cast<double>(itemsPerIteration ? itemsPerIteration : 1);
+    double spread = perIterationNs > 0.0 ? 50.0 * (*range.second - *range.first) / perIterationNs : 0.0;
+
+    std::printf("%-40s %12.1f ns/iter %10.3f ns/item %10.1f Mitems/s  ±%.1f%%\n",
+                name, perIterationNs, perItemNs, 1000.0 / perItemNs, spread);
+}
+
+// Медиана времени на итерацию замера
+double MedianBenchmarkNs(const char* name)
+{
+    auto found = std::find_if(g_results.begin(), g_results.end(),
+                              [&](const BenchResult& result) { return result.name == name; });
+    if (found == g_results.end() || found->iterationNs.empty()) {
+        return 0.0;
+    }
+    return Median(found->iterationNs);
+}
+
+// Запись результатов в JSON
+bool WriteBenchmarkJson()
+{
+    const BenchSettings& settings = GetBenchSettings();
+    if (!settings.jsonPath) {
+        return true;
+    }
+
+    FILE* file = std::fopen(settings.jsonPath, "w");
+    if (!file) {
+        std::printf("Не удалось открыть %s для записи\n", settings.jsonPath);
+        return false;
+    }
+
+    const CpuFeatures& cpu = GetCpuFeatures();
+    std::fprintf(file, "{\n  \"context\": {\n");
+    std::fprintf(file, "    \"timestamp\": %lld,\n", static_cast<long long>(std::time(nullptr)));
+    std::fprintf(file, "    \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+    std::fprintf(file, "    \"cpu_features\": \"%s\",\n", cpu.avx512 ? "avx512" : cpu.avx2 ? "avx2" : cpu.sse2 ? "sse2" : "scalar");
+    std::fprintf(file, "    \"pinned_cpu\": %d,\n", settings.pinCpu);
+    std::fprintf(file, "    \"warmup\": %zu,\n", settings.warmup);
+    std::fprintf(file, "    \"repetitions\": %zu\n", settings.repetitions);
+    std::fprintf(file, "  },\n  \"benchmarks\": [");
+
+    for (size_t i = 0; i < g_results.size(); ++i) {
+        const BenchResult& result = g_results[i];
+        double items = static_cast<double>(result.itemsPerIteration ? result.itemsPerIteration : 1);
+        auto range = std::minmax_element(result.iterationNs.begin(), result.iterationNs.end());
+
+        std::fprintf(file, "%s\n    {\"name\": ", i ? "," : "");
+        WriteJsonString(file, result.name.c_str());
+        std::fprintf(file, ", \"iterations\": %zu, \"items_per_iteration\": %zu,"
+                           " \"median_ns_per_item\": %.6g, \"min_ns_per_item\": %.6g, \"max_ns_per_item\": %.6g,"
+                           " \"ns_per_item\": [",
+                     result.iterations, result.itemsPerIteration, Median(result.iterationNs) / items,
+                     *range.first / items, *range.second / items);
+        for (size_t k = 0; k < result.iterationNs.size(); ++k) {
+            std::fprintf(file, "%s%.6g", k ? ", " : "", result.iterationNs[k] / items);
+        }
+        std::fprintf(file, "]}");
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+
+    bool ok = std::ferror(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::printf("Ошибка записи %s\n", settings.jsonPath);
+    }
+    return ok;
+}
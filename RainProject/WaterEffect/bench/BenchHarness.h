@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+// Параметры запуска набора замеров (задаются из командной строки)
+struct BenchSettings {
+    size_t warmup = 1;              // Прогревочных вызовов тела перед замером
+    size_t repetitions = 5;         // Повторов замера (от 4 различие значимо для water_benchcompare)
+    int pinCpu = -1;                // Номер процессора для привязки потока; -1 - без привязки
+    const char* jsonPath = nullptr; // Файл результатов в JSON; nullptr - только текст
+    const char* filter = nullptr;   // Подстрока имени замера; nullptr - все замеры
+};
+
+BenchSettings& GetBenchSettings();
+
+// Разбор аргументов командной строки; false - неизвестный аргумент (справка уже напечатана)
+bool ParseBenchSettings(int argc, char** argv);
+
+// Привязка вызывающего потока к процессору из настроек. Остальные потоки процесса
+// не привязываются: рабочие потоки создаются через WithoutCpuPinning
+bool ApplyCpuPinning();
+
+// Снятие привязки вызывающего потока на время жизни объекта (без привязки - ничего не делает).
+// Под Linux новый поток наследует маску создавшего потока, поэтому потоки, запущенные
+// в это время, получают исходную маску процесса, а не один процессор
+class CpuPinningPause {
+public:
+    CpuPinningPause();
+    ~CpuPinningPause();
+
+    CpuPinningPause(const CpuPinningPause&) = delete;
+    CpuPinningPause& operator=(const CpuPinningPause&) = delete;
+};
+
+// Создание объекта, который запускает потоки (ThreadPool, Logger::Open), без привязки:
+// иначе все рабочие потоки делили бы один процессор и замер измерял бы переподписку
+template <typename Create>
+auto WithoutCpuPinning(Create&& create)
+{
+    CpuPinningPause pause;
+    return create();
+}
+
+// Проходит ли замер фильтр по имени
+bool IsBenchmarkSelected(const char* name);
+
+// Запись результатов всех замеров в JSON по пути из настроек
+bool WriteBenchmarkJson();
+
+// Учёт одного повтора замера: среднее время на итерацию и на обрабатываемый элемент.
+// Когда набрано GetBenchSettings().repetitions повторов, печатается строка с медианой
+// и пропускной способностью в миллионах элементов в секунду
+void ReportBenchmark(const char* name, double totalNs, size_t iterations, size_t itemsPerIteration);
+
+// Медиана времени на итерацию уже выполненного замера, наносекунды (0 - замера не было)
+double MedianBenchmarkNs(const char* name);
+
+// Минимальная обвязка для замеров: прогрев, затем repetitions повторов,
+// в каждом тело выполняется заданное число раз
+template <typename Body>
+void RunBenchmark(const char* name, size_t iterations, size_t itemsPerIteration, Body&& body)
+{
+    const BenchSettings& settings = GetBenchSettings();
+    if (!IsBenchmarkSelected(name)) {
+        return;
+    }
+
+    // Прогрев кэшей и предсказателя ветвлений
+    for (size_t i = 0; i < settings.warmup; ++i) {
+        body();
+    }
+
+    for (size_t repetition = 0; repetition < settings.repetitions; ++repetition) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            body();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        ReportBenchmark(name, std::chrono::duration<double, std::nano>(end - start).count(),
+                        iterations, itemsPerIteration);
+    }
+}
+
+// Не даёт компилятору выбросить вычисление, результат которого не используется
+template <typename T>
+void DoNotOptimize(T value)
+{
+    static volatile T sink;
+    sink = value;
+    (void)sink;
+}
+
+// Наборы замеров по подсистемам
+void RunWavePoolBenchmarks();
+void RunWaveKernelBenchmarks();
+void RunAnalyticWaveBenchmarks();
+void RunHeightFieldBenchmarks();
+void RunSimulationBenchmarks();
+void RunRasterizerBenchmarks();
+void RunLoggerBenchmarks();
+void RunTraceZoneBenchmarks();
+void RunFrameStatsBenchmarks();
@@ -0,0 +1,106 @@
+#include "BenchHarness.h"
+#include "HeightField.h"
+#include "HeightFieldKernels.h"
+#include "ThreadPool.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Размеры сетки, совпадающие с разрешениями экрана при ячейке в 1 пиксель
+struct GridSize {
+    const char* name;
+    int width;
+    int height;
+};
+
+const GridSize GRID_SIZES[] = {
+    { "1080p", 1920, 1080 },
+    { "1440p", 2560, 1440 },
+    { "4k", 3840, 2160 },
+};
+
+// Поле с волнами по всей площади: все плитки активны
+void Excite(HeightField& field)
+{
+    for (int y = 16; y < field.Height(); y += HeightField::TILE_SIZE) {
+        for (int x = 16; x < field.Width(); x += HeightField::TILE_SIZE) {
+            field.AddImpulse(static_cast<float>(x), static_cast<float>(y), 12.0f, 96.0f);
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        field.Step();
+    }
+}
+
+} // namespace
+
+// Замеры поля высот: клеток в секунду на сетках экранных разрешений
+void RunHeightFieldBenchmarks()
+{
+    std::printf("heightfield: выбрано ядро %s\n", GetHeightFieldKernel().name);
+
+    for (const GridSize& size : GRID_SIZES) {
+        HeightField field;
+        field.Resize(size.width, size.height);
+        Excite(field);
+
+        size_t cells = static_cast<size_t>(size.width) * static_cast<size_t>(size.height);
+        std::string name = std::string("heightfield.step/") + size.name;
+        RunBenchmark(name.c_str(), 20, cells, [&]() {
+            field.Step();
+        });
+
+        Framebuffer frame;
+        name = std::string("heightfield.shade/") + size.name;
+        RunBenchmark(name.c_str(), 20, cells, [&]() {
+            field.Shade(frame);
+        });
+
+        // Спокойная вода с одной свежей волной: работа пропорциональна активной площади
+        HeightField calm;
+        calm.Resize(size.width, size.height);
+        Framebuffer calmFrame;
+        calm.Shade(calmFrame);
+        name = std::string("heightfield.step_shade_single_wave/") + size.name;
+        RunBenchmark(name.c_str(), 20, cells, [&]() {
+            if (calm.ActiveTileCount() == 0) {
+                calm.AddImpulse(static_cast<float>(size.width / 2), static_cast<float>(size.height / 2), 12.0f, 96.0f);
+            }
+            calm.Step();
+            calm.Shade(calmFrame);
+        });
+        std::printf("%-40s %zu / %zu\n", "  active tiles", calm.ActiveTileCount(), calm.TileCount());
+    }
+
+    // Масштабирование параллельного шага на сетке 4K от одного потока до числа ядер
+    size_t maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads == 0) {
+        maxThreads = 1;
+    }
+
+    // Степени двойки и само число ядер
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    const GridSize& size = GRID_SIZES[2];
+    size_t cells = static_cast<size_t>(size.width) * static_cast<size_t>(size.height);
+    for (size_t threads : threadCounts) {
+        ThreadPool pool = WithoutCpuPinning([&]() { return ThreadPool(threads); });
+
+        HeightField field;
+        field.Resize(size.width, size.height);
+        Excite(field);
+
+        std::string name = std::string("heightfield.parallel_step/") + size.name + "/threads:" + std::to_string(threads);
+        RunBenchmark(name.c_str(), 20, cells, [&]() {
+            field.Step(&pool);
+        });
+    }
+}
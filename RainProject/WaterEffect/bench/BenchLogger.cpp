@@ -0,0 +1,126 @@
+#include "BenchHarness.h"
+#include "LogThrottle.h"
+#include "Logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+// Временный файл журнала для замеров
+const char* const BENCH_LOG_PATH = "./water_bench_log.txt";
+
+// Временный двоичный файл журнала
+const char* const BENCH_BINARY_LOG_PATH = "./water_bench_log.bin";
+
+} // namespace
+
+// Замеры журнала
+void RunLoggerBenchmarks()
+{
+    // Стоимость записи для вызывающего потока: форматирование в ячейку очереди.
+    // Пачка меньше ёмкости очереди, а между пачками (вне замера) фоновый поток её разбирает
+    if (IsBenchmarkSelected("logger.printf")) {
+        const size_t batch = 1024;
+        const size_t iterations = 100;
+        Logger logger;
+        WithoutCpuPinning([&]() { return logger.Open(BENCH_LOG_PATH); });
+
+        for (size_t repetition = 0; repetition < GetBenchSettings().repetitions; ++repetition) {
+            double totalNs = 0.0;
+            for (size_t iteration = 0; iteration < iterations; ++iteration) {
+                auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < batch; ++i) {
+                    logger.Printf("Update: волн = %zu", i);
+                }
+                auto end = std::chrono::steady_clock::now();
+                totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+                logger.Flush();
+            }
+            ReportBenchmark("logger.printf", totalNs, iterations, batch);
+        }
+        std::printf("  logger: записано %llu, потеряно %llu, вызовов fwrite %llu\n",
+                    static_cast<unsigned long long>(logger.Written()),
+                    static_cast<unsigned long long>(logger.Dropped()),
+                    static_cast<unsigned long long>(logger.Batches()));
+        logger.Close();
+    }
+
+    // Та же запись событием: идентификатор и сырые аргументы без форматирования
+    for (LogFormat format : { LogFormat::Text, LogFormat::Binary }) {
+        const char* name = format == LogFormat::Binary ? "logger.event_binary" : "logger.event_text";
+        if (!IsBenchmarkSelected(name)) {
+            continue;
+        }
+
+        const size_t batch = 1024;
+        const size_t iterations = 100;
+        Logger logger;
+        WithoutCpuPinning([&]() {
+            return logger.Open(format == LogFormat::Binary ? BENCH_BINARY_LOG_PATH : BENCH_LOG_PATH, false, format);
+        });
+
+        for (size_t repetition = 0; repetition < GetBenchSettings().repetitions; ++repetition) {
+            double totalNs = 0.0;
+            for (size_t iteration = 0; iteration < iterations; ++iteration) {
+                auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < batch; ++i) {
+                    logger.Event<LogMessageId::UpdateWaves>(i);
+                }
+                auto end = std::chrono::steady_clock::now();
+                totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+                logger.Flush();
+            }
+            ReportBenchmark(name, totalNs, iterations, batch);
+        }
+        logger.Close();
+    }
+
+    // Запись, отсечённая фильтром уровня во время работы: одна проверка атомарной переменной
+    {
+        const size_t batch = 1024;
+        WithoutCpuPinning([&]() { return GetLogger().Open(BENCH_LOG_PATH); });
+        GetLogger().SetLevel(LogLevel::Error);
+        RunBenchmark("logger.filtered_at_runtime", 100, batch, [&]() {
+            for (size_t i = 0; i < batch; ++i) {
+                WATER_LOG_WARNING("Update: волн = %zu", i);
+            }
+        });
+        GetLogger().SetLevel(LogLevel::Trace);
+        GetLogger().Close();
+    }
+
+    // Решение ограничителя для каждого сообщения окна
+    {
+        const size_t batch = 1024;
+        LogThrottle throttle(1);
+        throttle.SetLimit(0, LogThrottle::Limit{ 2.0, 20.0, 100 });
+        double now = 0.0;
+        size_t allowed = 0;
+        RunBenchmark("log_throttle.allow", 100, batch, [&]() {
+            for (size_t i = 0; i < batch; ++i) {
+                now += 0.001;
+                allowed += throttle.Allow(0, now) ? 1 : 0;
+            }
+        });
+        DoNotOptimize(allowed);
+    }
+
+    // Прежний способ: открытие, запись и закрытие std::ofstream на каждую строку
+    {
+        const size_t batch = 64;
+        RunBenchmark("legacy_ofstream.append", 20, batch, [&]() {
+            for (size_t i = 0; i < batch; ++i) {
+                std::ofstream logFile(BENCH_LOG_PATH, std::ios::app);
+                if (logFile.is_open()) {
+                    logFile << "Update: волн = " << i << std::endl;
+                    logFile.close();
+                }
+            }
+        });
+    }
+
+    std::remove(BENCH_LOG_PATH);
+    std::remove(BENCH_BINARY_LOG_PATH);
+}
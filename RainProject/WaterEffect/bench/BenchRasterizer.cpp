@@ -0,0 +1,172 @@
+#include "BenchHarness.h"
+#include "DirtyRegion.h"
+#include "DiscRasterizer.h"
+#include "SpanKernels.h"
+#include "ThreadPool.h"
+#include "TileRenderer.h"
+#include "WaterSimulation.h"
+#include "WaveDrawList.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int SCREEN_WIDTH = 1920;
+constexpr int SCREEN_HEIGHT = 1080;
+
+// Волны установившегося режима: радиусы равномерно от нуля до максимума,
+// прозрачность убывает с радиусом, как у настоящих волн
+void FillDrawList(WaveDrawList& list, size_t waves, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> x(0.0f, static_cast<float>(SCREEN_WIDTH));
+    std::uniform_real_distribution<float> y(0.0f, static_cast<float>(SCREEN_HEIGHT));
+    std::uniform_real_distribution<float> radius(0.0f, WaterSimulation::MAX_WAVE_RADIUS);
+
+    list.Clear();
+    for (size_t i = 0; i < waves; ++i) {
+        float r = radius(random);
+        list.AddWave(x(random), y(random), r, 1.0f - r / WaterSimulation::MAX_WAVE_RADIUS);
+    }
+}
+
+} // namespace
+
+// Замеры программной растеризации: кадр 1920x1080 с заданным числом волн
+// построчной заливкой с каждым ядром (по кругу и по волне за один проход)
+// и эталонной попиксельной. Элемент - пиксель экрана
+void RunRasterizerBenchmarks()
+{
+    const SpanKernel* kernels[8];
+    size_t kernelCount = GetAvailableSpanKernels(kernels, 8);
+    std::printf("span_kernel: выбрано ядро %s\n", GetSpanKernel().name);
+
+    // Заливка отрезка строки 4K поверх кадра
+    std::vector<uint32_t> span(3840, PackBgra(20, 30, 40, 50));
+    for (size_t k = 0; k < kernelCount; ++k) {
+        const SpanKernel& kernel = *kernels[k];
+        std::string name = std::string("span_kernel.") + kernel.name + "/3840";
+        RunBenchmark(name.c_str(), 2000, span.size(), [&]() {
+            kernel.blendSpan(span.data(), span.size(), PackBgra(0, 17, 23, 23));
+        });
+    }
+    for (size_t k = 0; k < kernelCount; ++k) {
+        const SpanKernel& kernel = *kernels[k];
+        std::string name = std::string("span_kernel2.") + kernel.name + "/3840";
+        RunBenchmark(name.c_str(), 2000, span.size(), [&]() {
+            kernel.blendSpan2(span.data(), span.size(), PackBgra(0, 17, 23, 23), PackBgra(40, 46, 50, 55));
+        });
+    }
+    DoNotOptimize(span[span.size() / 2]);
+
+    const size_t counts[] = { 10, 100, 1000 };
+    const size_t pixels = static_cast<size_t>(SCREEN_WIDTH) * SCREEN_HEIGHT;
+    for (size_t count : counts) {
+        WaveDrawList list;
+        FillDrawList(list, count, 7);
+        Framebuffer frame(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+        for (size_t k = 0; k < kernelCount; ++k) {
+            const SpanKernel& kernel = *kernels[k];
+            std::string name = std::string("raster.frame/") + kernel.name + "/" + std::to_string(count);
+            RunBenchmark(name.c_str(), count < 1000 ? 20 : 2, pixels, [&]() {
+                frame.Clear();
+                for (const DiscFill& disc : list) {
+                    FillDisc(frame, disc, kernel);
+                }
+            });
+
+            // Тот же кадр с заливкой обоих кругов волны за один проход
+            std::string fusedName = std::string("raster.fused/") + kernel.name + "/" + std::to_string(count);
+            RunBenchmark(fusedName.c_str(), count < 1000 ? 20 : 2, pixels, [&]() {
+                frame.Clear();
+                for (size_t wave = 0; wave < list.WaveCount(); ++wave) {
+                    FillWave(frame, list.Outer(wave), list.Inner(wave), kernel);
+                }
+            });
+            double separateNs = MedianBenchmarkNs(name.c_str());
+            double fusedNs = MedianBenchmarkNs(fusedName.c_str());
+            if (separateNs > 0.0 && fusedNs > 0.0) {
+                std::printf("%-40s x%.2f к двум заливкам\n", "  fused", separateNs / fusedNs);
+            }
+        }
+
+        std::string name = "raster.frame/reference/" + std::to_string(count);
+        RunBenchmark(name.c_str(), count < 100 ? 20 : 1, pixels, [&]() {
+            frame.Clear();
+            for (const DiscFill& disc : list) {
+                FillDiscReference(frame, disc);
+            }
+        });
+        DoNotOptimize(frame.Row(SCREEN_HEIGHT / 2)[SCREEN_WIDTH / 2]);
+    }
+
+    // Кадр 4K с 1000 волн по плиткам 64x64: масштабирование от одного потока до числа ядер.
+    // Элемент - плитка
+    size_t maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads == 0) {
+        maxThreads = 1;
+    }
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    const int width = 3840;
+    const int height = 2160;
+    WaveDrawList list;
+    std::mt19937 random(9);
+    std::uniform_real_distribution<float> x(0.0f, static_cast<float>(width));
+    std::uniform_real_distribution<float> y(0.0f, static_cast<float>(height));
+    std::uniform_real_distribution<float> radius(0.0f, WaterSimulation::MAX_WAVE_RADIUS);
+    for (int i = 0; i < 1000; ++i) {
+        float r = radius(random);
+        list.AddWave(x(random), y(random), r, 1.0f - r / WaterSimulation::MAX_WAVE_RADIUS);
+    }
+
+    Framebuffer frame(width, height);
+    TileRenderer renderer;
+    renderer.Resize(width, height);
+    double singleThreadNs = 0.0;
+    for (size_t threads : threadCounts) {
+        ThreadPool pool = WithoutCpuPinning([&]() { return ThreadPool(threads); });
+        pool.Reserve(renderer.TileCount(), TileRenderer::TILES_PER_TASK);
+
+        std::string name = "raster.tiled/4k/1000/threads:" + std::to_string(threads);
+        RunBenchmark(name.c_str(), 2, renderer.TileCount(), [&]() {
+            renderer.Render(frame, list, &pool);
+        });
+
+        double ns = MedianBenchmarkNs(name.c_str());
+        if (threads == 1) {
+            singleThreadNs = ns;
+        }
+        if (ns > 0.0 && singleThreadNs > 0.0) {
+            std::printf("%-40s %.0f плиток/с, ускорение x%.2f на %zu потоках\n", "  tiles",
+                        static_cast<double>(renderer.TileCount()) * 1e9 / ns, singleThreadNs / ns, threads);
+        }
+    }
+    std::printf("%-40s %zu попаданий в %zu плиток\n", "  binned", renderer.BinnedCount(), renderer.TileCount());
+
+    // Одна небольшая волна на экране 4K: кадр целиком против перерисовки области DirtyRegion
+    WaveDrawList single;
+    single.AddWave(width * 0.5f, height * 0.5f, 60.0f, 0.8f);
+    DirtyRegion region;
+    PixelRect area = region.Advance(DrawListBounds(single, width, height));
+    size_t screenPixels = static_cast<size_t>(width) * height;
+    RunBenchmark("raster.tiled/4k/1/full", 20, screenPixels, [&]() {
+        renderer.Render(frame, single, nullptr);
+    });
+    RunBenchmark("raster.tiled/4k/1/dirty", 2000, screenPixels, [&]() {
+        renderer.Render(frame, single, nullptr, area);
+    });
+    std::printf("%-40s %llu из %zu пикселей (%.2f%%)\n", "  touched",
+                static_cast<unsigned long long>(area.Area()), screenPixels,
+                100.0 * static_cast<double>(area.Area()) / static_cast<double>(screenPixels));
+    DoNotOptimize(frame.Row(height / 2)[width / 2]);
+}
@@ -0,0 +1,126 @@
+#include "BenchHarness.h"
+#include "FrameRunner.h"
+#include "WaterSimulation.h"
+
+#include <random>
+#include <string>
+
+namespace {
+
+constexpr int SCREEN_WIDTH = 1920;
+constexpr int SCREEN_HEIGHT = 1080;
+
+// Разрешения экрана для кадра поля высот
+struct ScreenSize {
+    int width;
+    int height;
+};
+
+const ScreenSize SCREEN_SIZES[] = {
+    { 1280, 720 },
+    { 1920, 1080 },
+    { 3840, 2160 },
+};
+
+} // namespace
+
+// Замеры симуляции целиком: создание волн и кадр через WaterSimulation
+void RunSimulationBenchmarks()
+{
+    // Пропускная способность CreateWave: точки клика разбросаны по экрану.
+    // Пул волн растёт по мере надобности, как при серии кликов в приложении
+    for (WaveMode mode : { WaveMode::Integrated, WaveMode::Analytic, WaveMode::HeightField }) {
+        const size_t batch = 1000;
+        ManualTimeSource time;
+        WaterSimulation simulation;
+        simulation.SetWaveMode(mode);
+        simulation.SetTimeSource(&time);
+        simulation.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, 1);
+
+        std::mt19937 random(11);
+        std::uniform_real_distribution<float> x(0.0f, static_cast<float>(SCREEN_WIDTH));
+        std::uniform_real_distribution<float> y(0.0f, static_cast<float>(SCREEN_HEIGHT));
+
+        std::string name = std::string("create_wave/") + WaveModeName(mode);
+        RunBenchmark(name.c_str(), 20, batch, [&]() {
+            for (size_t i = 0; i < batch; ++i) {
+                simulation.CreateWave(x(random), y(random));
+            }
+        });
+    }
+
+    // Кадр с заданным числом живых волн: Update и пересоздание погасших.
+    // Рождения распределены по времени жизни, поэтому в каждом кадре гаснет постоянная доля волн
+    const size_t counts[] = { 10, 1000, 100000, 1000000 };
+    for (WaveMode mode : { WaveMode::Integrated, WaveMode::Analytic }) {
+        for (size_t count : counts) {
+            ManualTimeSource time;
+            WaterSimulation simulation;
+            simulation.SetWaveMode(mode);
+            simulation.SetTimeSource(&time);
+            simulation.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, 1);
+
+            size_t spawned = 0;
+            auto frame = [&]() {
+                time.Advance(WaterSimulation::SIMULATION_TICK);
+                simulation.Update();
+                for (size_t live = simulation.WaveCount(); live < count; ++live) {
+                    simulation.CreateWave(static_cast<float>(spawned % SCREEN_WIDTH),
+                                          static_cast<float>(spawned % SCREEN_HEIGHT));
+                    ++spawned;
+                }
+            };
+
+            // Выход на установившийся режим: волны появляются постепенно в течение времени жизни
+            double lifetime = WaterSimulation::MAX_WAVE_RADIUS / WaterSimulation::CREATED_WAVE_SPEED;
+            size_t rampFrames = static_cast<size_t>(lifetime / WaterSimulation::SIMULATION_TICK) + 1;
+            for (size_t i = 1; i <= rampFrames; ++i) {
+                time.Advance(WaterSimulation::SIMULATION_TICK);
+                simulation.Update();
+                for (size_t target = count * i / rampFrames; spawned < target; ++spawned) {
+                    simulation.CreateWave(static_cast<float>(spawned % SCREEN_WIDTH),
+                                          static_cast<float>(spawned % SCREEN_HEIGHT));
+                }
+            }
+            for (size_t i = 0; i < rampFrames; ++i) {
+                frame();
+            }
+
+            std::string name = std::string("simulation.frame/") + WaveModeName(mode) + "/" + std::to_string(count);
+            RunBenchmark(name.c_str(), count < 1000 ? 20000 : 100, count, frame);
+        }
+    }
+
+    // Кадр поля высот по разрешениям экрана: шаг сетки и растеризация в кадр.
+    // Возмущения заранее покрывают весь экран, поэтому все плитки активны и стоимость
+    // кадра не зависит от того, как далеко успели разойтись волны. Элемент - пиксель экрана
+    for (const ScreenSize& size : SCREEN_SIZES) {
+        ManualTimeSource time;
+        WaterSimulation simulation;
+        simulation.SetWaveMode(WaveMode::HeightField);
+        simulation.SetTimeSource(&time);
+        simulation.Initialize(size.width, size.height);
+
+        for (int y = 0; y < size.height; y += 96) {
+            for (int x = 0; x < size.width; x += 96) {
+                simulation.CreateWave(static_cast<float>(x), static_cast<float>(y));
+            }
+        }
+
+        size_t frameIndex = 0;
+        auto frame = [&]() {
+            ++frameIndex;
+            simulation.CreateWave(static_cast<float>((frameIndex * 97) % size.width),
+                                  static_cast<float>((frameIndex * 53) % size.height));
+            time.Advance(WaterSimulation::SIMULATION_TICK);
+            simulation.Update();
+        };
+        for (int i = 0; i < 60; ++i) {
+            frame();
+        }
+
+        std::string name = "simulation.frame/heightfield/" + std::to_string(size.width) + "x" +
+                           std::to_string(size.height);
+        RunBenchmark(name.c_str(), 20, static_cast<size_t>(size.width) * size.height, frame);
+    }
+}
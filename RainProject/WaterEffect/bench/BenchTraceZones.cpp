@@ -0,0 +1,28 @@
+#include "BenchHarness.h"
+#include "TraceZones.h"
+
+
+// Замеры зон времени
+void RunTraceZoneBenchmarks()
+{
+    const size_t batch = 1024;
+    ZoneRecorder& recorder = GetZoneRecorder();
+
+    // Выключенная запись: одна проверка атомарной переменной на зону
+    recorder.SetEnabled(false);
+    RunBenchmark("trace_zone.disabled", 1000, batch, [&]() {
+        for (size_t i = 0; i < batch; ++i) {
+            WATER_TRACE_ZONE("bench.zone");
+        }
+    });
+
+    // Включённая запись: два чтения часов и запись в буфер потока
+    recorder.SetEnabled(true);
+    RunBenchmark("trace_zone.enabled", 100, batch, [&]() {
+        for (size_t i = 0; i < batch; ++i) {
+            WATER_TRACE_ZONE("bench.zone");
+        }
+    });
+    recorder.SetEnabled(false);
+    recorder.Clear();
+}
@@ -0,0 +1,63 @@
+#include "BenchHarness.h"
+#include "WaveKernels.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr float MAX_WAVE_RADIUS = 300.0f;
+constexpr float WAVE_SPEED = 150.0f * 1.5f;
+
+// Состояние волн для одного прогона ядра
+struct KernelState {
+    std::vector<float> radius;
+    std::vector<float> opacity;
+    std::vector<float> maxRadius;
+    std::vector<float> speed;
+    std::vector<uint64_t> retireMask;
+
+    explicit KernelState(size_t count) :
+        radius(count), opacity(count), maxRadius(count), speed(count), retireMask(RetireMaskWords(count))
+    {
+        std::mt19937 rng(12345);
+        std::uniform_real_distribution<float> age(0.0f, 1.0f);
+        for (size_t i = 0; i < count; ++i) {
+            maxRadius[i] = MAX_WAVE_RADIUS;
+            speed[i] = WAVE_SPEED * (0.5f + age(rng));
+            radius[i] = MAX_WAVE_RADIUS * age(rng);
+            opacity[i] = 1.0f - radius[i] / maxRadius[i];
+        }
+    }
+
+    size_t Step(const WaveKernel& kernel, float deltaTime)
+    {
+        return kernel.integrate(radius.data(), opacity.data(), maxRadius.data(), speed.data(),
+                                radius.size(), deltaTime, retireMask.data());
+    }
+};
+
+} // namespace
+
+// Замеры ядер интегрирования волн
+void RunWaveKernelBenchmarks()
+{
+    const WaveKernel* kernels[8];
+    size_t kernelCount = GetAvailableWaveKernels(kernels, 8);
+    std::printf("wave_kernel: выбрано ядро %s\n", GetWaveKernel().name);
+
+    const size_t counts[] = { 1000, 100000, 1000000 };
+    for (size_t k = 0; k < kernelCount; ++k) {
+        const WaveKernel& kernel = *kernels[k];
+        for (size_t count : counts) {
+            KernelState state(count);
+            std::string name = std::string("wave_kernel.") + kernel.name + "/" + std::to_string(count);
+            // Шаг по времени нулевой, чтобы состояние не менялось между итерациями
+            RunBenchmark(name.c_str(), 200, count, [&]() {
+                state.Step(kernel, 0.0f);
+            });
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#include "BenchHarness.h"
+#include "WavePool.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+// Параметры волны, совпадающие с WaterEffect::CreateWave
+constexpr float MAX_WAVE_RADIUS = 300.0f;
+constexpr float WAVE_SPEED = 150.0f * 1.5f;
+constexpr float FRAME_TIME = 0.016f;
+
+// Число кадров до начала замера: больше времени жизни самой медленной волны
+constexpr int STEADY_STATE_FRAMES = 200;
+
+// Прежнее AoS-представление волны для сравнения
+struct LegacyWave {
+    float x;
+    float y;
+    float radius;
+    float maxRadius;
+    float opacity;
+    float speed;
+};
+
+// Скорость k-й волны: разброс скоростей делает так, что в каждом кадре
+// гаснет и пересоздаётся небольшая доля волн, как при серии кликов
+float SpeedFor(size_t k)
+{
+    return WAVE_SPEED * (0.5f + static_cast<float>(k % 97) / 97.0f);
+}
+
+// Прежний алгоритм обновления: erase посреди вектора для каждой погасшей волны
+void UpdateLegacy(std::vector<LegacyWave>& waves, float deltaTime)
+{
+    for (auto it = waves.begin(); it != waves.end();) {
+        it->radius += it->speed * deltaTime;
+        it->opacity = 1.0f - (it->radius / it->maxRadius);
+        if (it->opacity <= 0.0f || it->radius >= it->maxRadius) {
+            it = waves.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace
+
+// Замеры пула волн
+void RunWavePoolBenchmarks()
+{
+    const size_t counts[] = { 10, 1000, 100000, 1000000 };
+
+    for (size_t count : counts) {
+        WavePool pool(count);
+        size_t spawned = 0;
+        for (; spawned < count; ++spawned) {
+            pool.Add(static_cast<float>(spawned % 1920), static_cast<float>(spawned % 1080), MAX_WAVE_RADIUS, SpeedFor(spawned));
+        }
+
+        // Кадр = обновление + пересоздание погасших волн до исходного числа
+        auto frame = [&]() {
+            pool.Update(FRAME_TIME);
+            while (pool.Size() < count) {
+                pool.Add(0.0f, 0.0f, MAX_WAVE_RADIUS, SpeedFor(spawned++));
+            }
+        };
+
+        // Выходим на установившийся режим, где волны гаснут каждый кадр
+        for (int i = 0; i < STEADY_STATE_FRAMES; ++i) {
+            frame();
+        }
+
+        // Малый пул обновляется за десятки наносекунд: больше итераций на один замер
+        std::string name = "wave_pool.update/" + std::to_string(count);
+        RunBenchmark(name.c_str(), count < 1000 ? 20000 : 200, count, frame);
+    }
+
+    // Прежний вектор с erase: квадратичная стоимость, поэтому только малые размеры
+    const size_t legacyCounts[] = { 1000, 10000 };
+    for (size_t count : legacyCounts) {
+        std::vector<LegacyWave> waves;
+        size_t spawned = 0;
+        for (; spawned < count; ++spawned) {
+            waves.push_back({ 0.0f, 0.0f, 0.0f, MAX_WAVE_RADIUS, 1.0f, SpeedFor(spawned) });
+        }
+
+        auto frame = [&]() {
+            UpdateLegacy(waves, FRAME_TIME);
+            while (waves.size() < count) {
+                waves.push_back({ 0.0f, 0.0f, 0.0f, MAX_WAVE_RADIUS, 1.0f, SpeedFor(spawned++) });
+            }
+        };
+
+        for (int i = 0; i < STEADY_STATE_FRAMES; ++i) {
+            frame();
+        }
+
+        std::string name = "legacy_vector_erase.update/" + std::to_string(count);
+        RunBenchmark(name.c_str(), 50, count, frame);
+    }
+}
@@ -0,0 +1,21 @@
+#include "BenchHarness.h"
+
+// Точка входа набора замеров
+int main(int argc, char** argv)
+{
+    if (!ParseBenchSettings(argc, argv) || !ApplyCpuPinning()) {
+        return 2;
+    }
+
+    RunWavePoolBenchmarks();
+    RunWaveKernelBenchmarks();
+    RunAnalyticWaveBenchmarks();
+    RunHeightFieldBenchmarks();
+    RunSimulationBenchmarks();
+    RunRasterizerBenchmarks();
+    RunLoggerBenchmarks();
+    RunTraceZoneBenchmarks();
+    RunFrameStatsBenchmarks();
+
+    return WriteBenchmarkJson() ? 0 : 1;
+}
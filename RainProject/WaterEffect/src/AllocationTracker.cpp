@@ -0,0 +1,146 @@
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#if WATER_TRACK_ALLOCATIONS
+
+namespace {
+
+std::atomic<uint64_t> g_allocations(0);
+std::atomic<uint64_t> g_deallocations(0);
+std::atomic<uint64_t> g_bytes(0);
+
+// Выделение с подсчётом; nullptr при нехватке памяти
+void* TrackedAllocate(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+// Выделение с выравниванием больше стандартного
+void* TrackedAllocateAligned(std::size_t size, std::size_t alignment)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, alignment);
+#else
+    // aligned_alloc требует размер, кратный выравниванию
+    std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+    return std::aligned_alloc(alignment, rounded ? rounded : alignment);
+#endif
+}
+
+// Освобождение с подсчётом
+void TrackedFree(void* pointer)
+{
+    if (pointer) {
+        g_deallocations.fetch_add(1, std::memory_order_relaxed);
+        std::free(pointer);
+    }
+}
+
+void TrackedFreeAligned(void* pointer)
+{
+    if (pointer) {
+        g_deallocations.fetch_add(1, std::memory_order_relaxed);
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+// Выделение для бросающих форм operator new
+void* AllocateOrThrow(std::size_t size)
+{
+    void* pointer = TrackedAllocate(size);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* AllocateAlignedOrThrow(std::size_t size, std::size_t alignment)
+{
+    void* pointer = TrackedAllocateAligned(size, alignment);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+} // namespace
+
+// Замена глобальных operator new/delete (все формы, чтобы выделение и освобождение
+// всегда проходили через одну пару malloc/free)
+void* operator new(std::size_t size) { return AllocateOrThrow(size); }
+void* operator new[](std::size_t size) { return AllocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+void operator delete(void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return AllocateAlignedOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return AllocateAlignedOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocateAligned(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocateAligned(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* pointer, std::align_val_t) noexcept { TrackedFreeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { TrackedFreeAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { TrackedFreeAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { TrackedFreeAligned(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFreeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFreeAligned(pointer); }
+
+// Текущие значения счётчиков
+AllocationCounters GetAllocationCounters()
+{
+    return AllocationCounters{ g_allocations.load(std::memory_order_relaxed),
+                               g_deallocations.load(std::memory_order_relaxed),
+                               g_bytes.load(std::memory_order_relaxed) };
+}
+
+// Число выделений с момента запуска
+uint64_t AllocationCount()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+// Подсчёт выключен
+AllocationCounters GetAllocationCounters()
+{
+    return AllocationCounters{ 0, 0, 0 };
+}
+
+uint64_t AllocationCount()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Подсчёт выделений памяти.
+// При сборке с WATER_TRACK_ALLOCATIONS глобальные operator new/delete заменяются
+// версиями, которые считают вызовы (одно атомарное сложение на вызов) и передают
+// память malloc/free. AllocationTracker.cpp не входит в WaterCore: его собирают в программу
+// вместе с WATER_TRACK_ALLOCATIONS (инструменты - всегда, приложение - по ключу CMake).
+// Выделения за кадр - разность AllocationCount() в начале и в конце кадра
+#ifndef WATER_TRACK_ALLOCATIONS
+#define WATER_TRACK_ALLOCATIONS 0
+#endif
+
+static constexpr bool ALLOCATION_TRACKING = WATER_TRACK_ALLOCATIONS != 0;
+
+// Счётчики с момента запуска программы
+struct AllocationCounters {
+    uint64_t allocations;       // Вызовов operator new
+    uint64_t deallocations;     // Вызовов operator delete с ненулевым указателем
+    uint64_t bytes;             // Запрошено байт всего
+};
+
+// Текущие значения счётчиков (нули, если подсчёт выключен)
+AllocationCounters GetAllocationCounters();
+
+// Число выделений с момента запуска (0, если подсчёт выключен)
+uint64_t AllocationCount();
@@ -0,0 +1,22 @@
+#include "AnalyticWaves.h"
+
+// Конструктор
+AnalyticWaveList::AnalyticWaveList(float speed, float maxRadius) :
+    m_speed(speed),
+    m_maxRadius(maxRadius),
+    m_lifetime(static_cast<double>(maxRadius) / static_cast<double>(speed))
+{
+}
+
+// Добавление волны
+void AnalyticWaveList::Add(float x, float y, double now)
+{
+    m_waves.PushBack(x, y, now);
+}
+
+// Удаление погасших волн
+size_t AnalyticWaveList::DropExpired(double now)
+{
+    // Волна погасла, когда её возраст достиг времени жизни
+    return m_waves.DropBornUntil(now - m_lifetime);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+
+#include "WaveRing.h"
+
+// Волна, заданная только центром и моментом рождения.
+// Радиус и прозрачность вычисляются по возрасту в момент отрисовки
+struct AnalyticWave {
+    float x;            // Координата X центра волны
+    float y;            // Координата Y центра волны
+    double birthTime;   // Момент создания волны (секунды)
+};
+
+// Список волн с общими скоростью и максимальным радиусом.
+// Раз все волны живут одинаково долго, они гаснут в порядке создания,
+// поэтому покадровый проход записи не нужен: погасшие волны снимаются
+// с начала кольцевого буфера двоичным поиском по меткам времени
+class AnalyticWaveList {
+public:
+    AnalyticWaveList(float speed, float maxRadius);
+
+    // Добавление волны, созданной в момент now
+    void Add(float x, float y, double now);
+
+    // Удаление волн, погасших к моменту now. Возвращает число удалённых волн
+    size_t DropExpired(double now);
+
+    void Clear() { m_waves.Clear(); }
+
+    size_t Size() const { return m_waves.Size(); }
+    bool Empty() const { return m_waves.Empty(); }
+    AnalyticWave operator[](size_t index) const {
+        return { m_waves.X(index), m_waves.Y(index), m_waves.BirthTime(index) };
+    }
+
+    // Обход всех волн от самой старой: visit(x, y, birthTime)
+    template <typename Visitor>
+    void ForEach(Visitor&& visit) const { m_waves.ForEach(visit); }
+
+    float Speed() const { return m_speed; }
+    float MaxRadius() const { return m_maxRadius; }
+
+    // Время жизни волны (секунды)
+    double Lifetime() const { return m_lifetime; }
+
+    // Радиус волны в момент now
+    float RadiusAt(const AnalyticWave& wave, double now) const {
+        return m_speed * static_cast<float>(now - wave.birthTime);
+    }
+
+    // Прозрачность волны в момент now (<= 0 для погасшей волны)
+    float OpacityAt(const AnalyticWave& wave, double now) const {
+        return 1.0f - RadiusAt(wave, now) / m_maxRadius;
+    }
+
+private:
+    WaveRing m_waves;                   // Волны в порядке создания
+    float m_speed;                      // Общая скорость расширения
+    float m_maxRadius;                  // Общий максимальный радиус
+    double m_lifetime;                  // maxRadius / speed
+};
@@ -0,0 +1,89 @@
+#include "CpuFeatures.h"
+
+#if WATER_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+
+#if WATER_X86
+
+// Выполнение CPUID для указанного листа и подлиста
+void Cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<unsigned int>(info[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Чтение XCR0: какие группы регистров ОС сохраняет при переключении потоков
+unsigned long long ReadXcr0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax = 0;
+    unsigned int edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+// Опрос процессора
+CpuFeatures DetectCpuFeatures()
+{
+    CpuFeatures features = {};
+
+    unsigned int regs[4] = {};
+    Cpuid(0, 0, regs);
+    unsigned int maxLeaf = regs[0];
+    if (maxLeaf < 1) {
+        return features;
+    }
+
+    Cpuid(1, 0, regs);
+    features.sse2 = (regs[3] & (1u << 26)) != 0;
+
+    bool osxsave = (regs[2] & (1u << 27)) != 0;
+    bool avx = (regs[2] & (1u << 28)) != 0;
+    if (!osxsave || !avx || maxLeaf < 7) {
+        return features;
+    }
+
+    unsigned long long xcr0 = ReadXcr0();
+    bool ymmEnabled = (xcr0 & 0x6) == 0x6;      // XMM + YMM
+    bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;    // XMM + YMM + opmask + ZMM
+
+    Cpuid(7, 0, regs);
+    features.avx2 = ymmEnabled && (regs[1] & (1u << 5)) != 0;
+    features.avx512 = zmmEnabled && (regs[1] & (1u << 16)) != 0;
+    return features;
+}
+
+#else
+
+CpuFeatures DetectCpuFeatures()
+{
+    return CpuFeatures{};
+}
+
+#endif
+
+} // namespace
+
+// Возможности текущего процессора
+const CpuFeatures& GetCpuFeatures()
+{
+    static const CpuFeatures features = DetectCpuFeatures();
+    return features;
+}
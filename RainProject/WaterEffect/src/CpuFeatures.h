@@ -0,0 +1,26 @@
+#pragma once
+
+// Определение набора команд процессора во время выполнения (CPUID + XGETBV)
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define WATER_X86 1
+#else
+#define WATER_X86 0
+#endif
+
+// Атрибут функции, разрешающий компилятору использовать указанный набор команд.
+// MSVC позволяет использовать интринсики в любой функции, поэтому там атрибут пуст
+#if defined(_MSC_VER)
+#define WATER_TARGET(isa)
+#else
+#define WATER_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+struct CpuFeatures {
+    bool sse2;      // SSE2
+    bool avx2;      // AVX2 (с поддержкой сохранения YMM-регистров ОС)
+    bool avx512;    // AVX-512F (с поддержкой сохранения ZMM-регистров ОС)
+};
+
+// Возможности текущего процессора (определяются один раз при первом вызове)
+const CpuFeatures& GetCpuFeatures();
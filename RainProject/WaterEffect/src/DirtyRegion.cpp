@@ -0,0 +1,30 @@
+#include "DirtyRegion.h"
+
+#include <algorithm>
+
+// Объединение прямоугольников
+PixelRect UnionRect(const PixelRect& a, const PixelRect& b)
+{
+    if (a.Empty()) {
+        return b.Empty() ? EmptyRect() : b;
+    }
+    if (b.Empty()) {
+        return a;
+    }
+    return PixelRect{ std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1), std::max(a.y1, b.y1) };
+}
+
+// Пересечение прямоугольников
+PixelRect IntersectRect(const PixelRect& a, const PixelRect& b)
+{
+    PixelRect result = { std::max(a.x0, b.x0), std::max(a.y0, b.y0), std::min(a.x1, b.x1), std::min(a.y1, b.y1) };
+    return result.Empty() ? EmptyRect() : result;
+}
+
+// Переход к новому кадру
+PixelRect DirtyRegion::Advance(const PixelRect& bounds)
+{
+    PixelRect area = UnionRect(m_previous, bounds);
+    m_previous = bounds.Empty() ? EmptyRect() : bounds;
+    return area;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+// Прямоугольник пикселей [x0, x1) x [y0, y1)
+struct PixelRect {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+
+    bool Empty() const { return x0 >= x1 || y0 >= y1; }
+
+    // Число пикселей (0 для пустого)
+    uint64_t Area() const {
+        return Empty() ? 0 : static_cast<uint64_t>(x1 - x0) * static_cast<uint64_t>(y1 - y0);
+    }
+};
+
+// Пустой прямоугольник
+inline PixelRect EmptyRect()
+{
+    return PixelRect{ 0, 0, 0, 0 };
+}
+
+// Наименьший прямоугольник, содержащий оба (пустые не учитываются)
+PixelRect UnionRect(const PixelRect& a, const PixelRect& b);
+
+// Пересечение прямоугольников (пустой, если они не пересекаются)
+PixelRect IntersectRect(const PixelRect& a, const PixelRect& b);
+
+// Область кадра, которую нужно перерисовать.
+// Кадр прозрачен везде, кроме границ нарисованного в нём, поэтому при переходе
+// к следующему кадру меняются только пиксели внутри объединения границ прошлого
+// и нового кадра: там старое стирается и рисуется новое, а остальной экран не трогается.
+// Если волн нет ни в прошлом, ни в новом кадре, область пуста и кадр можно не строить
+class DirtyRegion {
+public:
+    DirtyRegion() : m_previous(EmptyRect()) {}
+
+    // Переход к новому кадру с границами bounds; возвращает область перерисовки
+    PixelRect Advance(const PixelRect& bounds);
+
+    // Содержимое area больше не соответствует прошлому кадру (например, цель рендеринга
+    // создана заново) - следующий кадр перерисует её целиком
+    void Invalidate(const PixelRect& area) { m_previous = UnionRect(m_previous, area); }
+
+    // Границы нарисованного в последнем кадре
+    const PixelRect& Previous() const { return m_previous; }
+
+private:
+    PixelRect m_previous;
+};
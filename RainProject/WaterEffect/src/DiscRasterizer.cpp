@@ -0,0 +1,362 @@
+#include "DiscRasterizer.h"
+
+#include <algorithm>
+
+namespace {
+
+// Компонента 0..1 в 8 бит с округлением и насыщением
+uint32_t ToByte(float value)
+{
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<uint32_t>(value * 255.0f + 0.5f);
+}
+
+// Первая строка или столбец, которых может коснуться круг (с отсечением по [low, high])
+int ClampedFloor(float value, int low, int high)
+{
+    value = std::min(std::max(value, static_cast<float>(low)), static_cast<float>(high));
+    return static_cast<int>(std::floor(value));
+}
+
+// Строка или столбец за последним, которого может коснуться круг
+int ClampedCeil(float value, int low, int high)
+{
+    value = std::min(std::max(value, static_cast<float>(low)), static_cast<float>(high));
+    return static_cast<int>(std::ceil(value));
+}
+
+// Столбец из приближённой границы отрезка с отсечением по [low, high]
+int ClampedColumn(float value, int low, int high)
+{
+    value = std::min(std::max(value, static_cast<float>(low)), static_cast<float>(high));
+    return static_cast<int>(value);
+}
+
+// Покрытие пикселя столбца x в строке с квадратом смещения dySquared от центра круга.
+// Одна функция для построчной и эталонной заливки, чтобы расстояние считалось одинаково
+inline uint32_t PixelCoverage(int x, float dySquared, const DiscFill& disc)
+{
+    float dx = static_cast<float>(x) + 0.5f - disc.x;
+    return DiscCoverage(dx * dx + dySquared, disc.radius);
+}
+
+// Отрезки круга в одной строке: [left, right) - покрытые пиксели,
+// [fullLeft, fullRight) внутри него - покрытые полностью (может быть пустым)
+struct RowSpans {
+    int left;
+    int right;
+    int fullLeft;
+    int fullRight;
+};
+
+// Отрезки круга в строке с квадратом смещения dySquared среди столбцов [x0, x1).
+// center - ближайший к центру круга столбец: покрытие в строке наибольшее именно в нём
+// и не растёт при удалении от него, поэтому покрытые и полностью покрытые пиксели
+// образуют отрезки вокруг него. false - круг строки не касается
+bool DiscRowSpans(const DiscFill& disc, float dySquared, int x0, int x1, int center, RowSpans& spans)
+{
+    auto coverage = [&](int x) {
+        return PixelCoverage(x, dySquared, disc);
+    };
+    if (coverage(center) == 0) {
+        return false;
+    }
+
+    // Строка прямоугольника целиком внутри круга
+    if (coverage(x0) == 255 && coverage(x1 - 1) == 255) {
+        spans = RowSpans{ x0, x1, x0, x1 };
+        return true;
+    }
+
+    // Границы отрезков по формуле окружности - только первое приближение: окончательно
+    // их задаёт то же покрытие, что у эталона, поэтому округление не меняет кадр
+    float reach = disc.radius + 0.5f;
+    float outerHalf = std::sqrt(std::max(reach * reach - dySquared, 0.0f));
+    int left = ClampedColumn(std::ceil(disc.x - outerHalf - 0.5f), x0, center);
+    int right = ClampedColumn(std::floor(disc.x + outerHalf - 0.5f) + 1.0f, center + 1, x1);
+    while (left > x0 && coverage(left - 1) != 0) {
+        --left;
+    }
+    while (coverage(left) == 0) {
+        ++left;
+    }
+    while (right < x1 && coverage(right) != 0) {
+        ++right;
+    }
+    while (coverage(right - 1) == 0) {
+        --right;
+    }
+
+    // Отрезок полного покрытия (может быть пустым у верха и низа круга)
+    int fullLeft = center;
+    int fullRight = center;
+    if (coverage(center) == 255) {
+        float inner = disc.radius - 0.5f;
+        float innerHalf = std::sqrt(std::max(inner * inner - dySquared, 0.0f));
+        fullLeft = ClampedColumn(std::ceil(disc.x - innerHalf - 0.5f), left, center);
+        fullRight = ClampedColumn(std::floor(disc.x + innerHalf - 0.5f) + 1.0f, center + 1, right);
+        while (fullLeft > left && coverage(fullLeft - 1) == 255) {
+            --fullLeft;
+        }
+        while (coverage(fullLeft) != 255) {
+            ++fullLeft;
+        }
+        while (fullRight < right && coverage(fullRight) == 255) {
+            ++fullRight;
+        }
+        while (coverage(fullRight - 1) != 255) {
+            --fullRight;
+        }
+    }
+
+    spans = RowSpans{ left, right, fullLeft, fullRight };
+    return true;
+}
+
+// Наложение одного круга на столбцы [begin, end) строки с отрезками spans:
+// полностью покрытая часть - ядром, края - с покрытием каждого пикселя
+void BlendRowRange(uint32_t* row, int begin, int end, const RowSpans& spans, const DiscFill& disc,
+                   float dySquared, const PremultipliedColor& color, uint32_t packed, const SpanKernel& kernel)
+{
+    int fullBegin = std::max(begin, spans.fullLeft);
+    int fullEnd = std::min(end, spans.fullRight);
+    if (fullEnd <= fullBegin) {
+        fullBegin = fullEnd = end;
+    }
+    for (int x = begin; x < fullBegin; ++x) {
+        row[x] = BlendOver(row[x], color, PixelCoverage(x, dySquared, disc));
+    }
+    if (fullEnd > fullBegin) {
+        kernel.blendSpan(row + fullBegin, static_cast<size_t>(fullEnd - fullBegin), packed);
+    }
+    for (int x = fullEnd; x < end; ++x) {
+        row[x] = BlendOver(row[x], color, PixelCoverage(x, dySquared, disc));
+    }
+}
+
+} // namespace
+
+// Предумноженный цвет кисти
+PremultipliedColor PremultiplyDisc(const DiscFill& disc)
+{
+    uint32_t alpha = ToByte(disc.a);
+    return PremultipliedColor{ Div255(ToByte(disc.r) * alpha),
+                               Div255(ToByte(disc.g) * alpha),
+                               Div255(ToByte(disc.b) * alpha),
+                               alpha };
+}
+
+// Заливка одного круга построчно
+void FillDisc(Framebuffer& frame, const DiscFill& disc, const SpanKernel& kernel)
+{
+    FillDiscClipped(frame, disc, 0, 0, frame.Width(), frame.Height(), kernel);
+}
+
+// Заливка круга построчно с отсечением по прямоугольнику
+void FillDiscClipped(Framebuffer& frame, const DiscFill& disc, int clipX0, int clipY0, int clipX1, int clipY1,
+                     const SpanKernel& kernel)
+{
+    PremultipliedColor color = PremultiplyDisc(disc);
+    if (color.a == 0 || !(disc.radius > 0.0f)) {
+        return;
+    }
+    uint32_t packed = PackBgra(color.r, color.g, color.b, color.a);
+
+    float reach = disc.radius + 0.5f;
+    int y0 = ClampedFloor(disc.y - reach, clipY0, clipY1);
+    int y1 = ClampedCeil(disc.y + reach, clipY0, clipY1);
+    int x0 = ClampedFloor(disc.x - reach, clipX0, clipX1);
+    int x1 = ClampedCeil(disc.x + reach, clipX0, clipX1);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    // Ближайшие к центру круга столбец и строка прямоугольника. Если не покрыт пиксель
+    // на их пересечении, не покрыт ни один, а если покрыт полностью самый дальний -
+    // покрыты полностью все. Так плитки у края описанного квадрата и плитки внутри круга
+    // обходятся без поиска границ
+    int center = ClampedColumn(std::floor(disc.x), x0, x1 - 1);
+    int centerRow = ClampedColumn(std::floor(disc.y), y0, y1 - 1);
+    float nearDy = static_cast<float>(centerRow) + 0.5f - disc.y;
+    if (PixelCoverage(center, nearDy * nearDy, disc) == 0) {
+        return;
+    }
+    float topDy = static_cast<float>(y0) + 0.5f - disc.y;
+    float bottomDy = static_cast<float>(y1 - 1) + 0.5f - disc.y;
+    float farDySquared = std::max(topDy * topDy, bottomDy * bottomDy);
+    if (PixelCoverage(x0, farDySquared, disc) == 255 && PixelCoverage(x1 - 1, farDySquared, disc) == 255) {
+        for (int y = y0; y < y1; ++y) {
+            kernel.blendSpan(frame.Row(y) + x0, static_cast<size_t>(x1 - x0), packed);
+        }
+        return;
+    }
+
+    for (int y = y0; y < y1; ++y) {
+        float dy = static_cast<float>(y) + 0.5f - disc.y;
+        float dySquared = dy * dy;
+        RowSpans spans;
+        if (DiscRowSpans(disc, dySquared, x0, x1, center, spans)) {
+            BlendRowRange(frame.Row(y), spans.left, spans.right, spans, disc, dySquared, color, packed, kernel);
+        }
+    }
+}
+
+// Заливка волны за один проход
+void FillWave(Framebuffer& frame, const DiscFill& outer, const DiscFill& inner, const SpanKernel& kernel)
+{
+    FillWaveClipped(frame, outer, inner, 0, 0, frame.Width(), frame.Height(), kernel);
+}
+
+// Заливка волны за один проход с отсечением по прямоугольнику
+void FillWaveClipped(Framebuffer& frame, const DiscFill& outer, const DiscFill& inner,
+                     int clipX0, int clipY0, int clipX1, int clipY1, const SpanKernel& kernel)
+{
+    // Проход по строкам внешнего круга опирается на то, что внутренний круг с тем же центром
+    // покрывает каждый пиксель не больше внешнего; иначе, как и для невидимых кругов,
+    // круги заливаются по очереди
+    PremultipliedColor outerColor = PremultiplyDisc(outer);
+    PremultipliedColor innerColor = PremultiplyDisc(inner);
+    if (outer.x != inner.x || outer.y != inner.y || !(inner.radius > 0.0f) || !(inner.radius <= outer.radius) ||
+        outerColor.a == 0 || innerColor.a == 0) {
+        FillDiscClipped(frame, outer, clipX0, clipY0, clipX1, clipY1, kernel);
+        FillDiscClipped(frame, inner, clipX0, clipY0, clipX1, clipY1, kernel);
+        return;
+    }
+    uint32_t outerPacked = PackBgra(outerColor.r, outerColor.g, outerColor.b, outerColor.a);
+    uint32_t innerPacked = PackBgra(innerColor.r, innerColor.g, innerColor.b, innerColor.a);
+
+    float reach = outer.radius + 0.5f;
+    int y0 = ClampedFloor(outer.y - reach, clipY0, clipY1);
+    int y1 = ClampedCeil(outer.y + reach, clipY0, clipY1);
+    int x0 = ClampedFloor(outer.x - reach, clipX0, clipX1);
+    int x1 = ClampedCeil(outer.x + reach, clipX0, clipX1);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    // Те же проверки прямоугольника целиком, что в FillDiscClipped, для обоих кругов
+    int center = ClampedColumn(std::floor(outer.x), x0, x1 - 1);
+    int centerRow = ClampedColumn(std::floor(outer.y), y0, y1 - 1);
+    float nearDy = static_cast<float>(centerRow) + 0.5f - outer.y;
+    float nearDySquared = nearDy * nearDy;
+    if (PixelCoverage(center, nearDySquared, outer) == 0) {
+        return;
+    }
+    float topDy = static_cast<float>(y0) + 0.5f - outer.y;
+    float bottomDy = static_cast<float>(y1 - 1) + 0.5f - outer.y;
+    float farDySquared = std::max(topDy * topDy, bottomDy * bottomDy);
+    if (PixelCoverage(x0, farDySquared, outer) == 255 && PixelCoverage(x1 - 1, farDySquared, outer) == 255) {
+        bool innerFull = PixelCoverage(x0, farDySquared, inner) == 255 &&
+                         PixelCoverage(x1 - 1, farDySquared, inner) == 255;
+        bool innerEmpty = PixelCoverage(center, nearDySquared, inner) == 0;
+        if (innerFull || innerEmpty) {
+            for (int y = y0; y < y1; ++y) {
+                if (innerFull) {
+                    kernel.blendSpan2(frame.Row(y) + x0, static_cast<size_t>(x1 - x0), outerPacked, innerPacked);
+                } else {
+                    kernel.blendSpan(frame.Row(y) + x0, static_cast<size_t>(x1 - x0), outerPacked);
+                }
+            }
+            return;
+        }
+    }
+
+    for (int y = y0; y < y1; ++y) {
+        float dy = static_cast<float>(y) + 0.5f - outer.y;
+        float dySquared = dy * dy;
+        RowSpans outerSpans;
+        if (!DiscRowSpans(outer, dySquared, x0, x1, center, outerSpans)) {
+            continue;
+        }
+        uint32_t* row = frame.Row(y);
+        RowSpans innerSpans;
+        if (!DiscRowSpans(inner, dySquared, x0, x1, center, innerSpans)) {
+            BlendRowRange(row, outerSpans.left, outerSpans.right, outerSpans, outer, dySquared,
+                          outerColor, outerPacked, kernel);
+            continue;
+        }
+
+        // Отрезки внутреннего круга лежат внутри одноимённых отрезков внешнего:
+        // кольцо слева и справа - только внешний круг, край внутреннего - оба наложения
+        // на пиксель подряд, середина - оба цвета одним проходом ядра
+        auto blendBoth = [&](int x) {
+            uint32_t pixel = BlendOver(row[x], outerColor, PixelCoverage(x, dySquared, outer));
+            row[x] = BlendOver(pixel, innerColor, PixelCoverage(x, dySquared, inner));
+        };
+        BlendRowRange(row, outerSpans.left, innerSpans.left, outerSpans, outer, dySquared,
+                      outerColor, outerPacked, kernel);
+        for (int x = innerSpans.left; x < innerSpans.fullLeft; ++x) {
+            blendBoth(x);
+        }
+        if (innerSpans.fullRight > innerSpans.fullLeft) {
+            kernel.blendSpan2(row + innerSpans.fullLeft, static_cast<size_t>(innerSpans.fullRight - innerSpans.fullLeft),
+                              outerPacked, innerPacked);
+        }
+        for (int x = innerSpans.fullRight; x < innerSpans.right; ++x) {
+            blendBoth(x);
+        }
+        BlendRowRange(row, innerSpans.right, outerSpans.right, outerSpans, outer, dySquared,
+                      outerColor, outerPacked, kernel);
+    }
+}
+
+// Эталонная заливка: каждый пиксель описанного квадрата получает своё покрытие
+void FillDiscReference(Framebuffer& frame, const DiscFill& disc)
+{
+    PremultipliedColor color = PremultiplyDisc(disc);
+    if (color.a == 0 || !(disc.radius > 0.0f)) {
+        return;
+    }
+
+    // Пиксели, центр которых дальше radius + 0.5 от центра круга, не покрыты
+    float reach = disc.radius + 0.5f;
+    int y0 = ClampedFloor(disc.y - reach, 0, frame.Height());
+    int y1 = ClampedCeil(disc.y + reach, 0, frame.Height());
+    int x0 = ClampedFloor(disc.x - reach, 0, frame.Width());
+    int x1 = ClampedCeil(disc.x + reach, 0, frame.Width());
+
+    for (int y = y0; y < y1; ++y) {
+        uint32_t* row = frame.Row(y);
+        float dy = static_cast<float>(y) + 0.5f - disc.y;
+        float dySquared = dy * dy;
+        for (int x = x0; x < x1; ++x) {
+            uint32_t coverage = PixelCoverage(x, dySquared, disc);
+            if (coverage != 0) {
+                row[x] = BlendOver(row[x], color, coverage);
+            }
+        }
+    }
+}
+
+// Границы заливки круга
+PixelRect DiscBounds(const DiscFill& disc, int width, int height)
+{
+    if (!(disc.radius > 0.0f) || PremultiplyDisc(disc).a == 0) {
+        return EmptyRect();
+    }
+
+    // Те же границы, что у заливки: пиксели дальше radius + 0.5 от центра не покрыты
+    float reach = disc.radius + 0.5f;
+    PixelRect bounds = { ClampedFloor(disc.x - reach, 0, width), ClampedFloor(disc.y - reach, 0, height),
+                         ClampedCeil(disc.x + reach, 0, width), ClampedCeil(disc.y + reach, 0, height) };
+    return bounds.Empty() ? EmptyRect() : bounds;
+}
+
+// Границы всех кругов списка
+PixelRect DrawListBounds(const WaveDrawList& list, int width, int height)
+{
+    PixelRect bounds = EmptyRect();
+    for (const DiscFill& disc : list) {
+        bounds = UnionRect(bounds, DiscBounds(disc, width, height));
+    }
+    return bounds;
+}
+
+// Кадр целиком
+void RasterizeDrawList(Framebuffer& frame, const WaveDrawList& list)
+{
+    frame.Clear();
+    for (size_t wave = 0; wave < list.WaveCount(); ++wave) {
+        FillWave(frame, list.Outer(wave), list.Inner(wave));
+    }
+}
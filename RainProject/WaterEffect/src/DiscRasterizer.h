@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "DirtyRegion.h"
+#include "Framebuffer.h"
+#include "SpanKernels.h"
+#include "WaveDrawList.h"
+
+// Программная растеризация кругов волн в кадр BGRA с предумноженной альфой -
+// тот же формат и порядок наложения, что у цели рендеринга Direct2D в Render().
+// Центр пикселя (x, y) находится в точке (x + 0.5, y + 0.5), как у Direct2D.
+// Сглаживание края - доля покрытия по расстоянию от центра пикселя до окружности
+// (полоса шириной в пиксель). Вся арифметика смешивания целочисленная с округлением
+// после каждого круга, как при записи в 8-битную цель, поэтому быстрые пути
+// (SIMD, плитки) обязаны давать тот же кадр побитово
+
+// Цвет заливки в 8 битах на компоненту с предумноженной альфой
+struct PremultipliedColor {
+    uint32_t r;
+    uint32_t g;
+    uint32_t b;
+    uint32_t a;
+};
+
+// Перевод кисти круга (цвет 0..1 и прозрачность, как D2D1::ColorF) в предумноженный цвет
+PremultipliedColor PremultiplyDisc(const DiscFill& disc);
+
+// Заливка одного круга с отсечением по границам кадра построчно: в каждой строке
+// находится отрезок полностью покрытых пикселей, который заливается ядром kernel,
+// а покрытие вычисляется только для пикселей края слева и справа от него
+void FillDisc(Framebuffer& frame, const DiscFill& disc, const SpanKernel& kernel = GetSpanKernel());
+
+// То же с отсечением по прямоугольнику [clipX0, clipX1) x [clipY0, clipY1) внутри кадра
+// (плитка кадра): пиксели внутри прямоугольника получают то же значение, что и при заливке
+// всего круга, поэтому плитки можно заливать независимо
+void FillDiscClipped(Framebuffer& frame, const DiscFill& disc, int clipX0, int clipY0, int clipX1, int clipY1,
+                     const SpanKernel& kernel = GetSpanKernel());
+
+// Заливка волны - внешнего круга outer и внутреннего inner с тем же центром - за один проход:
+// кольцо получает только внешний цвет, а пиксели под обоими кругами - оба наложения подряд
+// без промежуточной записи в кадр (середина - ядром blendSpan2). Кадр побитово тот же,
+// что после FillDisc(outer) и FillDisc(inner): смешивание после каждого круга округляется
+// до 8 бит, поэтому заменить оба круга одним заранее смешанным цветом нельзя
+void FillWave(Framebuffer& frame, const DiscFill& outer, const DiscFill& inner,
+              const SpanKernel& kernel = GetSpanKernel());
+
+// То же с отсечением по прямоугольнику [clipX0, clipX1) x [clipY0, clipY1) внутри кадра
+void FillWaveClipped(Framebuffer& frame, const DiscFill& outer, const DiscFill& inner,
+                     int clipX0, int clipY0, int clipX1, int clipY1, const SpanKernel& kernel = GetSpanKernel());
+
+// Эталонная заливка: покрытие вычисляется для каждого пикселя описанного квадрата.
+// FillDisc обязан давать тот же кадр побитово
+void FillDiscReference(Framebuffer& frame, const DiscFill& disc);
+
+// Пиксели кадра width x height, которых может коснуться заливка круга
+// (пустой прямоугольник, если круг ничего не рисует или лежит вне кадра)
+PixelRect DiscBounds(const DiscFill& disc, int width, int height);
+
+// Объединение границ всех кругов списка
+PixelRect DrawListBounds(const WaveDrawList& list, int width, int height);
+
+// Кадр целиком: очистка до прозрачного и заливка всех волн списка по порядку (FillWave)
+void RasterizeDrawList(Framebuffer& frame, const WaveDrawList& list);
+
+// Покрытие пикселя кругом (0..255) по квадрату расстояния от центра круга до центра пикселя
+inline uint32_t DiscCoverage(float distanceSquared, float radius)
+{
+    float coverage = radius + 0.5f - std::sqrt(distanceSquared);
+    if (coverage <= 0.0f) {
+        return 0;
+    }
+    if (coverage >= 1.0f) {
+        return 255;
+    }
+    return static_cast<uint32_t>(coverage * 255.0f + 0.5f);
+}
+
+// Наложение цвета с покрытием coverage поверх пикселя: src + dst * (1 - srcAlpha)
+inline uint32_t BlendOver(uint32_t dst, const PremultipliedColor& color, uint32_t coverage)
+{
+    uint32_t sa = Div255(color.a * coverage);
+    uint32_t inverse = 255 - sa;
+    uint32_t a = sa + Div255((dst >> 24) * inverse);
+    uint32_t r = Div255(color.r * coverage) + Div255(((dst >> 16) & 0xFF) * inverse);
+    uint32_t g = Div255(color.g * coverage) + Div255(((dst >> 8) & 0xFF) * inverse);
+    uint32_t b = Div255(color.b * coverage) + Div255((dst & 0xFF) * inverse);
+    return PackBgra(r, g, b, a);
+}
@@ -0,0 +1,180 @@
+#include "FrameRunner.h"
+#include "DiscRasterizer.h"
+#include "TraceZones.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Имена режимов в порядке WaveMode
+const char* const WAVE_MODE_NAMES[] = { "integrated", "analytic", "heightfield" };
+
+// Время между двумя моментами, наносекунды
+uint64_t NanosecondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+} // namespace
+
+// Значение ключа командной строки
+const char* OptionValue(const char* argument, const char* name)
+{
+    size_t length = std::strlen(name);
+    if (std::strncmp(argument, name, length) == 0 && argument[length] == '=') {
+        return argument + length + 1;
+    }
+    return nullptr;
+}
+
+// Режим симуляции по имени
+bool ParseWaveMode(const char* name, WaveMode& mode)
+{
+    for (size_t i = 0; i < sizeof(WAVE_MODE_NAMES) / sizeof(WAVE_MODE_NAMES[0]); ++i) {
+        if (std::strcmp(name, WAVE_MODE_NAMES[i]) == 0) {
+            mode = static_cast<WaveMode>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Имя режима симуляции
+const char* WaveModeName(WaveMode mode)
+{
+    return WAVE_MODE_NAMES[static_cast<size_t>(mode)];
+}
+
+// Конструктор
+FrameRunner::FrameRunner() :
+    m_simulation(nullptr),
+    m_width(0),
+    m_height(0),
+    m_rasterize(false),
+    m_allocationCount(nullptr),
+    m_stats(new FrameStats()),
+    m_frames(0),
+    m_maxWaves(0),
+    m_discs(0),
+    m_waveChecksum(0.0),
+    m_lastAllocations(0),
+    m_peakWaves(0),
+    m_steadyAllocations(0),
+    m_steadyFramesWithAllocations(0)
+{
+}
+
+// Подготовка к кадрам
+void FrameRunner::Initialize(WaterSimulation& simulation, int width, int height, size_t threads,
+                             AllocationCounter allocationCount)
+{
+    m_simulation = &simulation;
+    m_width = width;
+    m_height = height;
+    m_rasterize = simulation.GetWaveMode() != WaveMode::HeightField;
+    m_allocationCount = allocationCount;
+
+    m_drawList.Reserve(WaterSimulation::WAVE_POOL_CAPACITY);
+    if (m_rasterize) {
+        m_screen.Resize(width, height);
+        m_renderer.Resize(width, height);
+        m_renderer.Reserve(WaterSimulation::WAVE_POOL_CAPACITY, WaterSimulation::MAX_WAVE_RADIUS);
+        m_renderPool.reset(new ThreadPool(threads));
+        m_renderPool->Reserve(m_renderer.TileCount(), TileRenderer::TILES_PER_TASK);
+    }
+    m_lastAllocations = m_allocationCount ? m_allocationCount() : 0;
+}
+
+// Один кадр
+void FrameRunner::RunFrame()
+{
+    WaterSimulation& simulation = *m_simulation;
+    size_t wavesBefore = simulation.WaveCount();
+    std::chrono::steady_clock::time_point frameStart;
+    std::chrono::steady_clock::time_point renderStart;
+    std::chrono::steady_clock::time_point frameEnd;
+    uint64_t touched = 0;
+    {
+        WATER_TRACE_ZONE("Frame");
+        frameStart = std::chrono::steady_clock::now();
+        simulation.Update();
+        renderStart = std::chrono::steady_clock::now();
+        {
+            WATER_TRACE_ZONE("Render");
+            m_drawList.Clear();
+            simulation.ForEachWave([&](float x, float y, float radius, float opacity) {
+                m_drawList.AddWave(x, y, radius, opacity);
+                m_waveChecksum += static_cast<double>(x + y + radius * opacity);
+            });
+            // Поле высот на экране перерисовывается только в области изменённых плиток
+            if (m_rasterize) {
+                PixelRect area = m_dirtyRegion.Advance(DrawListBounds(m_drawList, m_width, m_height));
+                m_renderer.Render(m_screen, m_drawList, m_renderPool.get(), area);
+                touched = m_renderer.TouchedPixels();
+            } else {
+                touched = simulation.HeightFieldScreenArea(simulation.HeightFrameChanged(), m_width, m_height).Area();
+            }
+        }
+        frameEnd = std::chrono::steady_clock::now();
+    }
+
+    m_stats->Record(FrameMetric::Update, NanosecondsBetween(frameStart, renderStart));
+    m_stats->Record(FrameMetric::Render, NanosecondsBetween(renderStart, frameEnd));
+    if (m_frames > 0) {
+        m_stats->Record(FrameMetric::FrameInterval, NanosecondsBetween(m_lastFrameStart, frameStart));
+    }
+    m_stats->RecordPixels(touched, static_cast<uint64_t>(m_width) * static_cast<uint64_t>(m_height));
+    m_lastFrameStart = frameStart;
+
+    if (m_allocationCount) {
+        uint64_t allocations = m_allocationCount();
+        uint64_t frameAllocations = allocations - m_lastAllocations;
+        m_lastAllocations = allocations;
+        m_stats->RecordAllocations(frameAllocations);
+        if (m_frames > 0 && wavesBefore <= m_peakWaves && frameAllocations > 0) {
+            m_steadyAllocations += frameAllocations;
+            ++m_steadyFramesWithAllocations;
+        }
+    }
+    m_peakWaves = std::max(m_peakWaves, wavesBefore);
+
+    ++m_frames;
+    m_discs += m_drawList.Size();
+    m_maxWaves = std::max(m_maxWaves, simulation.WaveCount());
+}
+
+// Последний построенный кадр
+const Framebuffer& FrameRunner::Frame() const
+{
+    return m_rasterize ? m_screen : m_simulation->HeightFrame();
+}
+
+// Контрольная сумма
+double FrameRunner::Checksum() const
+{
+    double checksum = m_waveChecksum;
+    const Framebuffer& frame = Frame();
+    for (int y = 0; y < frame.Height(); ++y) {
+        const uint32_t* row = frame.Row(y);
+        for (int x = 0; x < frame.Width(); ++x) {
+            checksum += static_cast<double>(row[x] >> 24) + static_cast<double>(row[x] & 0xFF);
+        }
+    }
+    return checksum;
+}
+
+// Печать выделений в установившемся режиме
+bool FrameRunner::ReportSteadyAllocations() const
+{
+    // Кадр в установившемся режиме не должен трогать распределитель памяти
+    if (m_allocationCount) {
+        std::printf("Выделений в установившемся режиме: %llu в %zu кадрах\n",
+                    static_cast<unsigned long long>(m_steadyAllocations), m_steadyFramesWithAllocations);
+    }
+    if (m_steadyAllocations > 0) {
+        std::fprintf(stderr, "Кадры в установившемся режиме выделяют память\n");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+#include "DirtyRegion.h"
+#include "FrameStats.h"
+#include "Framebuffer.h"
+#include "ThreadPool.h"
+#include "TileRenderer.h"
+#include "WaterSimulation.h"
+#include "WaveDrawList.h"
+
+// Значение ключа командной строки вида --name=value или nullptr
+const char* OptionValue(const char* argument, const char* name);
+
+// Режим симуляции по имени ("integrated", "analytic", "heightfield"); false - неизвестное имя
+bool ParseWaveMode(const char* name, WaveMode& mode);
+
+// Имя режима симуляции
+const char* WaveModeName(WaveMode mode);
+
+// Кадры эффекта без окна (water_headless, water_replay).
+// Кадр - обновление симуляции и построение кадра в памяти: круги волн растеризуются
+// по плиткам на своём пуле потоков в области перерисовки (DirtyRegion), а поле высот
+// строит свой кадр само. Время обновления, отрисовки и интервал между началами кадров
+// идут в гистограммы FrameStats. Выделения памяти считаются от конца одного кадра
+// до конца следующего (вместе с волнами между ними); установившийся режим - кадры
+// после первого, в которых волн не больше, чем уже было: пулы и блоки волн
+// к этому моменту выросли до нужного размера
+class FrameRunner {
+public:
+    // Счётчик выделений памяти программы (AllocationCount). AllocationTracker собирается
+    // в саму программу, а не в WaterCore, поэтому счётчик передаётся снаружи
+    using AllocationCounter = uint64_t (*)();
+
+    FrameRunner();
+
+    FrameRunner(const FrameRunner&) = delete;
+    FrameRunner& operator=(const FrameRunner&) = delete;
+
+    // Подготовка кадра экрана, раскладки плиток и пула потоков для уже инициализированной
+    // симуляции. allocationCount == nullptr - выделения не считаются
+    void Initialize(WaterSimulation& simulation, int width, int height, size_t threads,
+                    AllocationCounter allocationCount);
+
+    // Один кадр; часы симуляции и новые волны задаёт вызывающий
+    void RunFrame();
+
+    // Контрольная сумма: состояние волн во всех кадрах и последний кадр (экрана или поля высот) целиком
+    double Checksum() const;
+
+    // Последний построенный кадр
+    const Framebuffer& Frame() const;
+
+    size_t Frames() const { return m_frames; }
+    size_t MaxWaves() const { return m_maxWaves; }
+    uint64_t Discs() const { return m_discs; }
+    const FrameStats& Stats() const { return *m_stats; }
+
+    // Печать выделений в установившемся режиме (если они считаются);
+    // false, если кадры в установившемся режиме выделяли память
+    bool ReportSteadyAllocations() const;
+
+private:
+    WaterSimulation* m_simulation;          // Симуляция, кадры которой строятся
+    int m_width;                            // Размер экрана
+    int m_height;
+    bool m_rasterize;                       // Круги волн (иначе кадр поля высот)
+    AllocationCounter m_allocationCount;    // Счётчик выделений или nullptr
+
+    WaveDrawList m_drawList;                // Заливки кругов кадра
+    Framebuffer m_screen;                   // Кадр экрана для кругов волн
+    TileRenderer m_renderer;                // Отрисовка по плиткам
+    DirtyRegion m_dirtyRegion;              // Область перерисовки
+    std::unique_ptr<ThreadPool> m_renderPool; // Потоки отрисовки
+    std::unique_ptr<FrameStats> m_stats;    // Гистограммы времени кадра
+
+    size_t m_frames;                        // Построено кадров
+    size_t m_maxWaves;                      // Наибольшее число волн после кадра
+    uint64_t m_discs;                       // Кругов во всех кадрах
+    double m_waveChecksum;                  // Сумма состояния волн во всех кадрах
+    std::chrono::steady_clock::time_point m_lastFrameStart; // Начало прошлого кадра
+
+    uint64_t m_lastAllocations;             // Счётчик выделений в конце прошлого кадра
+    size_t m_peakWaves;                     // Наибольшее число волн перед кадром
+    uint64_t m_steadyAllocations;           // Выделений в установившемся режиме
+    size_t m_steadyFramesWithAllocations;   // Кадров установившегося режима с выделениями
+};
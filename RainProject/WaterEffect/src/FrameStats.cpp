@@ -0,0 +1,64 @@
+#include "FrameStats.h"
+
+// Сброс всех гистограмм
+void FrameStats::Reset()
+{
+    for (LatencyHistogram& histogram : m_histograms) {
+        histogram.Reset();
+    }
+    m_allocationFrames = 0;
+    m_framesWithAllocations = 0;
+    m_allocations = 0;
+    m_maxFrameAllocations = 0;
+    m_pixelFrames = 0;
+    m_skippedFrames = 0;
+    m_touchedPixels = 0;
+    m_framePixels = 0;
+    m_maxTouchedPixels = 0;
+}
+
+// Печать сводки
+void FrameStats::Print(FILE* file) const
+{
+    for (size_t i = 0; i < static_cast<size_t>(FrameMetric::Count); ++i) {
+        LatencyHistogram::Summary summary = m_histograms[i].Summarize();
+        if (summary.count == 0) {
+            continue;
+        }
+        std::fprintf(file, "%-15s n %-8llu mean %9.2f  p50 %9.2f  p90 %9.2f  p99 %9.2f  p99.9 %9.2f  max %9.2f мкс\n",
+                     MetricName(static_cast<FrameMetric>(i)), static_cast<unsigned long long>(summary.count),
+                     summary.mean / 1000.0, static_cast<double>(summary.p50) / 1000.0,
+                     static_cast<double>(summary.p90) / 1000.0, static_cast<double>(summary.p99) / 1000.0,
+                     static_cast<double>(summary.p999) / 1000.0, static_cast<double>(summary.max) / 1000.0);
+    }
+
+    if (m_allocationFrames > 0) {
+        std::fprintf(file, "%-15s n %-8llu с выделениями %llu, всего %llu, максимум за кадр %llu\n", "allocations",
+                     static_cast<unsigned long long>(m_allocationFrames),
+                     static_cast<unsigned long long>(m_framesWithAllocations),
+                     static_cast<unsigned long long>(m_allocations),
+                     static_cast<unsigned long long>(m_maxFrameAllocations));
+    }
+
+    if (m_pixelFrames > 0) {
+        std::fprintf(file, "%-15s n %-8llu без перерисовки %llu, в среднем %.0f за кадр (%.2f%% экрана), максимум %llu\n",
+                     "pixels", static_cast<unsigned long long>(m_pixelFrames),
+                     static_cast<unsigned long long>(m_skippedFrames),
+                     static_cast<double>(m_touchedPixels) / static_cast<double>(m_pixelFrames),
+                     m_framePixels > 0 ? 100.0 * static_cast<double>(m_touchedPixels) / static_cast<double>(m_framePixels) : 0.0,
+                     static_cast<unsigned long long>(m_maxTouchedPixels));
+    }
+}
+
+// Имя величины
+const char* FrameStats::MetricName(FrameMetric metric)
+{
+    switch (metric) {
+        case FrameMetric::Update: return "update";
+        case FrameMetric::Render: return "render";
+        case FrameMetric::Present: return "present";
+        case FrameMetric::FrameInterval: return "frame_interval";
+        case FrameMetric::Count: break;
+    }
+    return "?";
+}
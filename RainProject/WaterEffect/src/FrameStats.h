@@ -0,0 +1,96 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Измеряемые величины кадра
+enum class FrameMetric {
+    Update,         // Продвижение симуляции
+    Render,         // Построение кадра (до EndDraw)
+    Present,        // EndDraw: передача кадра системе
+    FrameInterval,  // Интервал между началами соседних кадров
+    Count
+};
+
+// Гистограммы времени кадра.
+// Каждая гистограмма занимает десятки килобайт, поэтому объект
+// создаётся один раз в куче, а запись в него не выделяет памяти
+class FrameStats {
+public:
+    // Запись длительности в наносекундах
+    void Record(FrameMetric metric, uint64_t nanoseconds) {
+        m_histograms[static_cast<size_t>(metric)].Record(nanoseconds);
+    }
+
+    const LatencyHistogram& Histogram(FrameMetric metric) const {
+        return m_histograms[static_cast<size_t>(metric)];
+    }
+
+    // Запись числа выделений памяти за кадр (AllocationTracker)
+    void RecordAllocations(uint64_t count) {
+        ++m_allocationFrames;
+        m_allocations += count;
+        m_framesWithAllocations += count > 0 ? 1 : 0;
+        m_maxFrameAllocations = count > m_maxFrameAllocations ? count : m_maxFrameAllocations;
+    }
+
+    // Выделения памяти по кадрам
+    struct AllocationSummary {
+        uint64_t frames;                // Кадров с подсчётом
+        uint64_t framesWithAllocations; // Кадров, где память выделялась
+        uint64_t allocations;           // Выделений всего
+        uint64_t maxPerFrame;           // Наибольшее число выделений за кадр
+    };
+    AllocationSummary Allocations() const {
+        return AllocationSummary{ m_allocationFrames, m_framesWithAllocations, m_allocations, m_maxFrameAllocations };
+    }
+
+    // Запись числа пикселей, очищенных и перерисованных за кадр, из framePixels пикселей экрана
+    // (0 - кадр не строился, потому что на экране ничего не менялось)
+    void RecordPixels(uint64_t touched, uint64_t framePixels) {
+        ++m_pixelFrames;
+        m_skippedFrames += touched == 0 ? 1 : 0;
+        m_touchedPixels += touched;
+        m_framePixels += framePixels;
+        m_maxTouchedPixels = touched > m_maxTouchedPixels ? touched : m_maxTouchedPixels;
+    }
+
+    // Перерисованные пиксели по кадрам
+    struct PixelSummary {
+        uint64_t frames;                // Кадров с подсчётом
+        uint64_t skippedFrames;         // Кадров без перерисовки
+        uint64_t touched;               // Пикселей перерисовано всего
+        uint64_t framePixels;           // Пикселей экрана за все кадры (перерисовка целиком)
+        uint64_t maxPerFrame;           // Наибольшее число пикселей за кадр
+    };
+    PixelSummary Pixels() const {
+        return PixelSummary{ m_pixelFrames, m_skippedFrames, m_touchedPixels, m_framePixels, m_maxTouchedPixels };
+    }
+
+    // Сброс всех гистограмм
+    void Reset();
+
+    // Печать сводки по величинам, у которых есть записи (значения в микросекундах),
+    // и по выделениям памяти и перерисованным пикселям, если они подсчитывались
+    void Print(FILE* file) const;
+
+    // Имя величины для отчётов
+    static const char* MetricName(FrameMetric metric);
+
+private:
+    LatencyHistogram m_histograms[static_cast<size_t>(FrameMetric::Count)];
+
+    uint64_t m_allocationFrames = 0;        // Кадров с подсчётом выделений
+    uint64_t m_framesWithAllocations = 0;   // Кадров, где память выделялась
+    uint64_t m_allocations = 0;             // Выделений всего
+    uint64_t m_maxFrameAllocations = 0;     // Наибольшее число выделений за кадр
+
+    uint64_t m_pixelFrames = 0;             // Кадров с подсчётом пикселей
+    uint64_t m_skippedFrames = 0;           // Кадров без перерисовки
+    uint64_t m_touchedPixels = 0;           // Перерисовано пикселей всего
+    uint64_t m_framePixels = 0;             // Пикселей экрана за все кадры
+    uint64_t m_maxTouchedPixels = 0;        // Наибольшее число пикселей за кадр
+};
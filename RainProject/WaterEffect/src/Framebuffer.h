@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Кадр в памяти в формате цели рендеринга Direct2D:
+// DXGI_FORMAT_B8G8R8A8_UNORM с предумноженной альфой (D2D1_ALPHA_MODE_PREMULTIPLIED).
+// Пиксель хранится как 0xAARRGGBB, то есть в памяти байты идут B, G, R, A
+class Framebuffer {
+public:
+    Framebuffer() : m_width(0), m_height(0) {}
+    Framebuffer(int width, int height) : m_width(0), m_height(0) { Resize(width, height); }
+
+    // Изменение размера (содержимое очищается)
+    void Resize(int width, int height) {
+        m_width = width > 0 ? width : 0;
+        m_height = height > 0 ? height : 0;
+        m_pixels.assign(static_cast<size_t>(m_width) * static_cast<size_t>(m_height), 0u);
+    }
+
+    // Заливка всего кадра одним цветом
+    void Clear(uint32_t color = 0u) {
+        std::fill(m_pixels.begin(), m_pixels.end(), color);
+    }
+
+    // Заливка прямоугольника [x0, x1) x [y0, y1) одним цветом (границы уже внутри кадра)
+    void ClearRect(int x0, int y0, int x1, int y1, uint32_t color = 0u) {
+        for (int y = y0; y < y1; ++y) {
+            std::fill(Row(y) + x0, Row(y) + x1, color);
+        }
+    }
+
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+
+    // Шаг строки в байтах
+    size_t Pitch() const { return static_cast<size_t>(m_width) * sizeof(uint32_t); }
+
+    uint32_t* Row(int y) { return m_pixels.data() + static_cast<size_t>(y) * static_cast<size_t>(m_width); }
+    const uint32_t* Row(int y) const { return m_pixels.data() + static_cast<size_t>(y) * static_cast<size_t>(m_width); }
+
+    uint32_t* Data() { return m_pixels.data(); }
+    const uint32_t* Data() const { return m_pixels.data(); }
+
+private:
+    int m_width;
+    int m_height;
+    std::vector<uint32_t> m_pixels;
+};
+
+// Упаковка предумноженного цвета (компоненты 0..255)
+inline uint32_t PackBgra(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// Деление на 255 с округлением для значений 0..65535 (смешивание 8-битных компонент)
+inline uint32_t Div255(uint32_t value)
+{
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
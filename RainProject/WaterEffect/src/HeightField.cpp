@@ -0,0 +1,312 @@
+#include "HeightField.h"
+#include "HeightFieldKernels.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Усиление высоты при переводе в прозрачность
+constexpr float SHADE_GAIN = 0.02f;
+
+// Максимальная непрозрачность воды
+constexpr float SHADE_MAX_ALPHA = 0.5f;
+
+// Цвета воды: DeepSkyBlue во впадинах и на склонах, LightBlue на гребнях
+constexpr float DEEP_R = 0.0f, DEEP_G = 191.0f, DEEP_B = 255.0f;
+constexpr float CREST_R = 173.0f, CREST_G = 216.0f, CREST_B = 230.0f;
+
+// Порог высоты: ниже него волна не видна при закраске (альфа округляется до нуля)
+constexpr float ENERGY_THRESHOLD = 0.1f;
+
+// Сколько шагов подряд плитка должна быть спокойной, чтобы уснуть
+constexpr uint8_t SLEEP_AFTER_STEPS = 8;
+
+} // namespace
+
+// Конструктор
+HeightField::HeightField() :
+    m_width(0),
+    m_height(0),
+    m_stride(0),
+    m_damping(0.98f),
+    m_tilesX(0),
+    m_tilesY(0),
+    m_shadedRect(EmptyRect())
+{
+}
+
+// Изменение размера сетки
+void HeightField::Resize(int width, int height)
+{
+    m_width = std::max(width, 0);
+    m_height = std::max(height, 0);
+    m_stride = static_cast<size_t>(m_width) + 2;
+
+    size_t cells = m_stride * (static_cast<size_t>(m_height) + 2);
+    m_current.assign(cells, 0.0f);
+    m_previous.assign(cells, 0.0f);
+
+    m_tilesX = (m_width + TILE_SIZE - 1) / TILE_SIZE;
+    m_tilesY = (m_height + TILE_SIZE - 1) / TILE_SIZE;
+    size_t tiles = static_cast<size_t>(m_tilesX) * static_cast<size_t>(m_tilesY);
+    m_tileState.assign(tiles, TileState{ 0, 0 });
+
+    // Списки плиток не растут после изменения размера
+    m_activeTiles.clear();
+    m_activeTiles.reserve(tiles);
+    m_tileResults.assign(tiles, 0);
+    m_sleptTiles.clear();
+    m_sleptTiles.reserve(tiles);
+}
+
+// Обнуление поля
+void HeightField::Clear()
+{
+    std::fill(m_current.begin(), m_current.end(), 0.0f);
+    std::fill(m_previous.begin(), m_previous.end(), 0.0f);
+
+    // Активные плитки нужно стереть в кадре при следующей закраске
+    for (uint32_t tile : m_activeTiles) {
+        m_tileState[tile] = TileState{ 0, 0 };
+        m_sleptTiles.push_back(tile);
+    }
+    m_activeTiles.clear();
+}
+
+// Возмущение поверхности
+void HeightField::AddImpulse(float x, float y, float radius, float strength)
+{
+    if (radius <= 0.0f) {
+        return;
+    }
+
+    int x0 = std::max(0, static_cast<int>(std::floor(x - radius)));
+    int x1 = std::min(m_width - 1, static_cast<int>(std::ceil(x + radius)));
+    int y0 = std::max(0, static_cast<int>(std::floor(y - radius)));
+    int y1 = std::min(m_height - 1, static_cast<int>(std::ceil(y + radius)));
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+
+    const float pi = 3.14159265f;
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            float dx = static_cast<float>(cx) - x;
+            float dy = static_cast<float>(cy) - y;
+            float distance = std::sqrt(dx * dx + dy * dy);
+            if (distance < radius) {
+                // Купол с косинусным профилем без излома на краю
+                m_current[Index(cx, cy)] += strength * 0.5f * (1.0f + std::cos(pi * distance / radius));
+            }
+        }
+    }
+
+    // Будим все плитки, которых коснулось возмущение
+    for (int ty = y0 / TILE_SIZE; ty <= y1 / TILE_SIZE; ++ty) {
+        for (int tx = x0 / TILE_SIZE; tx <= x1 / TILE_SIZE; ++tx) {
+            ActivateTile(tx, ty);
+        }
+    }
+}
+
+// Один шаг симуляции
+void HeightField::Step(ThreadPool* pool)
+{
+    size_t activeCount = m_activeTiles.size();
+
+    // Каждая плитка пишет только свои ячейки предыдущего слоя
+    if (pool && pool->ThreadCount() > 1) {
+        pool->ParallelFor(activeCount, TILES_PER_TASK, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                m_tileResults[i] = StepTile(m_activeTiles[i]);
+            }
+        });
+    } else {
+        for (size_t i = 0; i < activeCount; ++i) {
+            m_tileResults[i] = StepTile(m_activeTiles[i]);
+        }
+    }
+
+    // Новое состояние записано в предыдущий слой - он становится текущим.
+    // Обмен выполняется после барьера ParallelFor, когда все плитки завершены
+    m_current.swap(m_previous);
+
+    // Обновление списка активных плиток: спокойные засыпают,
+    // волны у границ будят соседей (они считаются со следующего шага)
+    size_t keep = 0;
+    for (size_t i = 0; i < activeCount; ++i) {
+        uint32_t tile = m_activeTiles[i];
+        uint8_t result = m_tileResults[i];
+        TileState& state = m_tileState[tile];
+
+        state.quietSteps = (result & TILE_KEEP) ? 0 : static_cast<uint8_t>(state.quietSteps + 1);
+        if (state.quietSteps < SLEEP_AFTER_STEPS) {
+            m_activeTiles[keep] = tile;
+            m_tileResults[keep] = result;
+            ++keep;
+        } else {
+            ZeroTile(tile);
+            state.active = 0;
+            m_sleptTiles.push_back(tile);
+        }
+    }
+    m_activeTiles.resize(keep);
+
+    for (size_t i = 0; i < keep; ++i) {
+        int tileX = static_cast<int>(m_activeTiles[i] % static_cast<uint32_t>(m_tilesX));
+        int tileY = static_cast<int>(m_activeTiles[i] / static_cast<uint32_t>(m_tilesX));
+        uint8_t result = m_tileResults[i];
+        if ((result & TILE_SPREAD_LEFT) && tileX > 0) {
+            ActivateTile(tileX - 1, tileY);
+        }
+        if ((result & TILE_SPREAD_RIGHT) && tileX + 1 < m_tilesX) {
+            ActivateTile(tileX + 1, tileY);
+        }
+        if ((result & TILE_SPREAD_UP) && tileY > 0) {
+            ActivateTile(tileX, tileY - 1);
+        }
+        if ((result & TILE_SPREAD_DOWN) && tileY + 1 < m_tilesY) {
+            ActivateTile(tileX, tileY + 1);
+        }
+    }
+}
+
+// Шаг одной плитки
+uint8_t HeightField::StepTile(uint32_t tile)
+{
+    HeightFieldRowFn stepRow = GetHeightFieldKernel().stepRow;
+
+    int x0 = static_cast<int>(tile % static_cast<uint32_t>(m_tilesX)) * TILE_SIZE;
+    int y0 = static_cast<int>(tile / static_cast<uint32_t>(m_tilesX)) * TILE_SIZE;
+    int x1 = std::min(x0 + TILE_SIZE, m_width);
+    int y1 = std::min(y0 + TILE_SIZE, m_height);
+    size_t width = static_cast<size_t>(x1 - x0);
+
+    float tileEnergy = 0.0f;
+    float leftEnergy = 0.0f;
+    float rightEnergy = 0.0f;
+    float upEnergy = 0.0f;
+    float downEnergy = 0.0f;
+    for (int y = y0; y < y1; ++y) {
+        size_t row = Index(x0, y);
+        float* next = &m_previous[row];
+
+        // Ядро сразу возвращает энергию строки по новому состоянию
+        float rowEnergy = stepRow(&m_current[row - m_stride], &m_current[row], &m_current[row + m_stride],
+                                  next, width, m_damping);
+
+        tileEnergy = std::max(tileEnergy, rowEnergy);
+        leftEnergy = std::max(leftEnergy, std::fabs(next[0]));
+        rightEnergy = std::max(rightEnergy, std::fabs(next[width - 1]));
+        if (y == y0) {
+            upEnergy = rowEnergy;
+        }
+        if (y == y1 - 1) {
+            downEnergy = rowEnergy;
+        }
+    }
+
+    uint8_t result = 0;
+    if (tileEnergy >= ENERGY_THRESHOLD) {
+        result |= TILE_KEEP;
+    }
+    if (leftEnergy >= ENERGY_THRESHOLD) {
+        result |= TILE_SPREAD_LEFT;
+    }
+    if (rightEnergy >= ENERGY_THRESHOLD) {
+        result |= TILE_SPREAD_RIGHT;
+    }
+    if (upEnergy >= ENERGY_THRESHOLD) {
+        result |= TILE_SPREAD_UP;
+    }
+    if (downEnergy >= ENERGY_THRESHOLD) {
+        result |= TILE_SPREAD_DOWN;
+    }
+    return result;
+}
+
+// Пробуждение плитки
+void HeightField::ActivateTile(int tileX, int tileY)
+{
+    uint32_t tile = static_cast<uint32_t>(tileY * m_tilesX + tileX);
+    TileState& state = m_tileState[tile];
+    state.quietSteps = 0;
+    if (!state.active) {
+        state.active = 1;
+        m_activeTiles.push_back(tile);
+    }
+}
+
+// Обнуление обоих слоёв плитки
+void HeightField::ZeroTile(uint32_t tile)
+{
+    int x0 = static_cast<int>(tile % static_cast<uint32_t>(m_tilesX)) * TILE_SIZE;
+    int y0 = static_cast<int>(tile / static_cast<uint32_t>(m_tilesX)) * TILE_SIZE;
+    int x1 = std::min(x0 + TILE_SIZE, m_width);
+    int y1 = std::min(y0 + TILE_SIZE, m_height);
+
+    for (int y = y0; y < y1; ++y) {
+        std::fill(&m_current[Index(x0, y)], &m_current[Index(x0, y)] + (x1 - x0), 0.0f);
+        std::fill(&m_previous[Index(x0, y)], &m_previous[Index(x0, y)] + (x1 - x0), 0.0f);
+    }
+}
+
+// Перевод поля высот в кадр
+void HeightField::Shade(Framebuffer& frame)
+{
+    if (frame.Width() != m_width || frame.Height() != m_height) {
+        // Новый кадр пуст, спящие плитки в нём уже прозрачные
+        frame.Resize(m_width, m_height);
+    }
+
+    // Уснувшие плитки обнулены - их закраска даёт прозрачные пиксели
+    m_shadedRect = EmptyRect();
+    for (uint32_t tile : m_sleptTiles) {
+        if (!m_tileState[tile].active) {
+            ShadeTile(frame, tile);
+        }
+    }
+    m_sleptTiles.clear();
+
+    for (uint32_t tile : m_activeTiles) {
+        ShadeTile(frame, tile);
+    }
+}
+
+// Закраска плитки
+void HeightField::ShadeTile(Framebuffer& frame, uint32_t tile)
+{
+    int x0 = static_cast<int>(tile % static_cast<uint32_t>(m_tilesX)) * TILE_SIZE;
+    int y0 = static_cast<int>(tile / static_cast<uint32_t>(m_tilesX)) * TILE_SIZE;
+    PixelRect rect = { x0, y0, std::min(x0 + TILE_SIZE, m_width), std::min(y0 + TILE_SIZE, m_height) };
+    ShadeRect(frame, rect.x0, rect.y0, rect.x1, rect.y1);
+    m_shadedRect = UnionRect(m_shadedRect, rect);
+}
+
+// Закраска прямоугольника ячеек
+void HeightField::ShadeRect(Framebuffer& frame, int x0, int y0, int x1, int y1) const
+{
+    for (int y = y0; y < y1; ++y) {
+        const float* row = &m_current[Index(0, y)];
+        uint32_t* out = frame.Row(y);
+
+        for (int x = x0; x < x1; ++x) {
+            float height = row[x];
+            float alpha = std::min(std::fabs(height) * SHADE_GAIN, 1.0f) * SHADE_MAX_ALPHA;
+
+            // Гребни светлее впадин
+            float crest = height > 0.0f ? std::min(height * SHADE_GAIN, 1.0f) : 0.0f;
+            float r = DEEP_R + (CREST_R - DEEP_R) * crest;
+            float g = DEEP_G + (CREST_G - DEEP_G) * crest;
+            float b = DEEP_B + (CREST_B - DEEP_B) * crest;
+
+            // Предумноженная альфа: цвет масштабируется непрозрачностью
+            out[x] = PackBgra(static_cast<uint32_t>(r * alpha + 0.5f),
+                              static_cast<uint32_t>(g * alpha + 0.5f),
+                              static_cast<uint32_t>(b * alpha + 0.5f),
+                              static_cast<uint32_t>(255.0f * alpha + 0.5f));
+        }
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DirtyRegion.h"
+#include "Framebuffer.h"
+
+class ThreadPool;
+
+// Поле высот водной поверхности: затухающее дискретное волновое уравнение
+// на сетке, выровненной по экрану. Хранятся два слоя - текущий и предыдущий;
+// шаг записывает новое состояние на место предыдущего и меняет слои местами.
+// Вокруг сетки есть рамка шириной в одну ячейку с нулевой высотой.
+//
+// Сетка разбита на плитки TILE_SIZE x TILE_SIZE. Считаются и закрашиваются только
+// активные плитки: плитка просыпается от возмущения или когда волна у её границы
+// в соседней плитке превышает порог, и засыпает (с обнулением), когда её энергия
+// несколько шагов подряд остаётся ниже порога. Спокойная вода ничего не стоит.
+//
+// Шаг может выполняться параллельно по плиткам: текущий слой во время шага
+// только читается, поэтому граничные ячейки соседних плиток (гало) берутся из него
+// напрямую, без копирования и без блокировок
+class HeightField {
+public:
+    static constexpr int TILE_SIZE = 32;    // Сторона плитки в ячейках
+    static constexpr int TILES_PER_TASK = 4;    // Плиток в одном куске параллельного шага
+
+    HeightField();
+
+    // Изменение размера сетки (поле обнуляется)
+    void Resize(int width, int height);
+
+    // Обнуление поля
+    void Clear();
+
+    // Коэффициент затухания за шаг (0..1)
+    void SetDamping(float damping) { m_damping = damping; }
+    float Damping() const { return m_damping; }
+
+    // Возмущение поверхности: гладкий купол заданного радиуса (в ячейках) с центром в (x, y)
+    void AddImpulse(float x, float y, float radius, float strength);
+
+    // Один шаг симуляции (параллельно, если передан пул потоков)
+    void Step(ThreadPool* pool = nullptr);
+
+    // Перевод поля высот в кадр того же размера. Перерисовываются только активные
+    // плитки и плитки, уснувшие после предыдущего вызова, поэтому между вызовами
+    // должен передаваться один и тот же кадр
+    void Shade(Framebuffer& frame);
+
+    // Ячейки кадра, перерисованные последним вызовом Shade (объединение плиток;
+    // пусто, если кадр не менялся)
+    const PixelRect& ShadedRect() const { return m_shadedRect; }
+
+    // Поверхность спокойна: нет ни активных плиток, ни уснувших, которые ещё нужно стереть
+    // в кадре, - шаг и закраска ничего не изменят
+    bool IsCalm() const { return m_activeTiles.empty() && m_sleptTiles.empty(); }
+
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+
+    // Высота ячейки текущего слоя
+    float At(int x, int y) const { return m_current[Index(x, y)]; }
+
+    // Число активных плиток (метрика: работа шага и закраски пропорциональна ей)
+    size_t ActiveTileCount() const { return m_activeTiles.size(); }
+
+    // Общее число плиток
+    size_t TileCount() const { return m_tileState.size(); }
+
+private:
+    // Состояние плитки
+    struct TileState {
+        uint8_t active;         // Плитка считается на каждом шаге
+        uint8_t quietSteps;     // Сколько шагов подряд энергия ниже порога
+    };
+
+    // Итог шага плитки для последующего обновления списка активных
+    enum TileResult : uint8_t {
+        TILE_KEEP = 1,          // Плитка остаётся активной
+        TILE_SPREAD_LEFT = 2,   // Волна дошла до левой границы
+        TILE_SPREAD_RIGHT = 4,
+        TILE_SPREAD_UP = 8,
+        TILE_SPREAD_DOWN = 16
+    };
+
+    // Шаг одной плитки с записью в предыдущий слой; возвращает набор TileResult
+    uint8_t StepTile(uint32_t tile);
+
+    // Пробуждение плитки
+    void ActivateTile(int tileX, int tileY);
+
+    // Обнуление обоих слоёв плитки
+    void ZeroTile(uint32_t tile);
+
+    // Закраска плитки с добавлением её в m_shadedRect
+    void ShadeTile(Framebuffer& frame, uint32_t tile);
+
+    // Закраска прямоугольника ячеек [x0, x1) x [y0, y1)
+    void ShadeRect(Framebuffer& frame, int x0, int y0, int x1, int y1) const;
+
+    // Индекс ячейки с учётом рамки
+    size_t Index(int x, int y) const {
+        return static_cast<size_t>(y + 1) * m_stride + static_cast<size_t>(x + 1);
+    }
+
+private:
+    int m_width;                    // Ширина сетки в ячейках
+    int m_height;                   // Высота сетки в ячейках
+    size_t m_stride;                // Шаг строки с рамкой
+    float m_damping;                // Затухание за шаг
+    std::vector<float> m_current;   // Текущий слой
+    std::vector<float> m_previous;  // Предыдущий слой (перезаписывается новым состоянием)
+
+    int m_tilesX;                           // Плиток по горизонтали
+    int m_tilesY;                           // Плиток по вертикали
+    std::vector<TileState> m_tileState;     // Состояние каждой плитки
+    std::vector<uint32_t> m_activeTiles;    // Номера активных плиток
+    std::vector<uint8_t> m_tileResults;     // Итоги шага для m_activeTiles
+    std::vector<uint32_t> m_sleptTiles;     // Уснувшие плитки, ещё не очищенные в кадре
+    PixelRect m_shadedRect;                 // Ячейки, перерисованные последним Shade
+};
@@ -0,0 +1,180 @@
+#include "HeightFieldKernels.h"
+#include "CpuFeatures.h"
+
+#include <cmath>
+
+#if WATER_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Скалярная обработка диапазона [begin, end), общая для эталона и хвостов SIMD-ядер
+float StepRange(const float* up, const float* mid, const float* down, float* prev,
+                size_t begin, size_t end, float damping, float energy)
+{
+    for (size_t i = begin; i < end; ++i) {
+        float neighbours = (mid[i - 1] + mid[i + 1]) + (up[i] + down[i]);
+        float next = (neighbours * 0.5f - prev[i]) * damping;
+        prev[i] = next;
+
+        float magnitude = std::fabs(next);
+        energy = magnitude > energy ? magnitude : energy;
+    }
+    return energy;
+}
+
+#if WATER_X86
+
+// Максимум из элементов SIMD-регистра, выгруженного в память
+float MaxOfLanes(const float* lanes, size_t count)
+{
+    float result = lanes[0];
+    for (size_t i = 1; i < count; ++i) {
+        result = lanes[i] > result ? lanes[i] : result;
+    }
+    return result;
+}
+
+// SSE2: по 4 ячейки за итерацию
+WATER_TARGET("sse2")
+float StepHeightFieldRowSse2(const float* up, const float* mid, const float* down,
+                             float* prev, size_t count, float damping)
+{
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 damp = _mm_set1_ps(damping);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 energy = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 horizontal = _mm_add_ps(_mm_loadu_ps(mid + i - 1), _mm_loadu_ps(mid + i + 1));
+        __m128 vertical = _mm_add_ps(_mm_loadu_ps(up + i), _mm_loadu_ps(down + i));
+        __m128 next = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(horizontal, vertical), half), _mm_loadu_ps(prev + i));
+        next = _mm_mul_ps(next, damp);
+        _mm_storeu_ps(prev + i, next);
+        energy = _mm_max_ps(_mm_andnot_ps(signMask, next), energy);
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, energy);
+    return StepRange(up, mid, down, prev, i, count, damping, MaxOfLanes(lanes, 4));
+}
+
+// AVX2: по 8 ячеек за итерацию
+WATER_TARGET("avx2")
+float StepHeightFieldRowAvx2(const float* up, const float* mid, const float* down,
+                             float* prev, size_t count, float damping)
+{
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 damp = _mm256_set1_ps(damping);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 energy = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 horizontal = _mm256_add_ps(_mm256_loadu_ps(mid + i - 1), _mm256_loadu_ps(mid + i + 1));
+        __m256 vertical = _mm256_add_ps(_mm256_loadu_ps(up + i), _mm256_loadu_ps(down + i));
+        __m256 next = _mm256_sub_ps(_mm256_mul_ps(_mm256_add_ps(horizontal, vertical), half), _mm256_loadu_ps(prev + i));
+        next = _mm256_mul_ps(next, damp);
+        _mm256_storeu_ps(prev + i, next);
+        energy = _mm256_max_ps(_mm256_andnot_ps(signMask, next), energy);
+    }
+
+    float lanes[8];
+    _mm256_storeu_ps(lanes, energy);
+    return StepRange(up, mid, down, prev, i, count, damping, MaxOfLanes(lanes, 8));
+}
+
+// AVX-512: по 16 ячеек за итерацию
+WATER_TARGET("avx512f")
+float StepHeightFieldRowAvx512(const float* up, const float* mid, const float* down,
+                               float* prev, size_t count, float damping)
+{
+    const __m512 half = _mm512_set1_ps(0.5f);
+    const __m512 damp = _mm512_set1_ps(damping);
+    const __m512i absMask = _mm512_set1_epi32(0x7fffffff);
+    __m512 energy = _mm512_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 horizontal = _mm512_add_ps(_mm512_loadu_ps(mid + i - 1), _mm512_loadu_ps(mid + i + 1));
+        __m512 vertical = _mm512_add_ps(_mm512_loadu_ps(up + i), _mm512_loadu_ps(down + i));
+        __m512 next = _mm512_sub_ps(_mm512_mul_ps(_mm512_add_ps(horizontal, vertical), half), _mm512_loadu_ps(prev + i));
+        next = _mm512_mul_ps(next, damp);
+        _mm512_storeu_ps(prev + i, next);
+        // Маскированная форма с явным источником: у _mm512_max_ps в GCC 12 ложное
+        // предупреждение о неинициализированном регистре
+        __m512 magnitude = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(next), absMask));
+        energy = _mm512_mask_max_ps(energy, 0xFFFF, magnitude, energy);
+    }
+
+    float lanes[16];
+    _mm512_storeu_ps(lanes, energy);
+    return StepRange(up, mid, down, prev, i, count, damping, MaxOfLanes(lanes, 16));
+}
+
+#endif
+
+const HeightFieldKernel SCALAR_KERNEL = { "scalar", StepHeightFieldRowScalar };
+#if WATER_X86
+const HeightFieldKernel SSE2_KERNEL = { "sse2", StepHeightFieldRowSse2 };
+const HeightFieldKernel AVX2_KERNEL = { "avx2", StepHeightFieldRowAvx2 };
+const HeightFieldKernel AVX512_KERNEL = { "avx512", StepHeightFieldRowAvx512 };
+#endif
+
+// Выбор самого широкого поддерживаемого ядра
+const HeightFieldKernel& SelectHeightFieldKernel()
+{
+#if WATER_X86
+    const CpuFeatures& cpu = GetCpuFeatures();
+    if (cpu.avx512) {
+        return AVX512_KERNEL;
+    }
+    if (cpu.avx2) {
+        return AVX2_KERNEL;
+    }
+    if (cpu.sse2) {
+        return SSE2_KERNEL;
+    }
+#endif
+    return SCALAR_KERNEL;
+}
+
+} // namespace
+
+// Эталонная скалярная реализация
+float StepHeightFieldRowScalar(const float* up, const float* mid, const float* down,
+                               float* prev, size_t count, float damping)
+{
+    return StepRange(up, mid, down, prev, 0, count, damping, 0.0f);
+}
+
+// Лучшее ядро для текущего процессора
+const HeightFieldKernel& GetHeightFieldKernel()
+{
+    static const HeightFieldKernel& kernel = SelectHeightFieldKernel();
+    return kernel;
+}
+
+// Все ядра, поддерживаемые текущим процессором
+size_t GetAvailableHeightFieldKernels(const HeightFieldKernel** kernels, size_t maxKernels)
+{
+    size_t count = 0;
+    if (count < maxKernels) {
+        kernels[count++] = &SCALAR_KERNEL;
+    }
+#if WATER_X86
+    const CpuFeatures& cpu = GetCpuFeatures();
+    if (cpu.sse2 && count < maxKernels) {
+        kernels[count++] = &SSE2_KERNEL;
+    }
+    if (cpu.avx2 && count < maxKernels) {
+        kernels[count++] = &AVX2_KERNEL;
+    }
+    if (cpu.avx512 && count < maxKernels) {
+        kernels[count++] = &AVX512_KERNEL;
+    }
+#endif
+    return count;
+}
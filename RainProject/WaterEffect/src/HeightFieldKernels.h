@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+// Ядро шага разностной схемы волнового уравнения для одной строки сетки:
+// prev[i] = ((mid[i - 1] + mid[i + 1] + up[i] + down[i]) / 2 - prev[i]) * damping.
+// Новое состояние записывается на место предыдущего, поэтому хватает двух буферов.
+// Указатели указывают на первую внутреннюю ячейку строки; mid[-1] и mid[count] -
+// ячейки соседей или рамки, они читаются, но не изменяются.
+// Возвращает максимум модуля нового состояния строки (энергию для разреженных плиток)
+typedef float (*HeightFieldRowFn)(const float* up, const float* mid, const float* down,
+                                 float* prev, size_t count, float damping);
+
+struct HeightFieldKernel {
+    const char* name;       // Имя набора команд
+    HeightFieldRowFn stepRow;
+};
+
+// Эталонная скалярная реализация
+float StepHeightFieldRowScalar(const float* up, const float* mid, const float* down,
+                              float* prev, size_t count, float damping);
+
+// Лучшее ядро для текущего процессора (выбирается один раз по CPUID)
+const HeightFieldKernel& GetHeightFieldKernel();
+
+// Все ядра, поддерживаемые текущим процессором, от скалярного к самому широкому.
+// Возвращает их количество
+size_t GetAvailableHeightFieldKernels(const HeightFieldKernel** kernels, size_t maxKernels);
@@ -0,0 +1,187 @@
+#include "InputTrace.h"
+
+#include <cstring>
+
+// Конструктор
+TraceWriter::TraceWriter() :
+    m_file(nullptr),
+    m_used(0),
+    m_lastMicros(0)
+{
+}
+
+// Деструктор
+TraceWriter::~TraceWriter()
+{
+    Close();
+}
+
+// Создание файла и запись заголовка
+bool TraceWriter::Open(const char* path, const TraceHeader& header)
+{
+    Close();
+
+    m_file = std::fopen(path, "wb");
+    if (!m_file) {
+        return false;
+    }
+
+    TraceHeader written = header;
+    std::memcpy(written.magic, "WTRC", 4);
+    written.version = TRACE_VERSION;
+    if (std::fwrite(&written, sizeof(written), 1, m_file) != 1) {
+        Close();
+        return false;
+    }
+
+    m_buffer.resize(BUFFER_SIZE);
+    m_used = 0;
+    m_lastMicros = 0;
+    return true;
+}
+
+// Сброс буфера и закрытие файла
+void TraceWriter::Close()
+{
+    if (!m_file) {
+        return;
+    }
+
+    Flush();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+// Запись тика анимации
+void TraceWriter::WriteTick(double time)
+{
+    if (!m_file) {
+        return;
+    }
+    PutHeader(TraceEventType::Tick, SpawnSource::Replay, time);
+}
+
+// Запись появления волны
+void TraceWriter::WriteSpawn(double time, float x, float y, SpawnSource source)
+{
+    if (!m_file) {
+        return;
+    }
+    PutHeader(TraceEventType::Spawn, source, time);
+    Put(&x, sizeof(x));
+    Put(&y, sizeof(y));
+}
+
+// Запись накопленных событий в файл
+void TraceWriter::Flush()
+{
+    if (m_file && m_used > 0) {
+        std::fwrite(m_buffer.data(), 1, m_used, m_file);
+        std::fflush(m_file);
+        m_used = 0;
+    }
+}
+
+// Заполнение общей части записи
+void TraceWriter::PutHeader(TraceEventType type, SpawnSource source, double time)
+{
+    // Время монотонно: событие из прошлого записывается с нулевым приращением
+    uint64_t micros = time > 0.0 ? static_cast<uint64_t>(time * 1e6 + 0.5) : 0;
+    micros = micros > m_lastMicros ? micros : m_lastMicros;
+
+    // Паузы длиннее ~71 минуты разбиваются пустыми тиками, чтобы приращение влезло в 32 бита
+    while (micros - m_lastMicros > UINT32_MAX) {
+        TraceRecordHeader gap = { static_cast<uint8_t>(TraceEventType::Tick), 0, 0, UINT32_MAX };
+        Put(&gap, sizeof(gap));
+        m_lastMicros += UINT32_MAX;
+    }
+
+    TraceRecordHeader record = {
+        static_cast<uint8_t>(type),
+        static_cast<uint8_t>(source),
+        0,
+        static_cast<uint32_t>(micros - m_lastMicros)
+    };
+    m_lastMicros = micros;
+    Put(&record, sizeof(record));
+}
+
+// Добавление байтов в буфер со сбросом при заполнении
+void TraceWriter::Put(const void* data, size_t size)
+{
+    if (m_used + size > m_buffer.size()) {
+        Flush();
+    }
+    std::memcpy(m_buffer.data() + m_used, data, size);
+    m_used += size;
+}
+
+// Конструктор
+TraceReader::TraceReader() :
+    m_file(nullptr),
+    m_header(),
+    m_micros(0)
+{
+}
+
+// Деструктор
+TraceReader::~TraceReader()
+{
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+// Открытие файла и проверка заголовка
+bool TraceReader::Open(const char* path)
+{
+    if (m_file) {
+        std::fclose(m_file);
+    }
+
+    m_file = std::fopen(path, "rb");
+    if (!m_file) {
+        return false;
+    }
+
+    m_micros = 0;
+    if (std::fread(&m_header, sizeof(m_header), 1, m_file) != 1 ||
+        std::memcmp(m_header.magic, "WTRC", 4) != 0 ||
+        m_header.version != TRACE_VERSION) {
+        std::fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// Чтение следующего события
+bool TraceReader::Next(TraceEvent& event)
+{
+    if (!m_file) {
+        return false;
+    }
+
+    TraceRecordHeader record;
+    if (std::fread(&record, sizeof(record), 1, m_file) != 1) {
+        return false;
+    }
+
+    m_micros += record.deltaMicros;
+    event.type = static_cast<TraceEventType>(record.type);
+    event.source = static_cast<SpawnSource>(record.source);
+    event.time = static_cast<double>(m_micros) * 1e-6;
+    event.x = 0.0f;
+    event.y = 0.0f;
+
+    if (event.type == TraceEventType::Spawn) {
+        float position[2];
+        if (std::fread(position, sizeof(position), 1, m_file) != 1) {
+            return false;
+        }
+        event.x = position[0];
+        event.y = position[1];
+        return true;
+    }
+    return event.type == TraceEventType::Tick;
+}
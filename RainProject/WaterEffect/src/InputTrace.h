@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Двоичная трасса входных событий эффекта: появления волн и тики анимации
+// с метками времени. Трасса, записанная на рабочей машине, воспроизводится
+// инструментом water_replay как повторяемый замер.
+//
+// Формат (little-endian):
+//   заголовок TraceHeader;
+//   далее записи переменной длины: TraceRecordHeader, а для появления волны
+//   ещё два float - координаты X и Y в пикселях экрана.
+// Время записи хранится приращением в микросекундах от предыдущей записи,
+// поэтому тик занимает 8 байт, а появление волны - 16
+
+// Вид события трассы
+enum class TraceEventType : uint8_t {
+    Tick = 1,       // Срабатывание таймера анимации (обновление и кадр)
+    Spawn = 2       // Появление волны
+};
+
+// Источник появления волны
+enum class SpawnSource : uint8_t {
+    Click = 0,      // WM_LBUTTONDOWN
+    RawInput = 1,   // WM_INPUT
+    TestTimer = 2,  // TEST_WAVE_TIMER_ID
+    Replay = 3      // Программное создание (замеры, воспроизведение)
+};
+
+#pragma pack(push, 1)
+
+// Заголовок файла трассы
+struct TraceHeader {
+    char magic[4];              // "WTRC"
+    uint32_t version;           // TRACE_VERSION
+    uint32_t screenWidth;       // Размер экрана при записи
+    uint32_t screenHeight;
+    uint8_t waveMode;           // Значение WaveMode при записи
+    uint8_t cellSize;           // Размер ячейки поля высот
+    uint16_t reserved;
+};
+
+// Общая часть записи
+struct TraceRecordHeader {
+    uint8_t type;               // TraceEventType
+    uint8_t source;             // SpawnSource (для появления волны)
+    uint16_t reserved;
+    uint32_t deltaMicros;       // Время от предыдущей записи, микросекунды
+};
+
+#pragma pack(pop)
+
+static constexpr uint32_t TRACE_VERSION = 1;
+
+// Событие трассы в развёрнутом виде
+struct TraceEvent {
+    TraceEventType type;
+    SpawnSource source;
+    double time;                // Секунды от начала записи
+    float x;                    // Координаты появления волны
+    float y;
+};
+
+// Запись трассы в файл. События копятся в буфере фиксированного размера
+// и сбрасываются одним fwrite, когда буфер заполнен, поэтому запись события
+// не выделяет память и не обращается к файлу
+class TraceWriter {
+public:
+    TraceWriter();
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    // Создание файла и запись заголовка
+    bool Open(const char* path, const TraceHeader& header);
+
+    // Сброс буфера и закрытие файла
+    void Close();
+
+    bool IsOpen() const { return m_file != nullptr; }
+
+    // Запись тика анимации в момент time (секунды)
+    void WriteTick(double time);
+
+    // Запись появления волны
+    void WriteSpawn(double time, float x, float y, SpawnSource source);
+
+    // Запись накопленных событий в файл
+    void Flush();
+
+private:
+    // Заполнение общей части записи с переводом времени в приращение
+    void PutHeader(TraceEventType type, SpawnSource source, double time);
+    void Put(const void* data, size_t size);
+
+private:
+    FILE* m_file;                   // Файл трассы
+    std::vector<uint8_t> m_buffer;  // Буфер несброшенных записей
+    size_t m_used;                  // Занято байт в буфере
+    uint64_t m_lastMicros;          // Время предыдущей записи, микросекунды
+
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+};
+
+// Чтение трассы из файла
+class TraceReader {
+public:
+    TraceReader();
+    ~TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    // Открытие файла и проверка заголовка
+    bool Open(const char* path);
+
+    const TraceHeader& Header() const { return m_header; }
+
+    // Чтение следующего события; false в конце файла или на повреждённой записи
+    bool Next(TraceEvent& event);
+
+private:
+    FILE* m_file;               // Файл трассы
+    TraceHeader m_header;       // Прочитанный заголовок
+    uint64_t m_micros;          // Время последнего прочитанного события
+};
@@ -0,0 +1,84 @@
+#include "LatencyHistogram.h"
+
+#include <cmath>
+
+// Конструктор
+LatencyHistogram::LatencyHistogram()
+{
+    Reset();
+}
+
+// Сброс всех счётчиков
+void LatencyHistogram::Reset()
+{
+    m_counts.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_min = UINT64_MAX;
+    m_max = 0;
+}
+
+// Добавление счётчиков другой гистограммы
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    for (size_t i = 0; i < COUNTS_LENGTH; ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = other.m_min < m_min ? other.m_min : m_min;
+    m_max = other.m_max > m_max ? other.m_max : m_max;
+}
+
+// Наибольшее значение, попадающее в счётчик
+uint64_t LatencyHistogram::HighestValueAt(size_t index)
+{
+    // Обратное к IndexOf: корзина 0 занимает две половины, остальные - по одной
+    uint64_t bucket = index >> (SUB_BUCKET_BITS - 1);
+    uint64_t subBucket = (index & (SUB_BUCKET_HALF_COUNT - 1)) + SUB_BUCKET_HALF_COUNT;
+    if (bucket == 0) {
+        subBucket -= SUB_BUCKET_HALF_COUNT;
+    } else {
+        --bucket;
+    }
+    return ((subBucket + 1) << bucket) - 1;
+}
+
+// Значение, не превышенное percent процентами записей
+uint64_t LatencyHistogram::Percentile(double percent) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+
+    percent = percent < 0.0 ? 0.0 : (percent > 100.0 ? 100.0 : percent);
+    uint64_t target = static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(m_count)));
+    target = target > 0 ? target : 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < COUNTS_LENGTH; ++i) {
+        seen += m_counts[i];
+        if (seen >= target) {
+            // Граница корзины не выходит за точные минимум и максимум
+            uint64_t value = HighestValueAt(i);
+            value = value < m_max ? value : m_max;
+            return value > m_min ? value : m_min;
+        }
+    }
+    return m_max;
+}
+
+// Сводка для отчёта
+LatencyHistogram::Summary LatencyHistogram::Summarize() const
+{
+    Summary summary = {};
+    summary.count = m_count;
+    summary.mean = Mean();
+    summary.min = Min();
+    summary.p50 = Percentile(50.0);
+    summary.p90 = Percentile(90.0);
+    summary.p99 = Percentile(99.0);
+    summary.p999 = Percentile(99.9);
+    summary.max = m_max;
+    return summary;
+}
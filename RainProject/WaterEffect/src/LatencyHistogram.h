@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Гистограмма задержек с большим динамическим диапазоном (по схеме HdrHistogram).
+// Значения от 1 нс до MAX_VALUE раскладываются по корзинам: диапазон каждой степени
+// двойки делится на SUB_BUCKET_HALF_COUNT равных частей, поэтому относительная
+// погрешность любого процентиля не больше 1/SUB_BUCKET_HALF_COUNT (менее 1%).
+// Счётчики лежат в массиве фиксированного размера внутри объекта: запись
+// не выделяет память и стоит нескольких арифметических операций
+class LatencyHistogram {
+public:
+    // Сводка для отчёта: значения в наносекундах
+    struct Summary {
+        uint64_t count;
+        double mean;
+        uint64_t min;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t p999;
+        uint64_t max;
+    };
+
+    LatencyHistogram();
+
+    // Запись одного значения (наносекунды); большие MAX_VALUE учитываются как MAX_VALUE
+    void Record(uint64_t value);
+
+    // Сброс всех счётчиков
+    void Reset();
+
+    // Добавление счётчиков другой гистограммы
+    void Merge(const LatencyHistogram& other);
+
+    uint64_t Count() const { return m_count; }
+    uint64_t Min() const { return m_count ? m_min : 0; }
+    uint64_t Max() const { return m_max; }
+    double Mean() const { return m_count ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0.0; }
+
+    // Значение, не превышенное percent процентами записей (0..100)
+    uint64_t Percentile(double percent) const;
+
+    // Сводка: среднее, минимум, p50/p90/p99/p99.9 и максимум
+    Summary Summarize() const;
+
+    // Точность: корзин на половину степени двойки
+    static constexpr unsigned SUB_BUCKET_BITS = 8;
+    static constexpr uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr uint64_t SUB_BUCKET_HALF_COUNT = SUB_BUCKET_COUNT / 2;
+
+    // Верхняя граница диапазона: около 18 минут в наносекундах
+    static constexpr unsigned MAX_VALUE_BITS = 40;
+    static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+
+    // Число счётчиков
+    static constexpr size_t COUNTS_LENGTH = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2) * SUB_BUCKET_HALF_COUNT;
+
+private:
+    // Номер счётчика для значения
+    static size_t IndexOf(uint64_t value);
+
+    // Наибольшее значение, попадающее в счётчик с номером index
+    static uint64_t HighestValueAt(size_t index);
+
+private:
+    std::array<uint64_t, COUNTS_LENGTH> m_counts;
+    uint64_t m_count;
+    uint64_t m_sum;
+    uint64_t m_min;
+    uint64_t m_max;
+};
+
+// Номер счётчика для значения
+inline size_t LatencyHistogram::IndexOf(uint64_t value)
+{
+    // Номер старшего бита; младшие SUB_BUCKET_BITS бит всегда попадают в корзину 0
+    uint64_t masked = value | (SUB_BUCKET_COUNT - 1);
+#if defined(_MSC_VER)
+    unsigned long highestBit = 0;
+    _BitScanReverse64(&highestBit, masked);
+#else
+    unsigned highestBit = 63u - static_cast<unsigned>(__builtin_clzll(masked));
+#endif
+    unsigned bucket = static_cast<unsigned>(highestBit) - (SUB_BUCKET_BITS - 1);
+    uint64_t subBucket = value >> bucket;
+    return static_cast<size_t>(((uint64_t(bucket) + 1) << (SUB_BUCKET_BITS - 1)) + subBucket - SUB_BUCKET_HALF_COUNT);
+}
+
+// Запись одного значения
+inline void LatencyHistogram::Record(uint64_t value)
+{
+    value = value < MAX_VALUE ? value : MAX_VALUE;
+    ++m_counts[IndexOf(value)];
+    ++m_count;
+    m_sum += value;
+    m_min = value < m_min ? value : m_min;
+    m_max = value > m_max ? value : m_max;
+}
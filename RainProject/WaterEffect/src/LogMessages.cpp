@@ -0,0 +1,184 @@
+#include "LogMessages.h"
+
+#include <cstdio>
+
+namespace {
+
+// Чтение записи журнала по байтам с проверкой границ
+class PayloadReader {
+public:
+    PayloadReader(const uint8_t* data, size_t length) : m_data(data), m_end(data + length) {}
+
+    bool Read(void* value, size_t size) {
+        if (static_cast<size_t>(m_end - m_data) < size) {
+            return false;
+        }
+        std::memcpy(value, m_data, size);
+        m_data += size;
+        return true;
+    }
+
+    bool AtEnd() const { return m_data == m_end; }
+
+private:
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+};
+
+// Добавление текста к результату с обрезкой по размеру буфера
+void Append(char* out, size_t outSize, size_t& used, const char* text, size_t length)
+{
+    if (used + 1 >= outSize) {
+        return;
+    }
+    size_t room = outSize - 1 - used;
+    length = length < room ? length : room;
+    std::memcpy(out + used, text, length);
+    used += length;
+    out[used] = '\0';
+}
+
+// Подстановка одного аргумента по спецификатору формата.
+// flags - флаги, ширина и точность из исходного спецификатора, conversion - символ преобразования
+bool AppendArgument(PayloadReader& reader, const char* flags, size_t flagsLength, char conversion,
+                    char* out, size_t outSize, size_t& used)
+{
+    uint8_t tag = 0;
+    if (!reader.Read(&tag, sizeof(tag))) {
+        return false;
+    }
+
+    char spec[32];
+    char text[128];
+    int length = 0;
+    flagsLength = flagsLength < 16 ? flagsLength : 16;
+
+    switch (static_cast<LogArgType>(tag)) {
+        case LogArgType::Int32:
+        case LogArgType::UInt32: {
+            uint32_t raw = 0;
+            if (!reader.Read(&raw, sizeof(raw))) {
+                return false;
+            }
+            bool isSigned = static_cast<LogArgType>(tag) == LogArgType::Int32 && (conversion == 'd' || conversion == 'i');
+            char type = (conversion == 'x' || conversion == 'X' || conversion == 'o' || conversion == 'u' ||
+                         conversion == 'c') ? conversion : (isSigned ? 'd' : 'u');
+            std::snprintf(spec, sizeof(spec), "%%%.*s%c", static_cast<int>(flagsLength), flags, type);
+            length = isSigned ? std::snprintf(text, sizeof(text), spec, static_cast<int>(static_cast<int32_t>(raw)))
+                              : std::snprintf(text, sizeof(text), spec, static_cast<unsigned int>(raw));
+            break;
+        }
+        case LogArgType::Int64:
+        case LogArgType::UInt64: {
+            uint64_t raw = 0;
+            if (!reader.Read(&raw, sizeof(raw))) {
+                return false;
+            }
+            bool isSigned = static_cast<LogArgType>(tag) == LogArgType::Int64 && (conversion == 'd' || conversion == 'i');
+            char type = (conversion == 'x' || conversion == 'X' || conversion == 'o' || conversion == 'u')
+                            ? conversion : (isSigned ? 'd' : 'u');
+            std::snprintf(spec, sizeof(spec), "%%%.*sll%c", static_cast<int>(flagsLength), flags, type);
+            length = isSigned ? std::snprintf(text, sizeof(text), spec, static_cast<long long>(raw))
+                              : std::snprintf(text, sizeof(text), spec, static_cast<unsigned long long>(raw));
+            break;
+        }
+        case LogArgType::Float64: {
+            double raw = 0.0;
+            if (!reader.Read(&raw, sizeof(raw))) {
+                return false;
+            }
+            char type = std::strchr("fFeEgGaA", conversion) ? conversion : 'g';
+            std::snprintf(spec, sizeof(spec), "%%%.*s%c", static_cast<int>(flagsLength), flags, type);
+            length = std::snprintf(text, sizeof(text), spec, raw);
+            break;
+        }
+        case LogArgType::String: {
+            uint8_t stringLength = 0;
+            char value[256];
+            if (!reader.Read(&stringLength, sizeof(stringLength)) || !reader.Read(value, stringLength)) {
+                return false;
+            }
+            Append(out, outSize, used, value, stringLength);
+            return true;
+        }
+        default:
+            return false;
+    }
+
+    if (length > 0) {
+        Append(out, outSize, used, text, static_cast<size_t>(length) < sizeof(text) ? static_cast<size_t>(length)
+                                                                                      : sizeof(text) - 1);
+    }
+    return true;
+}
+
+} // namespace
+
+// Имя уровня
+const char* LogLevelName(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::Trace: return "trace";
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info: return "info";
+        case LogLevel::Warning: return "warning";
+        case LogLevel::Error: return "error";
+    }
+    return "?";
+}
+
+// Сборка текста записи по строке формата из таблицы
+bool FormatLogEvent(const uint8_t* payload, size_t length, char* out, size_t outSize, size_t& textLength)
+{
+    textLength = 0;
+    if (outSize == 0) {
+        return false;
+    }
+    out[0] = '\0';
+
+    PayloadReader reader(payload, length);
+    uint16_t id = 0;
+    if (!reader.Read(&id, sizeof(id)) || id >= static_cast<uint16_t>(LogMessageId::Count)) {
+        return false;
+    }
+
+    size_t used = 0;
+    const char* format = LOG_MESSAGES[id].format;
+    while (*format) {
+        const char* percent = std::strchr(format, '%');
+        if (!percent) {
+            Append(out, outSize, used, format, std::strlen(format));
+            break;
+        }
+
+        Append(out, outSize, used, format, static_cast<size_t>(percent - format));
+        if (percent[1] == '%') {
+            Append(out, outSize, used, "%", 1);
+            format = percent + 2;
+            continue;
+        }
+
+        // Флаги, ширина и точность сохраняются, модификаторы длины заменяются по типу значения
+        const char* flags = percent + 1;
+        const char* cursor = flags;
+        while (*cursor && std::strchr("-+ #0123456789.", *cursor)) {
+            ++cursor;
+        }
+        size_t flagsLength = static_cast<size_t>(cursor - flags);
+        while (*cursor && std::strchr("hlLqjzt", *cursor)) {
+            ++cursor;
+        }
+        if (!*cursor) {
+            return false;
+        }
+
+        if (!AppendArgument(reader, flags, flagsLength, *cursor, out, outSize, used)) {
+            return false;
+        }
+        format = cursor + 1;
+    }
+
+    // Лишние аргументы означают, что запись не соответствует таблице
+    textLength = used;
+    return reader.AtEnd();
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Таблица сообщений журнала со статическими идентификаторами.
+// Вызывающий поток кладёт в журнал только идентификатор и сырые значения аргументов,
+// а текст по строке формата собирается позже: фоновым потоком журнала
+// (текстовый файл) или декодером water_logdecode (двоичный файл).
+// Идентификатор - порядковый номер в таблице, поэтому новые сообщения
+// добавляются только в конец, а старые не удаляются
+#define WATER_LOG_MESSAGES(X)                                                                       \
+    X(FreeText,                   Info,    "%s")                                                    \
+    X(RecordsLost,                Warning, "Журнал: потеряно записей: %llu")                        \
+    X(EffectInitialized,          Info,    "WaterEffect инициализирован")                           \
+    X(RawInputRegistrationFailed, Warning, "Не удалось зарегистрировать устройство Raw Input. Код ошибки: %lu") \
+    X(RawInputRegistered,         Info,    "Устройство Raw Input зарегистрировано успешно")         \
+    X(AppStarted,                 Info,    "Приложение запущено и окно показано")                   \
+    X(WindowCreationFailed,       Error,   "Не удалось создать окно. Код ошибки: %lu")              \
+    X(WindowCreated,              Info,    "Окно создано успешно")                                  \
+    X(UpdateWaves,                Trace,   "Update: волн = %zu")                                    \
+    X(WavesRemoved,               Debug,   "Волн удалено: %zu")                                     \
+    X(ActiveTiles,                Trace,   "Активных плиток поля высот: %zu из %zu")                \
+    X(InvalidateCalled,           Trace,   "InvalidateRect вызван")                                 \
+    X(RenderBegin,                Trace,   "Render: начало отрисовки")                              \
+    X(RenderWaves,                Trace,   "Отрисовка %zu волн")                                    \
+    X(EndDrawSucceeded,           Trace,   "EndDraw: успешно")                                      \
+    X(EndDrawFailed,              Error,   "EndDraw: ошибка 0x%08lx")                               \
+    X(WaveCreated,                Debug,   "Создание волны в точке: X=%g, Y=%g")                    \
+    X(MessageReceived,            Trace,   "Получено сообщение: %u%s")                              \
+    X(PaintDone,                  Trace,   "Выполнена отрисовка")                                   \
+    X(ClickMessage,               Debug,   "WM_LBUTTONDOWN: x=%d, y=%d")                            \
+    X(RawInputClick,              Debug,   "WM_INPUT: Клик мыши в точке x=%ld, y=%ld")              \
+    X(AnimationTimer,             Trace,   "Обновление анимации по таймеру")                        \
+    X(TestWaveTimer,              Debug,   "Создание тестовой волны по таймеру x=%g, y=%g")         \
+    X(WindowDestroyed,            Info,    "Окно уничтожено")                                       \
+    X(DefaultMessage,             Trace,   "Сообщение обработано по умолчанию")                     \
+    X(MessagesSummary,            Info,    "%s x %llu за последние %.0f с, записано %llu")          \
+    X(FrameStatsReport,           Info,    "%s: n %llu, p50 %.1f мкс, p99 %.1f мкс, p99.9 %.1f мкс, max %.1f мкс") \
+    X(FrameAllocationsReport,     Info,    "Выделения памяти: кадров %llu, с выделениями %llu, всего %llu, максимум за кадр %llu") \
+    X(FramePixelsReport,          Info,    "Перерисовка: кадров %llu, без перерисовки %llu, в среднем %.0f пикселей за кадр (%.2f%% экрана), максимум %llu") \
+    X(DirtyRegion,                Trace,   "Область перерисовки: %d, %d - %d, %d")
+
+// Уровень важности записи журнала
+enum class LogLevel : int {
+    Trace = 0,      // Каждое сообщение окна и каждый кадр
+    Debug = 1,      // Отдельные события: клики, появление и удаление волн
+    Info = 2,       // Запуск, инициализация, завершение
+    Warning = 3,    // Нештатные, но не мешающие работе ситуации
+    Error = 4       // Сбои
+};
+
+// Имя уровня (trace, debug, info, warning, error)
+const char* LogLevelName(LogLevel level);
+
+// Идентификатор сообщения
+enum class LogMessageId : uint16_t {
+#define WATER_LOG_MESSAGE_ID(name, level, format) name,
+    WATER_LOG_MESSAGES(WATER_LOG_MESSAGE_ID)
+#undef WATER_LOG_MESSAGE_ID
+    Count
+};
+
+// Описание сообщения
+struct LogMessageInfo {
+    const char* name;
+    LogLevel level;
+    const char* format;
+};
+
+inline constexpr LogMessageInfo LOG_MESSAGES[] = {
+#define WATER_LOG_MESSAGE_INFO(name, level, format) { #name, LogLevel::level, format },
+    WATER_LOG_MESSAGES(WATER_LOG_MESSAGE_INFO)
+#undef WATER_LOG_MESSAGE_INFO
+};
+
+// Уровень сообщения (на этапе компиляции)
+constexpr LogLevel LogMessageLevel(LogMessageId id)
+{
+    return LOG_MESSAGES[static_cast<size_t>(id)].level;
+}
+
+// Число подстановок в строке формата (%% не считается)
+constexpr size_t CountFormatArguments(const char* format)
+{
+    size_t count = 0;
+    for (size_t i = 0; format[i] != '\0'; ++i) {
+        if (format[i] == '%') {
+            if (format[i + 1] == '%') {
+                ++i;
+            } else {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+// Тип значения аргумента в записи
+enum class LogArgType : uint8_t {
+    Int32 = 1,
+    UInt32 = 2,
+    Int64 = 3,
+    UInt64 = 4,
+    Float64 = 5,
+    String = 6      // Длина (1 байт, до 255) и байты строки без завершающего нуля
+};
+
+// Максимальная длина строкового аргумента события
+static constexpr size_t LOG_MAX_STRING_ARG = 63;
+
+// Место, которое займёт аргумент в записи
+template <typename T>
+constexpr size_t LogArgSize()
+{
+    if constexpr (std::is_floating_point<T>::value) {
+        return 1 + sizeof(double);
+    } else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+        return 1 + (sizeof(T) <= 4 ? 4 : 8);
+    } else {
+        return 1 + 1 + LOG_MAX_STRING_ARG;
+    }
+}
+
+// Запись одного аргумента с тегом типа
+template <typename T>
+uint8_t* EncodeLogArg(uint8_t* cursor, T value)
+{
+    if constexpr (std::is_floating_point<T>::value) {
+        double raw = static_cast<double>(value);
+        *cursor++ = static_cast<uint8_t>(LogArgType::Float64);
+        std::memcpy(cursor, &raw, sizeof(raw));
+        return cursor + sizeof(raw);
+    } else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+        if constexpr (sizeof(T) <= 4) {
+            uint32_t raw = static_cast<uint32_t>(value);
+            *cursor++ = static_cast<uint8_t>(std::is_signed<T>::value ? LogArgType::Int32 : LogArgType::UInt32);
+            std::memcpy(cursor, &raw, sizeof(raw));
+            return cursor + sizeof(raw);
+        } else {
+            uint64_t raw = static_cast<uint64_t>(value);
+            *cursor++ = static_cast<uint8_t>(std::is_signed<T>::value ? LogArgType::Int64 : LogArgType::UInt64);
+            std::memcpy(cursor, &raw, sizeof(raw));
+            return cursor + sizeof(raw);
+        }
+    } else {
+        static_assert(std::is_convertible<T, const char*>::value, "Неподдерживаемый тип аргумента журнала");
+        const char* text = value ? value : "";
+        size_t length = std::strlen(text);
+        length = length < LOG_MAX_STRING_ARG ? length : LOG_MAX_STRING_ARG;
+        *cursor++ = static_cast<uint8_t>(LogArgType::String);
+        *cursor++ = static_cast<uint8_t>(length);
+        std::memcpy(cursor, text, length);
+        return cursor + length;
+    }
+}
+
+// Запись идентификатора сообщения и всех аргументов.
+// Возвращает указатель за последним записанным байтом
+template <typename... Args>
+uint8_t* EncodeLogEvent(uint8_t* cursor, LogMessageId id, Args... args)
+{
+    uint16_t raw = static_cast<uint16_t>(id);
+    std::memcpy(cursor, &raw, sizeof(raw));
+    cursor += sizeof(raw);
+    ((cursor = EncodeLogArg(cursor, args)), ...);
+    return cursor;
+}
+
+// Сборка текста записи (идентификатор + аргументы) по строке формата из таблицы.
+// textLength - длина текста без завершающего нуля; false, если запись повреждена
+bool FormatLogEvent(const uint8_t* payload, size_t length, char* out, size_t outSize, size_t& textLength);
+
+// Двоичный файл журнала.
+// Заголовок LogFileHeader, затем записи: длина полезной нагрузки (uint16),
+// время от открытия журнала в наносекундах (uint64) и полезная нагрузка:
+// идентификатор сообщения (uint16) и аргументы с тегами LogArgType
+#pragma pack(push, 1)
+struct LogFileHeader {
+    char magic[4];              // "WLOG"
+    uint32_t version;           // LOG_FILE_VERSION
+    uint32_t messageCount;      // Число сообщений в таблице при записи
+};
+
+struct LogRecordHeader {
+    uint16_t length;            // Длина полезной нагрузки
+    uint64_t timeNs;            // Время от открытия журнала, наносекунды
+};
+#pragma pack(pop)
+
+static constexpr uint32_t LOG_FILE_VERSION = 1;
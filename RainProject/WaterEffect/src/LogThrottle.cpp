@@ -0,0 +1,50 @@
+#include "LogThrottle.h"
+
+#include <algorithm>
+
+// Конструктор
+LogThrottle::LogThrottle(size_t categoryCount) :
+    m_categories(categoryCount, Category{ Limit{ 0.0, 0.0, 1 }, 0.0, 0.0, 0, 0, 0 }),
+    m_windowStart(-1.0)
+{
+}
+
+// Ограничение категории
+void LogThrottle::SetLimit(size_t category, const Limit& limit)
+{
+    Category& state = m_categories[category];
+    state.limit = limit;
+    state.tokens = limit.burst;
+    state.overflow = 0;
+}
+
+// Решение по очередной записи категории
+bool LogThrottle::Allow(size_t category, double now)
+{
+    if (m_windowStart < 0.0) {
+        m_windowStart = now;
+    }
+
+    Category& state = m_categories[category];
+    ++state.seen;
+
+    bool allowed = true;
+    if (state.limit.ratePerSecond > 0.0) {
+        // Пополнение ведра за прошедшее время
+        double elapsed = std::max(0.0, now - state.lastRefill);
+        state.tokens = std::min(state.limit.burst, state.tokens + elapsed * state.limit.ratePerSecond);
+        state.lastRefill = now;
+
+        if (state.tokens >= 1.0) {
+            state.tokens -= 1.0;
+            state.overflow = 0;
+        } else {
+            // Сверх ведра проходит каждая N-я запись, чтобы поток был виден и под нагрузкой
+            ++state.overflow;
+            allowed = state.limit.sampleEvery > 0 && state.overflow % state.limit.sampleEvery == 0;
+        }
+    }
+
+    state.logged += allowed ? 1 : 0;
+    return allowed;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ограничение частоты записей журнала по категориям.
+// У каждой категории своё ведро маркеров: записи проходят, пока есть маркеры
+// (скорость ratePerSecond, запас burst), а из остальных проходит каждая sampleEvery-я.
+// Отброшенные записи считаются, и раз в SUMMARY_INTERVAL секунд по категориям,
+// где что-то было отброшено, выдаётся сводка. Редкие категории (ratePerSecond <= 0)
+// не ограничиваются вовсе
+class LogThrottle {
+public:
+    // Ограничение одной категории
+    struct Limit {
+        double ratePerSecond;   // Пополнение ведра, записей в секунду (<= 0 - без ограничения)
+        double burst;           // Ёмкость ведра
+        uint32_t sampleEvery;   // Из записей сверх ведра проходит каждая N-я (0 - ни одной)
+    };
+
+    // Итог категории за окно сводки
+    struct Summary {
+        size_t category;        // Номер категории
+        uint64_t seen;          // Записей за окно
+        uint64_t logged;        // Из них пропущено в журнал
+        double interval;        // Длина окна, секунды
+    };
+
+    explicit LogThrottle(size_t categoryCount);
+
+    // Ограничение категории (по умолчанию - без ограничения)
+    void SetLimit(size_t category, const Limit& limit);
+
+    // Решение по очередной записи категории в момент now (секунды): true - записать
+    bool Allow(size_t category, double now);
+
+    // Сводка за истёкшее окно: visit(const Summary&) для каждой категории,
+    // где были отброшенные записи. Окно начинается с первого вызова Allow
+    template <typename Visitor>
+    void Summarize(double now, Visitor&& visit);
+
+    // Длина окна сводки, секунды
+    static constexpr double SUMMARY_INTERVAL = 10.0;
+
+private:
+    // Состояние категории
+    struct Category {
+        Limit limit;
+        double tokens;          // Маркеров в ведре
+        double lastRefill;      // Время последнего пополнения
+        uint64_t overflow;      // Записей сверх ведра подряд (для выборки)
+        uint64_t seen;          // Записей за окно сводки
+        uint64_t logged;        // Пропущено за окно сводки
+    };
+
+    std::vector<Category> m_categories;
+    double m_windowStart;       // Начало окна сводки (< 0 - ещё не начато)
+};
+
+// Сводка за истёкшее окно
+template <typename Visitor>
+void LogThrottle::Summarize(double now, Visitor&& visit)
+{
+    if (m_windowStart < 0.0 || now - m_windowStart < SUMMARY_INTERVAL) {
+        return;
+    }
+
+    double interval = now - m_windowStart;
+    for (size_t i = 0; i < m_categories.size(); ++i) {
+        Category& category = m_categories[i];
+        if (category.seen > category.logged) {
+            visit(Summary{ i, category.seen, category.logged, interval });
+        }
+        category.seen = 0;
+        category.logged = 0;
+    }
+    m_windowStart = now;
+}
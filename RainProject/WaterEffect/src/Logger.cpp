@@ -0,0 +1,427 @@
+#include "Logger.h"
+#include "TraceZones.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+// Наибольшая пауза фонового потока, когда очередь пуста
+constexpr std::chrono::milliseconds IDLE_SLEEP(5);
+
+// Место в пачке, которого хватает на любую запись в любом формате
+constexpr size_t RECORD_ROOM = 512;
+
+// Заголовок двоичного журнала для текущей таблицы сообщений
+LogFileHeader MakeLogFileHeader()
+{
+    LogFileHeader header = {};
+    std::memcpy(header.magic, "WLOG", 4);
+    header.version = LOG_FILE_VERSION;
+    header.messageCount = static_cast<uint32_t>(LogMessageId::Count);
+    return header;
+}
+
+} // namespace
+
+// Конструктор
+Logger::Logger() :
+    m_slots(new Slot[QUEUE_CAPACITY]),
+    m_enqueuePosition(0),
+    m_dequeuePosition(0),
+    m_completed(0),
+    m_file(nullptr),
+    m_format(LogFormat::Text),
+    m_batchUsed(0),
+    m_reportedDropped(0),
+    m_running(false),
+    m_stopping(false),
+    m_wakeRequested(false),
+    m_level(static_cast<int>(LogLevel::Trace)),
+    m_written(0),
+    m_dropped(0),
+    m_batches(0),
+    m_rotations(0)
+{
+    static_assert((QUEUE_CAPACITY & (QUEUE_CAPACITY - 1)) == 0, "Ёмкость очереди должна быть степенью двойки");
+}
+
+// Деструктор
+Logger::~Logger()
+{
+    Close();
+}
+
+// Открытие файла журнала и запуск фонового потока
+bool Logger::Open(const char* path, bool append, LogFormat format)
+{
+    Close();
+
+    m_file = std::fopen(path, append && format == LogFormat::Text ? "ab" : "wb");
+    if (!m_file) {
+        return false;
+    }
+
+    // Двоичный журнал начинается с заголовка, по которому декодер проверяет таблицу сообщений
+    if (format == LogFormat::Binary) {
+        LogFileHeader header = MakeLogFileHeader();
+        if (std::fwrite(&header, sizeof(header), 1, m_file) != 1) {
+            std::fclose(m_file);
+            m_file = nullptr;
+            return false;
+        }
+    }
+    return Start(format);
+}
+
+// Открытие журнала ограниченного размера
+bool Logger::OpenRotating(const char* path, LogFormat format, size_t segmentSize, size_t segmentCount)
+{
+    Close();
+
+    // Пачка не нужна: записи форматируются прямо в отображение.
+    // Каждый сегмент двоичного журнала читается отдельно, поэтому начинается с заголовка
+    LogFileHeader header = MakeLogFileHeader();
+    size_t headerSize = format == LogFormat::Binary ? sizeof(header) : 0;
+    if (segmentSize < headerSize + RECORD_ROOM ||
+        !m_mapped.Open(path, segmentSize, segmentCount, &header, headerSize)) {
+        return false;
+    }
+    return Start(format);
+}
+
+// Сброс очереди и запуск фонового потока
+bool Logger::Start(LogFormat format)
+{
+    m_format = format;
+    m_openTime = std::chrono::steady_clock::now();
+
+    // Каждая ячейка свободна для позиции, равной её индексу
+    for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_enqueuePosition.store(0, std::memory_order_relaxed);
+    m_dequeuePosition = 0;
+    m_completed.store(0, std::memory_order_relaxed);
+
+    m_batch.resize(m_file ? BATCH_SIZE : 0);
+    m_batchUsed = 0;
+    m_reportedDropped = 0;
+    m_written.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_batches.store(0, std::memory_order_relaxed);
+    m_rotations.store(0, std::memory_order_relaxed);
+
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_wakeRequested = false;
+    m_writer = std::thread(&Logger::WriterLoop, this);
+    m_running.store(true, std::memory_order_release);
+    return true;
+}
+
+// Запись всех принятых записей и остановка фонового потока
+void Logger::Close()
+{
+    if (!m_writer.joinable()) {
+        return;
+    }
+
+    // Производитель мог пройти проверку IsOpen до сброса m_running: после признака
+    // закрытия позиции не выдаются, а уже выданные фоновый поток дождётся и запишет
+    m_running.store(false, std::memory_order_release);
+    m_enqueuePosition.fetch_or(QUEUE_CLOSED, std::memory_order_acq_rel);
+    m_stopping.store(true, std::memory_order_release);
+    WakeWriter();
+    m_writer.join();
+
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    m_mapped.Close();
+}
+
+// Постановка готовой строки в очередь
+bool Logger::Write(const char* text, size_t length)
+{
+    size_t position = 0;
+    Slot* slot = Acquire(position);
+    if (!slot) {
+        return false;
+    }
+
+    length = length < MAX_RECORD_LENGTH ? length : MAX_RECORD_LENGTH;
+    std::memcpy(slot->data, text, length);
+    slot->length = static_cast<uint16_t>(length);
+    slot->kind = RecordKind::Text;
+    Publish(slot, position);
+    return true;
+}
+
+// Форматирование записи в стиле printf
+bool Logger::Printf(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    bool result = PrintfV(format, args);
+    va_end(args);
+    return result;
+}
+
+// Форматирование записи прямо в ячейку очереди
+bool Logger::PrintfV(const char* format, va_list args)
+{
+    size_t position = 0;
+    Slot* slot = Acquire(position);
+    if (!slot) {
+        return false;
+    }
+
+    int length = std::vsnprintf(slot->data, MAX_RECORD_LENGTH, format, args);
+    if (length < 0) {
+        length = 0;
+    }
+    slot->length = static_cast<uint16_t>(static_cast<size_t>(length) < MAX_RECORD_LENGTH
+                                              ? static_cast<size_t>(length) : MAX_RECORD_LENGTH - 1);
+    slot->kind = RecordKind::Text;
+    Publish(slot, position);
+    return true;
+}
+
+// Ожидание записи всего, что было принято к этому моменту
+void Logger::Flush()
+{
+    size_t target = m_enqueuePosition.load(std::memory_order_acquire) & ~QUEUE_CLOSED;
+    while (IsOpen() && m_completed.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Захват ячейки для записи
+Logger::Slot* Logger::Acquire(size_t& position)
+{
+    if (!IsOpen()) {
+        return nullptr;
+    }
+
+    position = m_enqueuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        if (position & QUEUE_CLOSED) {
+            return nullptr;
+        }
+
+        Slot& slot = m_slots[position & (QUEUE_CAPACITY - 1)];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0) {
+            // Ячейка свободна: пытаемся занять позицию
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                slot.timeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - m_openTime).count());
+                return &slot;
+            }
+        } else if (difference < 0) {
+            // Фоновый поток ещё не освободил ячейку - очередь полна
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            // Позицию заняли другие потоки
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Публикация заполненной ячейки
+void Logger::Publish(Slot* slot, size_t position)
+{
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    // Пока фоновый поток спит, m_completed не меняется, и порог пересекает ровно одна позиция
+    if (position + 1 - m_completed.load(std::memory_order_relaxed) == WAKE_THRESHOLD) {
+        WakeWriter();
+    }
+}
+
+// Пробуждение фонового потока
+void Logger::WakeWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeRequested = true;
+    }
+    m_wake.notify_one();
+}
+
+// Цикл фонового потока
+void Logger::WriterLoop()
+{
+    GetZoneRecorder().SetThreadName("Журнал");
+
+    while (!m_stopping.load(std::memory_order_acquire)) {
+        if (Drain() == 0) {
+            // Очередь пуста - отдаём накопленное в файл и ждём новых записей или пробуждения
+            WriteBatch();
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, IDLE_SLEEP, [this]() { return m_wakeRequested; });
+            m_wakeRequested = false;
+        }
+    }
+
+    // Дописываем всё, что успели поставить в очередь до остановки, в том числе записи,
+    // позиции которых выданы до закрытия, а публикация ещё не завершена
+    size_t end = m_enqueuePosition.load(std::memory_order_acquire) & ~QUEUE_CLOSED;
+    while (m_dequeuePosition < end) {
+        if (Drain() == 0) {
+            std::this_thread::yield();
+        }
+    }
+    WriteBatch();
+}
+
+// Перенос готовых записей в буфер пачки
+size_t Logger::Drain()
+{
+    // Пустые опросы очереди не попадают на временную шкалу
+    if (m_slots[m_dequeuePosition & (QUEUE_CAPACITY - 1)].sequence.load(std::memory_order_acquire) !=
+        m_dequeuePosition + 1) {
+        return 0;
+    }
+    WATER_TRACE_ZONE("Logger::Drain");
+
+    size_t drained = 0;
+    for (;;) {
+        Slot& slot = m_slots[m_dequeuePosition & (QUEUE_CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1) {
+            break;
+        }
+
+        if (m_file && m_batchUsed + RECORD_ROOM > m_batch.size()) {
+            WriteBatch();
+        }
+        bool appended = AppendRecord(slot.kind, slot.timeNs, slot.data, slot.length);
+
+        // Ячейка снова свободна для позиции на круг дальше
+        slot.sequence.store(m_dequeuePosition + QUEUE_CAPACITY, std::memory_order_release);
+        ++m_dequeuePosition;
+        ++drained;
+        (appended ? m_written : m_dropped).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return drained;
+}
+
+// Добавление одной записи в буфер пачки или в отображённый сегмент
+bool Logger::AppendRecord(RecordKind kind, uint64_t timeNs, const char* data, size_t length)
+{
+    if (m_file) {
+        m_batchUsed += FormatRecord(m_batch.data() + m_batchUsed, kind, timeNs, data, length);
+        return true;
+    }
+
+    // Смена сегмента (если нужна) происходит здесь, на фоновом потоке
+    char* out = m_mapped.Reserve(RECORD_ROOM);
+    m_rotations.store(m_mapped.Rotations(), std::memory_order_relaxed);
+    if (!out) {
+        return false;
+    }
+    m_mapped.Commit(FormatRecord(out, kind, timeNs, data, length));
+    return true;
+}
+
+// Запись в формате файла по адресу out
+size_t Logger::FormatRecord(char* out, RecordKind kind, uint64_t timeNs, const char* data, size_t length) const
+{
+    if (m_format == LogFormat::Text) {
+        // Событие превращается в текст здесь, на фоновом потоке
+        size_t written = length;
+        if (kind == RecordKind::Event) {
+            if (!FormatLogEvent(reinterpret_cast<const uint8_t*>(data), length, out, RECORD_ROOM - 1, written)) {
+                static const char CORRUPT[] = "Повреждённая запись журнала";
+                written = sizeof(CORRUPT) - 1;
+                std::memcpy(out, CORRUPT, written);
+            }
+        } else {
+            std::memcpy(out, data, length);
+        }
+        out[written] = '\n';
+        return written + 1;
+    }
+
+    // Двоичный формат: текстовая запись становится событием FreeText со строкой
+    uint8_t* payload = reinterpret_cast<uint8_t*>(out + sizeof(LogRecordHeader));
+    size_t payloadLength = length;
+    if (kind == RecordKind::Text) {
+        uint16_t id = static_cast<uint16_t>(LogMessageId::FreeText);
+        std::memcpy(payload, &id, sizeof(id));
+        payload[2] = static_cast<uint8_t>(LogArgType::String);
+        payload[3] = static_cast<uint8_t>(length);
+        std::memcpy(payload + 4, data, length);
+        payloadLength = length + 4;
+    } else {
+        std::memcpy(payload, data, length);
+    }
+
+    LogRecordHeader header = { static_cast<uint16_t>(payloadLength), timeNs };
+    std::memcpy(out, &header, sizeof(header));
+    return sizeof(header) + payloadLength;
+}
+
+// Запись пачки в файл
+void Logger::WriteBatch()
+{
+    // Потери сообщаются в самом журнале, чтобы пропуски было видно при чтении
+    uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDropped && (!m_file || m_batchUsed + RECORD_ROOM <= m_batch.size())) {
+        uint8_t payload[32];
+        uint8_t* end = EncodeLogEvent(payload, LogMessageId::RecordsLost,
+                                      static_cast<unsigned long long>(dropped - m_reportedDropped));
+        uint64_t timeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_openTime).count());
+        // Если запись не удалась (сегмент не открылся), о потерях сообщается следующей пачкой
+        if (AppendRecord(RecordKind::Event, timeNs, reinterpret_cast<const char*>(payload),
+                         static_cast<size_t>(end - payload))) {
+            m_reportedDropped = dropped;
+        }
+    }
+
+    if (m_batchUsed > 0) {
+        WATER_TRACE_ZONE("Logger::WriteBatch");
+        std::fwrite(m_batch.data(), 1, m_batchUsed, m_file);
+        std::fflush(m_file);
+        m_batchUsed = 0;
+        m_batches.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_completed.store(m_dequeuePosition, std::memory_order_release);
+}
+
+// Разбор имени уровня
+bool ParseLogLevel(const char* name, LogLevel& level)
+{
+    static const struct {
+        const char* name;
+        LogLevel level;
+    } LEVELS[] = {
+        { "trace", LogLevel::Trace },
+        { "debug", LogLevel::Debug },
+        { "info", LogLevel::Info },
+        { "warning", LogLevel::Warning },
+        { "error", LogLevel::Error },
+    };
+
+    for (const auto& entry : LEVELS) {
+        if (std::strncmp(name, entry.name, std::strlen(entry.name)) == 0) {
+            level = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Общий журнал приложения
+Logger& GetLogger()
+{
+    static Logger logger;
+    return logger;
+}
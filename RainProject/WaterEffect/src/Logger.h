@@ -0,0 +1,237 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LogMessages.h"
+#include "MappedLogFile.h"
+
+// Минимальный уровень, который вообще попадает в сборку.
+// Задаётся из CMake (WATER_LOG_MIN_LEVEL); записи ниже него вырезаются компилятором
+// вместе с вычислением аргументов
+#ifndef WATER_LOG_MIN_LEVEL
+#define WATER_LOG_MIN_LEVEL 0
+#endif
+
+static constexpr LogLevel LOG_MIN_LEVEL = static_cast<LogLevel>(WATER_LOG_MIN_LEVEL);
+
+// Формат файла журнала
+enum class LogFormat {
+    Text,       // Строки текста; записи-события форматирует фоновый поток
+    Binary      // Идентификаторы сообщений и сырые аргументы (читается water_logdecode)
+};
+
+// Асинхронный журнал.
+// Вызывающий поток кладёт запись прямо в ячейку кольцевого буфера
+// без блокировок (ограниченная очередь со счётчиками последовательности в каждой
+// ячейке), а фоновый поток забирает записи пачками и пишет их одним fwrite
+// в файл, открытый на всё время работы. Если очередь переполнена, запись
+// отбрасывается и учитывается в счётчике потерь: журнал никогда не тормозит кадр.
+// Пустую очередь фоновый поток опрашивает с паузой, но когда очередь заполнена
+// на WAKE_THRESHOLD записей, производитель будит его сразу.
+// Запись-событие (Event) - это идентификатор сообщения из LogMessages.h и сырые
+// значения аргументов, поэтому на вызывающем потоке нет форматирования вовсе
+class Logger {
+public:
+    Logger();
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Открытие файла журнала и запуск фонового потока.
+    // append = false - файл очищается; двоичный журнал всегда пишется с начала
+    bool Open(const char* path, bool append = false, LogFormat format = LogFormat::Text);
+
+    // Открытие журнала ограниченного размера: segmentCount сегментов по segmentSize байт,
+    // записываемых по кругу через отображение в память (MappedLogFile)
+    bool OpenRotating(const char* path, LogFormat format, size_t segmentSize, size_t segmentCount);
+
+    // Запись всех принятых записей и остановка фонового потока
+    void Close();
+
+    bool IsOpen() const { return m_running.load(std::memory_order_acquire); }
+
+    // Фильтр уровня во время работы (для уровней, оставшихся в сборке)
+    void SetLevel(LogLevel level) { m_level.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel Level() const { return static_cast<LogLevel>(m_level.load(std::memory_order_relaxed)); }
+    bool IsEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= m_level.load(std::memory_order_relaxed) && IsOpen();
+    }
+
+    // Постановка готовой строки в очередь (перевод строки добавляется).
+    // Возвращает false, если журнал закрыт или очередь переполнена
+    bool Write(const char* text, size_t length);
+
+    // Форматирование записи в стиле printf прямо в ячейку очереди
+    bool Printf(const char* format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+    bool PrintfV(const char* format, va_list args);
+
+    // Запись-событие: идентификатор сообщения и значения аргументов без форматирования
+    template <LogMessageId Id, typename... Args>
+    bool Event(Args... args);
+
+    // Ожидание, пока фоновый поток запишет всё, что было принято к этому моменту
+    void Flush();
+
+    // Счётчики с момента открытия
+    uint64_t Written() const { return m_written.load(std::memory_order_relaxed); }
+    uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    uint64_t Batches() const { return m_batches.load(std::memory_order_relaxed); }
+    uint64_t Rotations() const { return m_rotations.load(std::memory_order_relaxed); }
+
+    // Максимальная длина одной записи; более длинные обрезаются
+    static constexpr size_t MAX_RECORD_LENGTH = 240;
+
+    // Число ячеек очереди (степень двойки)
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+
+    // Заполнение очереди, при котором производитель будит спящий фоновый поток
+    static constexpr size_t WAKE_THRESHOLD = QUEUE_CAPACITY / 4;
+
+private:
+    // Вид записи в ячейке
+    enum class RecordKind : uint8_t {
+        Text,       // Готовый текст без перевода строки
+        Event       // Закодированное событие (EncodeLogEvent)
+    };
+
+    // Ячейка очереди
+    struct Slot {
+        std::atomic<size_t> sequence;       // Номер позиции, для которой ячейка свободна или заполнена
+        uint64_t timeNs;                    // Время постановки от открытия журнала
+        uint16_t length;                    // Длина данных
+        RecordKind kind;                    // Вид записи
+        char data[MAX_RECORD_LENGTH];       // Текст или закодированное событие
+    };
+
+    // Сброс очереди и запуск фонового потока после открытия файла
+    bool Start(LogFormat format);
+
+    // Захват ячейки для записи; nullptr при переполнении
+    Slot* Acquire(size_t& position);
+
+    // Публикация заполненной ячейки; при заполнении очереди до WAKE_THRESHOLD - пробуждение фонового потока
+    void Publish(Slot* slot, size_t position);
+
+    // Пробуждение фонового потока до окончания паузы
+    void WakeWriter();
+
+    // Цикл фонового потока
+    void WriterLoop();
+
+    // Перенос готовых записей в буфер пачки; возвращает число перенесённых
+    size_t Drain();
+
+    // Добавление одной записи в буфер пачки или в отображённый сегмент; false, если места нет
+    bool AppendRecord(RecordKind kind, uint64_t timeNs, const char* data, size_t length);
+
+    // Запись в формате файла по адресу out; возвращает число байт
+    size_t FormatRecord(char* out, RecordKind kind, uint64_t timeNs, const char* data, size_t length) const;
+
+    // Запись пачки в файл
+    void WriteBatch();
+
+private:
+    std::unique_ptr<Slot[]> m_slots;        // Кольцо ячеек
+    alignas(64) std::atomic<size_t> m_enqueuePosition;  // Следующая позиция для записи
+    alignas(64) size_t m_dequeuePosition;   // Следующая позиция для чтения (только фоновый поток)
+    std::atomic<size_t> m_completed;        // Позиция, до которой записи ушли в файл
+
+    // Признак закрытия в m_enqueuePosition: после Close позиции больше не выдаются
+    static constexpr size_t QUEUE_CLOSED = static_cast<size_t>(1) << (sizeof(size_t) * 8 - 1);
+
+    FILE* m_file;                           // Файл журнала (Open)
+    MappedLogFile m_mapped;                 // Сегменты журнала ограниченного размера (OpenRotating)
+    LogFormat m_format;                     // Формат файла
+    std::chrono::steady_clock::time_point m_openTime; // Момент открытия (начало отсчёта времени записей)
+    std::vector<char> m_batch;              // Буфер пачки фонового потока
+    size_t m_batchUsed;                     // Занято байт в буфере пачки
+    uint64_t m_reportedDropped;             // Потери, о которых уже написано в журнал
+
+    std::thread m_writer;                   // Фоновый поток записи
+    std::atomic<bool> m_running;            // Журнал открыт
+    std::atomic<bool> m_stopping;           // Фоновый поток должен завершиться
+    std::mutex m_wakeMutex;                 // Защита m_wakeRequested
+    std::condition_variable m_wake;         // Пробуждение фонового потока
+    bool m_wakeRequested;                   // Фоновый поток разбудили до окончания паузы
+    std::atomic<int> m_level;               // Минимальный уровень во время работы
+
+    std::atomic<uint64_t> m_written;        // Записей отправлено в файл
+    std::atomic<uint64_t> m_dropped;        // Записей отброшено при переполнении
+    std::atomic<uint64_t> m_batches;        // Вызовов fwrite
+    std::atomic<uint64_t> m_rotations;      // Смен сегмента (OpenRotating)
+
+    static constexpr size_t BATCH_SIZE = 64 * 1024;
+};
+
+// Запись-событие
+template <LogMessageId Id, typename... Args>
+bool Logger::Event(Args... args)
+{
+    static_assert(sizeof...(Args) == CountFormatArguments(LOG_MESSAGES[static_cast<size_t>(Id)].format),
+                  "Число аргументов не совпадает со строкой формата сообщения");
+    static_assert(sizeof(uint16_t) + (LogArgSize<Args>() + ... + 0) <= MAX_RECORD_LENGTH,
+                  "Аргументы сообщения не помещаются в запись");
+
+    size_t position = 0;
+    Slot* slot = Acquire(position);
+    if (!slot) {
+        return false;
+    }
+
+    uint8_t* begin = reinterpret_cast<uint8_t*>(slot->data);
+    uint8_t* end = EncodeLogEvent(begin, Id, args...);
+    slot->length = static_cast<uint16_t>(end - begin);
+    slot->kind = RecordKind::Event;
+    Publish(slot, position);
+    return true;
+}
+
+// Общий журнал приложения
+Logger& GetLogger();
+
+// Разбор имени уровня (trace, debug, info, warning, error)
+bool ParseLogLevel(const char* name, LogLevel& level);
+
+// Запись в общий журнал с уровнем важности.
+// Если уровень ниже LOG_MIN_LEVEL, ветка отбрасывается на этапе компиляции и аргументы
+// не вычисляются; иначе запись проходит фильтр уровня во время работы
+#define WATER_LOG(level, ...)                                           \
+    do {                                                                \
+        if constexpr ((level) >= LOG_MIN_LEVEL) {                       \
+            if (GetLogger().IsEnabled(level)) {                         \
+                GetLogger().Printf(__VA_ARGS__);                        \
+            }                                                           \
+        }                                                               \
+    } while (0)
+
+// Запись-событие в общий журнал: WATER_LOG_EVENT(WaveCreated, x, y).
+// Уровень берётся из таблицы сообщений, фильтры те же, что у WATER_LOG
+#define WATER_LOG_EVENT(id, ...)                                                        \
+    do {                                                                                \
+        if constexpr (LogMessageLevel(LogMessageId::id) >= LOG_MIN_LEVEL) {             \
+            if (GetLogger().IsEnabled(LogMessageLevel(LogMessageId::id))) {             \
+                GetLogger().Event<LogMessageId::id>(__VA_ARGS__);                       \
+            }                                                                           \
+        }                                                                               \
+    } while (0)
+
+#define WATER_LOG_TRACE(...) WATER_LOG(LogLevel::Trace, __VA_ARGS__)
+#define WATER_LOG_DEBUG(...) WATER_LOG(LogLevel::Debug, __VA_ARGS__)
+#define WATER_LOG_INFO(...) WATER_LOG(LogLevel::Info, __VA_ARGS__)
+#define WATER_LOG_WARNING(...) WATER_LOG(LogLevel::Warning, __VA_ARGS__)
+#define WATER_LOG_ERROR(...) WATER_LOG(LogLevel::Error, __VA_ARGS__)
@@ -0,0 +1,240 @@
+#include "MappedLogFile.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Конструктор
+MappedLogFile::MappedLogFile() :
+    m_segmentSize(0),
+    m_segmentCount(0),
+    m_segment(0),
+    m_rotations(0),
+    m_view(nullptr),
+    m_used(0),
+    m_retryPending(false),
+#ifdef _WIN32
+    m_file(INVALID_HANDLE_VALUE),
+    m_mapping(nullptr)
+#else
+    m_file(-1)
+#endif
+{
+}
+
+// Деструктор
+MappedLogFile::~MappedLogFile()
+{
+    Close();
+}
+
+// Путь сегмента
+std::string MappedLogFile::SegmentPath(const char* path, size_t index)
+{
+    std::string result(path);
+    size_t slash = result.find_last_of("/\\");
+    size_t dot = result.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash) || dot == slash + 1) {
+        dot = result.size();
+    }
+    return result.substr(0, dot) + "." + std::to_string(index) + result.substr(dot);
+}
+
+// Открытие первого сегмента
+bool MappedLogFile::Open(const char* path, size_t segmentSize, size_t segmentCount,
+                         const void* header, size_t headerSize)
+{
+    Close();
+    if (segmentCount == 0 || segmentSize <= headerSize) {
+        return false;
+    }
+
+    m_path = path;
+    m_header.assign(static_cast<const char*>(header), static_cast<const char*>(header) + headerSize);
+    m_segmentSize = segmentSize;
+    m_segmentCount = segmentCount;
+    m_rotations = 0;
+
+    // Сегменты прошлого запуска иначе перемешались бы с новыми
+    for (size_t i = 1; i < segmentCount; ++i) {
+        std::remove(SegmentPath(path, i).c_str());
+    }
+    return MapSegment(0);
+}
+
+// Закрытие
+void MappedLogFile::Close()
+{
+    UnmapSegment();
+    m_retryPending = false;
+}
+
+// Место под запись
+char* MappedLogFile::Reserve(size_t size)
+{
+    if (!m_view && !RetrySegment()) {
+        return nullptr;
+    }
+    if (m_used + size > m_segmentSize) {
+        size_t next = (m_segment + 1) % m_segmentCount;
+        UnmapSegment();
+        if (!MapSegment(next)) {
+            m_segment = next;
+            m_retryPending = true;
+            m_retryTime = std::chrono::steady_clock::now() + RETRY_INTERVAL;
+            return nullptr;
+        }
+        ++m_rotations;
+        if (m_used + size > m_segmentSize) {
+            return nullptr;
+        }
+    }
+    return m_view + m_used;
+}
+
+// Повторное открытие сегмента после сбоя
+bool MappedLogFile::RetrySegment()
+{
+    if (!m_retryPending) {
+        return false;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now < m_retryTime) {
+        return false;
+    }
+    if (!MapSegment(m_segment)) {
+        m_retryTime = now + RETRY_INTERVAL;
+        return false;
+    }
+    m_retryPending = false;
+    ++m_rotations;
+    return true;
+}
+
+#ifdef _WIN32
+
+// Создание сегмента нужного размера и его отображение
+bool MappedLogFile::MapSegment(size_t index)
+{
+    std::string path = SegmentPath(m_path.c_str(), index);
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    // Место на диске занимается сразу, чтобы запись в отображение не упёрлась в нехватку места
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(m_segmentSize);
+    HANDLE mapping = nullptr;
+    void* view = nullptr;
+    if (SetFilePointerEx(file, size, nullptr, FILE_BEGIN) && SetEndOfFile(file)) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size.QuadPart >> 32),
+                                     static_cast<DWORD>(size.QuadPart & 0xFFFFFFFF), nullptr);
+    }
+    if (mapping) {
+        view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, m_segmentSize);
+    }
+    if (!view) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_view = static_cast<char*>(view);
+    m_segment = index;
+    m_used = m_header.size();
+    std::memcpy(m_view, m_header.data(), m_header.size());
+    return true;
+}
+
+// Снятие отображения и обрезка файла до записанного
+void MappedLogFile::UnmapSegment()
+{
+    if (!m_view) {
+        return;
+    }
+
+    UnmapViewOfFile(m_view);
+    CloseHandle(m_mapping);
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(m_used);
+    SetFilePointerEx(m_file, size, nullptr, FILE_BEGIN);
+    SetEndOfFile(m_file);
+    CloseHandle(m_file);
+
+    m_view = nullptr;
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+// Создание сегмента нужного размера и его отображение
+bool MappedLogFile::MapSegment(size_t index)
+{
+    std::string path = SegmentPath(m_path.c_str(), index);
+    int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) {
+        return false;
+    }
+
+    // Место на диске занимается сразу: запись в отображение за пределами
+    // свободного места закончилась бы сигналом SIGBUS, а не ошибкой.
+    // Разреженный файл допустим только там, где файловая система не умеет занимать
+    // место заранее; нехватка места (ENOSPC) и прочие ошибки отменяют сегмент
+    off_t size = static_cast<off_t>(m_segmentSize);
+    int error = posix_fallocate(file, 0, size);
+    if (error == EOPNOTSUPP || error == EINVAL) {
+        error = ftruncate(file, size) == 0 ? 0 : errno;
+    }
+    if (error != 0) {
+        ::close(file);
+        ::unlink(path.c_str());
+        return false;
+    }
+
+    void* view = mmap(nullptr, m_segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (view == MAP_FAILED) {
+        ::close(file);
+        return false;
+    }
+
+    m_file = file;
+    m_view = static_cast<char*>(view);
+    m_segment = index;
+    m_used = m_header.size();
+    std::memcpy(m_view, m_header.data(), m_header.size());
+    return true;
+}
+
+// Снятие отображения и обрезка файла до записанного
+void MappedLogFile::UnmapSegment()
+{
+    if (!m_view) {
+        return;
+    }
+
+    munmap(m_view, m_segmentSize);
+    if (ftruncate(m_file, static_cast<off_t>(m_used)) != 0) {
+        // Хвост сегмента останется заполненным нулями - читатели журнала его пропускают
+    }
+    ::close(m_file);
+
+    m_view = nullptr;
+    m_file = -1;
+}
+
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Файл журнала ограниченного размера, записываемый через отображение в память.
+// Журнал состоит из segmentCount сегментов <имя>.<N><расширение> размером segmentSize:
+// сегмент создаётся сразу нужного размера и отображается целиком, записи копируются
+// в отображение по курсору. Когда место в сегменте кончается, он обрезается
+// до записанного и курсор переходит к следующему сегменту по кругу, затирая самый старый.
+// Так журнал никогда не занимает больше segmentSize * segmentCount байт, а открытие
+// и закрытие файлов происходят только при смене сегмента на фоновом потоке журнала.
+// Если следующий сегмент открыть не удалось (нет места, нет доступа), записи отбрасываются,
+// а сегмент открывается повторно не чаще раза в RETRY_INTERVAL
+class MappedLogFile {
+public:
+    // Интервал между попытками открыть сегмент после сбоя
+    static constexpr std::chrono::milliseconds RETRY_INTERVAL{ 1000 };
+
+    MappedLogFile();
+    ~MappedLogFile();
+
+    MappedLogFile(const MappedLogFile&) = delete;
+    MappedLogFile& operator=(const MappedLogFile&) = delete;
+
+    // Открытие первого сегмента. header - данные в начале каждого сегмента (может быть пустым).
+    // Сегменты прошлого запуска удаляются
+    bool Open(const char* path, size_t segmentSize, size_t segmentCount, const void* header, size_t headerSize);
+
+    // Обрезка текущего сегмента до записанного и закрытие
+    void Close();
+
+    bool IsOpen() const { return m_view != nullptr || m_retryPending; }
+
+    // Место под запись длиной до size байт; при нехватке места - переход к следующему сегменту.
+    // nullptr, если следующий сегмент открыть не удалось (до успешной повторной попытки)
+    char* Reserve(size_t size);
+
+    // Фиксация записанных в зарезервированное место байт
+    void Commit(size_t size) { m_used += size; }
+
+    // Номер текущего сегмента и число смен сегмента с открытия
+    size_t Segment() const { return m_segment; }
+    uint64_t Rotations() const { return m_rotations; }
+
+    // Путь сегмента: "log.txt" -> "log.<index>.txt"
+    static std::string SegmentPath(const char* path, size_t index);
+
+private:
+    // Создание сегмента нужного размера и его отображение
+    bool MapSegment(size_t index);
+
+    // Снятие отображения и обрезка файла до записанного
+    void UnmapSegment();
+
+    // Повторное открытие сегмента после сбоя, если с прошлой попытки прошло RETRY_INTERVAL
+    bool RetrySegment();
+
+private:
+    std::string m_path;             // Путь журнала, из которого строятся имена сегментов
+    std::vector<char> m_header;     // Начало каждого сегмента
+    size_t m_segmentSize;           // Размер сегмента
+    size_t m_segmentCount;          // Число сегментов по кругу
+    size_t m_segment;               // Текущий сегмент
+    uint64_t m_rotations;           // Смен сегмента с открытия
+
+    char* m_view;                   // Отображение текущего сегмента
+    size_t m_used;                  // Записано байт в текущий сегмент
+    bool m_retryPending;            // Сегмент m_segment не открылся, нужна повторная попытка
+    std::chrono::steady_clock::time_point m_retryTime; // Время следующей попытки
+
+#ifdef _WIN32
+    void* m_file;                   // HANDLE файла
+    void* m_mapping;                // HANDLE отображения
+#else
+    int m_file;                     // Дескриптор файла
+#endif
+};
@@ -0,0 +1,64 @@
+#include "SimulationClock.h"
+
+// Конструктор
+SimulationClock::SimulationClock(TimeSource* source, double tick, int maxSteps) :
+    m_source(source),
+    m_tick(tick),
+    m_maxSteps(maxSteps > 0 ? maxSteps : 1),
+    m_lastTime(0.0),
+    m_accumulator(0.0),
+    m_steps(0),
+    m_skippedSteps(0)
+{
+    Reset();
+}
+
+// Смена источника времени
+void SimulationClock::SetTimeSource(TimeSource* source)
+{
+    m_source = source;
+    m_steps = 0;
+    m_skippedSteps = 0;
+    Reset();
+}
+
+// Сброс накопителя
+void SimulationClock::Reset()
+{
+    m_lastTime = m_source ? m_source->Seconds() : 0.0;
+    m_accumulator = 0.0;
+}
+
+// Подсчёт шагов, которые нужно выполнить сейчас
+int SimulationClock::Advance()
+{
+    if (!m_source) {
+        return 0;
+    }
+
+    double now = m_source->Seconds();
+    double elapsed = now - m_lastTime;
+    m_lastTime = now;
+
+    // Время не идёт назад: отрицательный интервал означает смену источника
+    if (elapsed > 0.0) {
+        m_accumulator += elapsed;
+    }
+
+    int steps = 0;
+    while (m_accumulator >= m_tick && steps < m_maxSteps) {
+        m_accumulator -= m_tick;
+        ++steps;
+    }
+
+    // Не догоняем пропущенное время: целые шаги сверх лимита отбрасываются,
+    // доля шага сохраняется для интерполяции
+    if (m_accumulator >= m_tick) {
+        uint64_t skipped = static_cast<uint64_t>(m_accumulator / m_tick);
+        m_accumulator -= static_cast<double>(skipped) * m_tick;
+        m_skippedSteps += skipped;
+    }
+
+    m_steps += static_cast<uint64_t>(steps);
+    return steps;
+}
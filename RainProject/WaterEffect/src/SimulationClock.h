@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Источник времени в секундах от произвольной точки отсчёта.
+// Часы симуляции читают время только через этот интерфейс, поэтому
+// замеры и воспроизведение могут подставить собственное время
+class TimeSource {
+public:
+    virtual ~TimeSource() {}
+    virtual double Seconds() = 0;
+};
+
+// Монотонные системные часы
+class SteadyTimeSource : public TimeSource {
+public:
+    SteadyTimeSource() : m_start(std::chrono::steady_clock::now()) {}
+
+    double Seconds() override {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Время, которое продвигается только вручную (замеры, воспроизведение)
+class ManualTimeSource : public TimeSource {
+public:
+    ManualTimeSource() : m_seconds(0.0) {}
+
+    double Seconds() override { return m_seconds; }
+
+    void Set(double seconds) { m_seconds = seconds; }
+    void Advance(double seconds) { m_seconds += seconds; }
+
+private:
+    double m_seconds;
+};
+
+// Часы симуляции с фиксированным шагом.
+// Прошедшее время накапливается и отрабатывается целыми шагами tick, поэтому
+// результат симуляции не зависит от дрожания таймера. Остаток накопителя
+// задаёт долю шага (Alpha) для интерполяции состояния при отрисовке.
+// Если за одно продвижение набралось больше maxSteps шагов (отладчик, перетаскивание
+// окна), лишнее время отбрасывается, чтобы симуляция не уходила в догонялки
+class SimulationClock {
+public:
+    SimulationClock(TimeSource* source, double tick, int maxSteps);
+
+    // Смена источника времени; накопитель и счётчик шагов сбрасываются
+    void SetTimeSource(TimeSource* source);
+
+    // Сброс накопителя: следующее продвижение считает время от текущего момента
+    void Reset();
+
+    // Чтение источника времени и подсчёт шагов, которые нужно выполнить сейчас
+    int Advance();
+
+    // Доля следующего шага, прошедшая после последнего выполненного, в [0, 1)
+    float Alpha() const { return static_cast<float>(m_accumulator / m_tick); }
+
+    // Время симуляции: число выполненных шагов, умноженное на длину шага
+    double Time() const { return static_cast<double>(m_steps) * m_tick; }
+
+    // Время для отрисовки: последнее состояние плюс доля следующего шага
+    double RenderTime() const { return Time() + m_accumulator; }
+
+    double Tick() const { return m_tick; }
+    int MaxSteps() const { return m_maxSteps; }
+    uint64_t Steps() const { return m_steps; }
+
+    // Число шагов, отброшенных ограничением maxSteps
+    uint64_t SkippedSteps() const { return m_skippedSteps; }
+
+private:
+    TimeSource* m_source;       // Источник времени (не владеет)
+    double m_tick;              // Длина шага, секунды
+    int m_maxSteps;             // Максимум шагов за одно продвижение
+    double m_lastTime;          // Показание источника при прошлом продвижении
+    double m_accumulator;       // Накопленное, но ещё не отработанное время
+    uint64_t m_steps;           // Выполнено шагов с момента сброса
+    uint64_t m_skippedSteps;    // Отброшено шагов с момента сброса
+};
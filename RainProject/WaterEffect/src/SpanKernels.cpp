@@ -0,0 +1,258 @@
+#include "SpanKernels.h"
+#include "CpuFeatures.h"
+#include "Framebuffer.h"
+
+#if WATER_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Наложение предумноженного цвета color с обратной альфой inverse на один пиксель
+inline uint32_t BlendPixel(uint32_t dst, uint32_t color, uint32_t inverse)
+{
+    uint32_t a = Div255((dst >> 24) * inverse);
+    uint32_t r = Div255(((dst >> 16) & 0xFF) * inverse);
+    uint32_t g = Div255(((dst >> 8) & 0xFF) * inverse);
+    uint32_t b = Div255((dst & 0xFF) * inverse);
+    // Сумма не переполняет байт: компонента цвета не больше его альфы
+    return color + ((a << 24) | (r << 16) | (g << 8) | b);
+}
+
+// Скалярная заливка диапазона, общая для эталона и хвостов SIMD-ядер
+void BlendRange(uint32_t* pixels, size_t begin, size_t end, uint32_t color)
+{
+    uint32_t inverse = 255 - (color >> 24);
+    for (size_t i = begin; i < end; ++i) {
+        pixels[i] = BlendPixel(pixels[i], color, inverse);
+    }
+}
+
+// То же для двух цветов подряд
+void BlendRange2(uint32_t* pixels, size_t begin, size_t end, uint32_t first, uint32_t second)
+{
+    uint32_t firstInverse = 255 - (first >> 24);
+    uint32_t secondInverse = 255 - (second >> 24);
+    for (size_t i = begin; i < end; ++i) {
+        pixels[i] = BlendPixel(BlendPixel(pixels[i], first, firstInverse), second, secondInverse);
+    }
+}
+
+#if WATER_X86
+
+// SSE2: наложение на 4 пикселя. Байты расширяются до 16 бит, умножаются
+// на 255 - alpha и делятся на 255 с округлением: (t + (t >> 8)) >> 8, где t = x + 128.
+// Для t < 65536 это ровно (t * 257) >> 16 - одно умножение со старшей половиной вместо трёх команд
+WATER_TARGET("sse2")
+inline __m128i Blend4Sse2(__m128i dst, __m128i inverse, __m128i source)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i scale = _mm_set1_epi16(257);
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), inverse), half);
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), inverse), half);
+    lo = _mm_mulhi_epu16(lo, scale);
+    hi = _mm_mulhi_epu16(hi, scale);
+    return _mm_add_epi8(_mm_packus_epi16(lo, hi), source);
+}
+
+// SSE2: наложение на 8 компонент, уже расширенных до 16 бит; результат остаётся
+// в 16 битах (не больше 255), так что второе наложение не распаковывает его заново
+WATER_TARGET("sse2")
+inline __m128i BlendWordsSse2(__m128i words, __m128i inverse, __m128i source)
+{
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i scale = _mm_set1_epi16(257);
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(words, inverse), half);
+    return _mm_add_epi16(_mm_mulhi_epu16(t, scale), source);
+}
+
+// SSE2: по 4 пикселя за итерацию
+WATER_TARGET("sse2")
+void BlendSpanSse2(uint32_t* pixels, size_t count, uint32_t color)
+{
+    const __m128i inverse = _mm_set1_epi16(static_cast<short>(255 - (color >> 24)));
+    const __m128i source = _mm_set1_epi32(static_cast<int>(color));
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), Blend4Sse2(dst, inverse, source));
+    }
+    BlendRange(pixels, i, count, color);
+}
+
+// SSE2: два цвета подряд по 4 пикселя за итерацию
+WATER_TARGET("sse2")
+void BlendSpan2Sse2(uint32_t* pixels, size_t count, uint32_t first, uint32_t second)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i firstInverse = _mm_set1_epi16(static_cast<short>(255 - (first >> 24)));
+    const __m128i firstSource = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(first)), zero);
+    const __m128i secondInverse = _mm_set1_epi16(static_cast<short>(255 - (second >> 24)));
+    const __m128i secondSource = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(second)), zero);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+        __m128i lo = _mm_unpacklo_epi8(dst, zero);
+        __m128i hi = _mm_unpackhi_epi8(dst, zero);
+        lo = BlendWordsSse2(BlendWordsSse2(lo, firstInverse, firstSource), secondInverse, secondSource);
+        hi = BlendWordsSse2(BlendWordsSse2(hi, firstInverse, firstSource), secondInverse, secondSource);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), _mm_packus_epi16(lo, hi));
+    }
+    BlendRange2(pixels, i, count, first, second);
+}
+
+// AVX2: наложение на 8 пикселей.
+// Распаковка и упаковка идут внутри 128-битных половин, поэтому порядок пикселей сохраняется
+WATER_TARGET("avx2")
+inline __m256i Blend8Avx2(__m256i dst, __m256i inverse, __m256i source)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i half = _mm256_set1_epi16(128);
+    const __m256i scale = _mm256_set1_epi16(257);
+    __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, zero), inverse), half);
+    __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, zero), inverse), half);
+    lo = _mm256_mulhi_epu16(lo, scale);
+    hi = _mm256_mulhi_epu16(hi, scale);
+    return _mm256_add_epi8(_mm256_packus_epi16(lo, hi), source);
+}
+
+// AVX2: наложение на 16 компонент в 16 битах (как BlendWordsSse2)
+WATER_TARGET("avx2")
+inline __m256i BlendWordsAvx2(__m256i words, __m256i inverse, __m256i source)
+{
+    const __m256i half = _mm256_set1_epi16(128);
+    const __m256i scale = _mm256_set1_epi16(257);
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(words, inverse), half);
+    return _mm256_add_epi16(_mm256_mulhi_epu16(t, scale), source);
+}
+
+// AVX2: по 16 пикселей за итерацию (два регистра по 8), затем по 8
+WATER_TARGET("avx2")
+void BlendSpanAvx2(uint32_t* pixels, size_t count, uint32_t color)
+{
+    const __m256i inverse = _mm256_set1_epi16(static_cast<short>(255 - (color >> 24)));
+    const __m256i source = _mm256_set1_epi32(static_cast<int>(color));
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i));
+        __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i + 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i), Blend8Avx2(first, inverse, source));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i + 8), Blend8Avx2(second, inverse, source));
+    }
+    if (i + 8 <= count) {
+        __m256i dst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i), Blend8Avx2(dst, inverse, source));
+        i += 8;
+    }
+    // Хвост обрабатывается обычным кодом SSE. Компилятор заменяет этот вызов переходом
+    // и не сбрасывает верхние половины YMM, а без сброса весь последующий код SSE
+    // (покрытие краёв и следующие круги) работает заметно медленнее
+    _mm256_zeroupper();
+    BlendRange(pixels, i, count, color);
+}
+
+// AVX2: два цвета подряд на 8 пикселей на месте. Между наложениями компоненты
+// остаются в 16 битах, поэтому распаковка и упаковка выполняются один раз на пиксель
+WATER_TARGET("avx2")
+inline void Blend2x8Avx2(uint32_t* pixels, __m256i firstInverse, __m256i firstSource,
+                         __m256i secondInverse, __m256i secondSource)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i dst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels));
+    __m256i lo = _mm256_unpacklo_epi8(dst, zero);
+    __m256i hi = _mm256_unpackhi_epi8(dst, zero);
+    lo = BlendWordsAvx2(BlendWordsAvx2(lo, firstInverse, firstSource), secondInverse, secondSource);
+    hi = BlendWordsAvx2(BlendWordsAvx2(hi, firstInverse, firstSource), secondInverse, secondSource);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels), _mm256_packus_epi16(lo, hi));
+}
+
+// AVX2: два цвета подряд по 16 пикселей за итерацию, затем по 8
+WATER_TARGET("avx2")
+void BlendSpan2Avx2(uint32_t* pixels, size_t count, uint32_t first, uint32_t second)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i firstInverse = _mm256_set1_epi16(static_cast<short>(255 - (first >> 24)));
+    const __m256i firstSource = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(first)), zero);
+    const __m256i secondInverse = _mm256_set1_epi16(static_cast<short>(255 - (second >> 24)));
+    const __m256i secondSource = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(second)), zero);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        Blend2x8Avx2(pixels + i, firstInverse, firstSource, secondInverse, secondSource);
+        Blend2x8Avx2(pixels + i + 8, firstInverse, firstSource, secondInverse, secondSource);
+    }
+    if (i + 8 <= count) {
+        Blend2x8Avx2(pixels + i, firstInverse, firstSource, secondInverse, secondSource);
+        i += 8;
+    }
+    // Как и в BlendSpanAvx2: хвост в коде SSE только после сброса верхних половин YMM
+    _mm256_zeroupper();
+    BlendRange2(pixels, i, count, first, second);
+}
+
+#endif
+
+const SpanKernel SCALAR_KERNEL = { "scalar", BlendSpanScalar, BlendSpan2Scalar };
+#if WATER_X86
+const SpanKernel SSE2_KERNEL = { "sse2", BlendSpanSse2, BlendSpan2Sse2 };
+const SpanKernel AVX2_KERNEL = { "avx2", BlendSpanAvx2, BlendSpan2Avx2 };
+#endif
+
+// Выбор самого широкого поддерживаемого ядра
+const SpanKernel& SelectSpanKernel()
+{
+#if WATER_X86
+    const CpuFeatures& cpu = GetCpuFeatures();
+    if (cpu.avx2) {
+        return AVX2_KERNEL;
+    }
+    if (cpu.sse2) {
+        return SSE2_KERNEL;
+    }
+#endif
+    return SCALAR_KERNEL;
+}
+
+} // namespace
+
+// Эталонная скалярная реализация
+void BlendSpanScalar(uint32_t* pixels, size_t count, uint32_t color)
+{
+    BlendRange(pixels, 0, count, color);
+}
+
+// Эталонное наложение двух цветов
+void BlendSpan2Scalar(uint32_t* pixels, size_t count, uint32_t first, uint32_t second)
+{
+    BlendRange2(pixels, 0, count, first, second);
+}
+
+// Лучшее ядро для текущего процессора
+const SpanKernel& GetSpanKernel()
+{
+    static const SpanKernel& kernel = SelectSpanKernel();
+    return kernel;
+}
+
+// Все ядра, поддерживаемые текущим процессором
+size_t GetAvailableSpanKernels(const SpanKernel** kernels, size_t maxKernels)
+{
+    size_t count = 0;
+    if (count < maxKernels) {
+        kernels[count++] = &SCALAR_KERNEL;
+    }
+#if WATER_X86
+    const CpuFeatures& cpu = GetCpuFeatures();
+    if (cpu.sse2 && count < maxKernels) {
+        kernels[count++] = &SSE2_KERNEL;
+    }
+    if (cpu.avx2 && count < maxKernels) {
+        kernels[count++] = &AVX2_KERNEL;
+    }
+#endif
+    return count;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Ядро заливки отрезка строки одним цветом поверх кадра (внутренность круга):
+// pixels[i] = color + pixels[i] * (255 - alpha(color)) / 255 по каждой компоненте
+// с округлением, как у BlendOver с полным покрытием. color - предумноженный цвет
+// в формате пикселя кадра (0xAARRGGBB). Все ядра дают побитово один результат
+typedef void (*BlendSpanFn)(uint32_t* pixels, size_t count, uint32_t color);
+
+// Ядро наложения двух цветов подряд за один проход (внутренность волны под обоими кругами):
+// результат побитово равен blendSpan(first), затем blendSpan(second), но пиксель
+// читается и пишется один раз, а промежуточное значение остаётся в регистрах
+typedef void (*BlendSpan2Fn)(uint32_t* pixels, size_t count, uint32_t first, uint32_t second);
+
+struct SpanKernel {
+    const char* name;       // Имя набора команд
+    BlendSpanFn blendSpan;
+    BlendSpan2Fn blendSpan2;
+};
+
+// Эталонные скалярные реализации
+void BlendSpanScalar(uint32_t* pixels, size_t count, uint32_t color);
+void BlendSpan2Scalar(uint32_t* pixels, size_t count, uint32_t first, uint32_t second);
+
+// Лучшее ядро для текущего процессора (выбирается один раз по CPUID)
+const SpanKernel& GetSpanKernel();
+
+// Все ядра, поддерживаемые текущим процессором, от скалярного к самому широкому.
+// Возвращает их количество
+size_t GetAvailableSpanKernels(const SpanKernel** kernels, size_t maxKernels);
@@ -0,0 +1,184 @@
+#include "ThreadPool.h"
+#include "TraceZones.h"
+
+#include <string>
+
+// Конструктор
+ThreadPool::ThreadPool(size_t threadCount) :
+    m_invoke(nullptr),
+    m_context(nullptr),
+    m_pending(0),
+    m_generation(0),
+    m_started(0),
+    m_stop(false)
+{
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 1; i < threadCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+
+    // Ожидание запуска всех потоков, чтобы их подготовка (имя и буфер зон времени)
+    // не выделяла память посреди первых кадров
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_started == m_workers.size(); });
+}
+
+// Деструктор
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+// Резервирование очередей
+void ThreadPool::Reserve(size_t count, size_t grain)
+{
+    if (grain == 0) {
+        grain = 1;
+    }
+
+    // Очередь получает не больше ceil(taskCount / queueCount) кусков (см. Run)
+    size_t taskCount = (count + grain - 1) / grain;
+    size_t perQueue = (taskCount + m_queues.size() - 1) / m_queues.size();
+    for (std::unique_ptr<WorkerQueue>& queue : m_queues) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->tasks.reserve(perQueue);
+    }
+}
+
+// Раскладка задания по очередям и участие в нём
+void ThreadPool::Run(InvokeFn invoke, void* context, size_t count, size_t grain)
+{
+    if (count == 0) {
+        return;
+    }
+    if (grain == 0) {
+        grain = 1;
+    }
+
+    // Однопоточный пул выполняет всё на месте
+    size_t taskCount = (count + grain - 1) / grain;
+    if (m_workers.empty() || taskCount == 1) {
+        invoke(context, 0, count);
+        return;
+    }
+
+    m_invoke = invoke;
+    m_context = context;
+    m_pending.store(taskCount, std::memory_order_relaxed);
+
+    // Соседние куски попадают в одну очередь: пока нет перехвата,
+    // каждый поток обходит непрерывную полосу диапазона
+    size_t queueCount = m_queues.size();
+    for (size_t q = 0; q < queueCount; ++q) {
+        WorkerQueue& queue = *m_queues[q];
+        size_t firstTask = taskCount * q / queueCount;
+        size_t lastTask = taskCount * (q + 1) / queueCount;
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.resize(lastTask - firstTask);
+        for (size_t t = firstTask; t < lastTask; ++t) {
+            size_t begin = t * grain;
+            size_t end = begin + grain < count ? begin + grain : count;
+            // Владелец берёт куски с конца, поэтому кладём их в обратном порядке
+            queue.tasks[lastTask - 1 - t] = { begin, end };
+        }
+        queue.head = 0;
+        queue.tail = queue.tasks.size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    while (RunOneTask(0)) {
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_pending.load(std::memory_order_acquire) == 0; });
+}
+
+// Выполнение одного куска
+bool ThreadPool::RunOneTask(size_t self)
+{
+    Task task = { 0, 0 };
+    bool found = false;
+
+    // Сначала своя очередь (с конца), затем чужие (с начала)
+    size_t queueCount = m_queues.size();
+    for (size_t i = 0; i < queueCount && !found; ++i) {
+        WorkerQueue& queue = *m_queues[(self + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.head == queue.tail) {
+            continue;
+        }
+        if (i == 0) {
+            task = queue.tasks[--queue.tail];
+        } else {
+            task = queue.tasks[queue.head++];
+        }
+        found = true;
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    {
+        WATER_TRACE_ZONE("ThreadPool::Task");
+        m_invoke(m_context, task.begin, task.end);
+    }
+
+    // Последний кусок будит вызывающий поток
+    if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done.notify_all();
+    }
+    return true;
+}
+
+// Цикл рабочего потока
+void ThreadPool::WorkerLoop(size_t self)
+{
+    GetZoneRecorder().SetThreadName(("ThreadPool " + std::to_string(self)).c_str());
+
+    // Поток готов: память для его зон времени уже выделена
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_started;
+    }
+    m_done.notify_all();
+
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_stop || m_generation != seenGeneration; });
+            if (m_stop) {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        while (RunOneTask(self)) {
+        }
+    }
+}
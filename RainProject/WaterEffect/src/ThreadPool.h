@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Пул потоков с перехватом работы (work stealing).
+// ParallelFor делит диапазон на куски, раскладывает их по очередям потоков,
+// после чего каждый поток берёт куски из конца своей очереди, а опустошив её,
+// забирает куски из начала чужих очередей. Вызывающий поток тоже участвует в работе.
+// Одновременно выполняется только одно задание; куски хранятся без выделения
+// памяти в установившемся режиме
+class ThreadPool {
+public:
+    // threadCount - общее число потоков, включая вызывающий (0 - по числу ядер)
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Общее число потоков, включая вызывающий
+    size_t ThreadCount() const { return m_queues.size(); }
+
+    // Резервирование очередей под задание из count элементов кусками по grain,
+    // чтобы первые задания такого размера не выделяли память
+    void Reserve(size_t count, size_t grain);
+
+    // Выполнение body(begin, end) для кусков диапазона [0, count) размером не более grain.
+    // Возвращает управление, когда все куски обработаны
+    template <typename Body>
+    void ParallelFor(size_t count, size_t grain, Body&& body);
+
+private:
+    typedef void (*InvokeFn)(void* context, size_t begin, size_t end);
+
+    // Кусок работы
+    struct Task {
+        size_t begin;
+        size_t end;
+    };
+
+    // Очередь кусков одного потока
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::vector<Task> tasks;
+        size_t head = 0;    // Отсюда забирают чужие потоки
+        size_t tail = 0;    // Отсюда берёт сам владелец
+    };
+
+    // Раскладка задания по очередям и участие в нём до завершения
+    void Run(InvokeFn invoke, void* context, size_t count, size_t grain);
+
+    // Выполнение одного куска из своей или чужой очереди; false - работы нет
+    bool RunOneTask(size_t self);
+
+    // Цикл рабочего потока
+    void WorkerLoop(size_t self);
+
+private:
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;  // Очередь 0 принадлежит вызывающему потоку
+    std::vector<std::thread> m_workers;                  // Рабочие потоки 1..N-1
+
+    InvokeFn m_invoke;                  // Тело текущего задания
+    void* m_context;                    // Контекст тела
+    std::atomic<size_t> m_pending;      // Невыполненные куски текущего задания
+
+    std::mutex m_mutex;                 // Защищает m_generation, m_started и m_stop
+    std::condition_variable m_wake;     // Пробуждение рабочих при новом задании
+    std::condition_variable m_done;     // Уведомление о завершении задания и о запуске потока
+    uint64_t m_generation;              // Номер текущего задания
+    size_t m_started;                   // Рабочих потоков, завершивших подготовку
+    bool m_stop;                        // Пул останавливается
+};
+
+// Выполнение тела для кусков диапазона
+template <typename Body>
+void ThreadPool::ParallelFor(size_t count, size_t grain, Body&& body)
+{
+    typedef typename std::remove_reference<Body>::type BodyType;
+    InvokeFn invoke = [](void* context, size_t begin, size_t end) {
+        (*static_cast<BodyType*>(context))(begin, end);
+    };
+    Run(invoke, const_cast<void*>(static_cast<const void*>(&body)), count, grain);
+}
@@ -0,0 +1,168 @@
+#include "TileRenderer.h"
+#include "DiscRasterizer.h"
+#include "TraceZones.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Диапазон плиток [x0, x1) x [y0, y1)
+struct TileRange {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+};
+
+// Плитки, которые покрывают прямоугольник пикселей (пустой диапазон для пустого)
+TileRange RectTiles(const PixelRect& rect)
+{
+    TileRange range = { 0, 0, 0, 0 };
+    if (rect.Empty()) {
+        return range;
+    }
+
+    const int tile = TileRenderer::TILE_SIZE;
+    range.x0 = rect.x0 / tile;
+    range.y0 = rect.y0 / tile;
+    range.x1 = (rect.x1 + tile - 1) / tile;
+    range.y1 = (rect.y1 + tile - 1) / tile;
+    return range;
+}
+
+} // namespace
+
+// Конструктор
+TileRenderer::TileRenderer() :
+    m_width(0),
+    m_height(0),
+    m_tilesX(0),
+    m_tilesY(0),
+    m_area(EmptyRect()),
+    m_binned(0),
+    m_tilesPerWave(1)
+{
+}
+
+// Подготовка сетки плиток
+void TileRenderer::Resize(int width, int height)
+{
+    m_width = width > 0 ? width : 0;
+    m_height = height > 0 ? height : 0;
+    m_tilesX = (m_width + TILE_SIZE - 1) / TILE_SIZE;
+    m_tilesY = (m_height + TILE_SIZE - 1) / TILE_SIZE;
+    m_binStart.assign(TileCount() + 1, 0);
+    m_binCursor.assign(TileCount(), 0);
+    m_area = EmptyRect();
+    m_binned = 0;
+}
+
+// Запас места в раскладке
+void TileRenderer::Reserve(size_t waves, float maxRadius)
+{
+    // Описанный квадрат внешнего круга занимает 2 * (radius + 0.5) + 1 пикселей по каждой оси
+    // и в худшем случае задевает ещё одну плитку из-за сдвига относительно сетки
+    size_t side = static_cast<size_t>(std::ceil(2.0f * maxRadius + 2.0f)) / TILE_SIZE + 2;
+    m_tilesPerWave = std::max(m_tilesPerWave, side * side);
+    if (m_binEntries.size() < waves * m_tilesPerWave) {
+        m_binEntries.resize(waves * m_tilesPerWave);
+    }
+}
+
+// Пиксели волны внутри области перерисовки
+PixelRect TileRenderer::WaveArea(const WaveDrawList& list, size_t wave) const
+{
+    PixelRect bounds = UnionRect(DiscBounds(list.Outer(wave), m_width, m_height),
+                                 DiscBounds(list.Inner(wave), m_width, m_height));
+    return IntersectRect(bounds, m_area);
+}
+
+// Раскладка волн по плиткам
+void TileRenderer::Bin(const WaveDrawList& list)
+{
+    WATER_TRACE_ZONE("TileRenderer::Bin");
+
+    // Подсчёт попаданий в каждую плитку
+    std::fill(m_binStart.begin(), m_binStart.end(), 0u);
+    for (size_t wave = 0; wave < list.WaveCount(); ++wave) {
+        TileRange range = RectTiles(WaveArea(list, wave));
+        for (int ty = range.y0; ty < range.y1; ++ty) {
+            for (int tx = range.x0; tx < range.x1; ++tx) {
+                ++m_binStart[static_cast<size_t>(ty) * m_tilesX + tx + 1];
+            }
+        }
+    }
+
+    // Начала списков плиток
+    for (size_t tile = 0; tile < TileCount(); ++tile) {
+        m_binStart[tile + 1] += m_binStart[tile];
+        m_binCursor[tile] = m_binStart[tile];
+    }
+    m_binned = m_binStart[TileCount()];
+    if (m_binEntries.size() < m_binned) {
+        // Запас под новое наибольшее число волн с наибольшим размером из Reserve
+        m_binEntries.resize(std::max(m_binned, list.WaveCount() * m_tilesPerWave));
+    }
+
+    // Размещение номеров волн: проход по списку по порядку сохраняет порядок наложения
+    for (size_t index = 0; index < list.WaveCount(); ++index) {
+        TileRange range = RectTiles(WaveArea(list, index));
+        for (int ty = range.y0; ty < range.y1; ++ty) {
+            for (int tx = range.x0; tx < range.x1; ++tx) {
+                m_binEntries[m_binCursor[static_cast<size_t>(ty) * m_tilesX + tx]++] = static_cast<uint32_t>(index);
+            }
+        }
+    }
+}
+
+// Очистка и заливка одной плитки
+void TileRenderer::RenderTile(Framebuffer& frame, const WaveDrawList& list, size_t tile) const
+{
+    // Плитка у края области перерисовки обрабатывается только внутри области
+    int x0 = static_cast<int>(tile % static_cast<size_t>(m_tilesX)) * TILE_SIZE;
+    int y0 = static_cast<int>(tile / static_cast<size_t>(m_tilesX)) * TILE_SIZE;
+    PixelRect clip = IntersectRect(PixelRect{ x0, y0, x0 + TILE_SIZE, y0 + TILE_SIZE }, m_area);
+
+    frame.ClearRect(clip.x0, clip.y0, clip.x1, clip.y1);
+    for (uint32_t entry = m_binStart[tile]; entry < m_binStart[tile + 1]; ++entry) {
+        size_t wave = m_binEntries[entry];
+        FillWaveClipped(frame, list.Outer(wave), list.Inner(wave), clip.x0, clip.y0, clip.x1, clip.y1);
+    }
+}
+
+// Кадр целиком
+void TileRenderer::Render(Framebuffer& frame, const WaveDrawList& list, ThreadPool* pool)
+{
+    Render(frame, list, pool, PixelRect{ 0, 0, m_width, m_height });
+}
+
+// Перерисовка области кадра
+void TileRenderer::Render(Framebuffer& frame, const WaveDrawList& list, ThreadPool* pool, const PixelRect& area)
+{
+    WATER_TRACE_ZONE("TileRenderer::Render");
+
+    m_area = IntersectRect(area, PixelRect{ 0, 0, m_width, m_height });
+    if (m_area.Empty()) {
+        m_binned = 0;
+        return;
+    }
+    Bin(list);
+
+    // Обходятся только плитки, которые пересекает область
+    TileRange range = RectTiles(m_area);
+    size_t columns = static_cast<size_t>(range.x1 - range.x0);
+    size_t tiles = columns * static_cast<size_t>(range.y1 - range.y0);
+    auto renderTiles = [&](size_t begin, size_t end) {
+        for (size_t index = begin; index < end; ++index) {
+            size_t ty = static_cast<size_t>(range.y0) + index / columns;
+            size_t tx = static_cast<size_t>(range.x0) + index % columns;
+            RenderTile(frame, list, ty * static_cast<size_t>(m_tilesX) + tx);
+        }
+    };
+    if (pool && pool->ThreadCount() > 1) {
+        pool->ParallelFor(tiles, TILES_PER_TASK, renderTiles);
+    } else {
+        renderTiles(0, tiles);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DirtyRegion.h"
+#include "Framebuffer.h"
+#include "ThreadPool.h"
+#include "WaveDrawList.h"
+
+// Многопоточная программная отрисовка кадра по плиткам.
+// Описанный квадрат каждой волны раскладывается по плиткам TILE_SIZE x TILE_SIZE
+// (в каждой плитке волны лежат в порядке списка, то есть в порядке создания),
+// затем плитки очищаются и заливаются независимо на потоках пула (оба круга волны
+// за один проход, FillWaveClipped). Каждую плитку пишет один поток, поэтому кадр
+// не нуждается в блокировках, а порядок наложения внутри плитки тот же, что у Render():
+// кадр совпадает с RasterizeDrawList побитово.
+// Раскладка хранится в массивах, которые растут только при новом наибольшем числе волн
+class TileRenderer {
+public:
+    TileRenderer();
+
+    // Подготовка сетки плиток под кадр заданного размера
+    void Resize(int width, int height);
+
+    // Запас места в раскладке под waves волн радиусом не больше maxRadius,
+    // чтобы кадры с таким числом волн не выделяли память
+    void Reserve(size_t waves, float maxRadius);
+
+    // Кадр целиком: очистка до прозрачного и заливка всех волн списка.
+    // Кадр должен иметь размер из Resize; pool == nullptr - все плитки в вызывающем потоке.
+    // Плитка остаётся в кэше, пока на неё накладываются круги, поэтому на кадрах
+    // с большим числом волн плитки выгодны и в одном потоке
+    void Render(Framebuffer& frame, const WaveDrawList& list, ThreadPool* pool);
+
+    // Перерисовка только области area (DirtyRegion): она очищается и заливается заново,
+    // остальные пиксели кадра не трогаются. Пустая область - кадр не меняется вовсе
+    void Render(Framebuffer& frame, const WaveDrawList& list, ThreadPool* pool, const PixelRect& area);
+
+    int TilesX() const { return m_tilesX; }
+    int TilesY() const { return m_tilesY; }
+    size_t TileCount() const { return static_cast<size_t>(m_tilesX) * static_cast<size_t>(m_tilesY); }
+
+    // Попаданий волн в плитки в последнем кадре
+    size_t BinnedCount() const { return m_binned; }
+
+    // Пикселей, очищенных и перерисованных в последнем кадре
+    uint64_t TouchedPixels() const { return m_area.Area(); }
+
+    // Параметры разбиения
+    static constexpr int TILE_SIZE = 64;            // Сторона плитки в пикселях
+    static constexpr size_t TILES_PER_TASK = 1;     // Плиток в одном куске работы пула
+
+private:
+    // Пиксели волны внутри области перерисовки
+    PixelRect WaveArea(const WaveDrawList& list, size_t wave) const;
+
+    // Раскладка волн по плиткам области перерисовки (подсчёт и размещение, порядок волн сохраняется)
+    void Bin(const WaveDrawList& list);
+
+    // Очистка и заливка части плитки внутри области перерисовки
+    void RenderTile(Framebuffer& frame, const WaveDrawList& list, size_t tile) const;
+
+private:
+    int m_width;
+    int m_height;
+    int m_tilesX;
+    int m_tilesY;
+    PixelRect m_area;                      // Область перерисовки текущего кадра
+    std::vector<uint32_t> m_binStart;      // Начало списка каждой плитки в m_binEntries (+ конец)
+    std::vector<uint32_t> m_binCursor;     // Следующая свободная позиция при размещении
+    std::vector<uint32_t> m_binEntries;    // Номера волн по плиткам подряд
+    size_t m_binned;                       // Попаданий в последнем кадре
+    size_t m_tilesPerWave;                 // Наибольшее число плиток волны из Reserve
+};
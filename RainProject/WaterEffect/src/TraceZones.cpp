@@ -0,0 +1,133 @@
+#include "TraceZones.h"
+
+#include <cstdio>
+
+// Конструктор
+ZoneRecorder::ZoneRecorder() :
+    m_start(std::chrono::steady_clock::now()),
+    m_enabled(false)
+{
+    static_assert((THREAD_CAPACITY & (THREAD_CAPACITY - 1)) == 0, "Ёмкость буфера зон должна быть степенью двойки");
+}
+
+// Буфер вызывающего потока
+ZoneRecorder::ThreadBuffer& ZoneRecorder::LocalBuffer()
+{
+    // Буферы не удаляются до завершения программы, поэтому указатель остаётся верным
+    // и после завершения потока, а зоны завершившихся потоков попадают в экспорт
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers.emplace_back(new ThreadBuffer());
+        buffer = m_buffers.back().get();
+        buffer->threadId = static_cast<uint32_t>(m_buffers.size());
+        buffer->name = "Поток " + std::to_string(buffer->threadId);
+        buffer->count.store(0, std::memory_order_relaxed);
+    }
+    return *buffer;
+}
+
+// Запись завершённой зоны
+void ZoneRecorder::Record(const char* name, uint64_t beginNs, uint64_t endNs)
+{
+    ThreadBuffer& buffer = LocalBuffer();
+    if (!buffer.events) {
+        buffer.events.reset(new Event[THREAD_CAPACITY]);
+    }
+
+    uint64_t count = buffer.count.load(std::memory_order_relaxed);
+    buffer.events[count & (THREAD_CAPACITY - 1)] = Event{ name, beginNs, endNs - beginNs };
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+// Имя вызывающего потока
+void ZoneRecorder::SetThreadName(const char* name)
+{
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    buffer.name = name;
+}
+
+namespace {
+
+// Вывод строки JSON с экранированием
+void WriteJsonString(FILE* file, const char* text)
+{
+    std::fputc('"', file);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+            std::fputc(*c, file);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            std::fprintf(file, "\\u%04x", static_cast<unsigned>(*c));
+        } else {
+            std::fputc(*c, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+} // namespace
+
+// Сохранение зон в формате Chrome Trace Event
+bool ZoneRecorder::ExportChromeJson(const char* path)
+{
+    FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+        // Имя потока - событие метаданных
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                     first ? "" : ",\n", buffer->threadId);
+        WriteJsonString(file, buffer->name.c_str());
+        std::fprintf(file, "}}");
+        first = false;
+
+        // Завершённые зоны - события "X" с началом и длительностью в микросекундах
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        uint64_t begin = count > THREAD_CAPACITY ? count - THREAD_CAPACITY : 0;
+        for (uint64_t i = begin; i < count; ++i) {
+            const Event& event = buffer->events[i & (THREAD_CAPACITY - 1)];
+            std::fprintf(file, ",\n{\"name\":");
+            WriteJsonString(file, event.name);
+            std::fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         buffer->threadId, static_cast<double>(event.beginNs) / 1000.0,
+                         static_cast<double>(event.durationNs) / 1000.0);
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
+
+// Число зон во всех буферах
+size_t ZoneRecorder::EventCount()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t total = 0;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        total += static_cast<size_t>(count < THREAD_CAPACITY ? count : THREAD_CAPACITY);
+    }
+    return total;
+}
+
+// Очистка буферов
+void ZoneRecorder::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+        buffer->count.store(0, std::memory_order_release);
+    }
+}
+
+// Общая запись зон
+ZoneRecorder& GetZoneRecorder()
+{
+    static ZoneRecorder recorder;
+    return recorder;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Запись зон времени для просмотра в Chrome Tracing / Perfetto.
+// Зона - участок кода с именем, моментом начала и длительностью. Каждый поток пишет
+// зоны в собственный кольцевой буфер без блокировок (старые зоны затираются новыми),
+// а ExportChromeJson собирает буферы всех потоков в файл формата Chrome Trace Event.
+// Выключенная запись стоит одной проверки атомарной переменной на зону;
+// при сборке с WATER_TRACE_ZONES=0 зоны вырезаются целиком
+#ifndef WATER_TRACE_ZONES
+#define WATER_TRACE_ZONES 1
+#endif
+
+class ZoneRecorder {
+public:
+    ZoneRecorder();
+
+    ZoneRecorder(const ZoneRecorder&) = delete;
+    ZoneRecorder& operator=(const ZoneRecorder&) = delete;
+
+    // Включение и выключение записи
+    void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Время от создания записи, наносекунды
+    uint64_t Now() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_start).count());
+    }
+
+    // Запись завершённой зоны в буфер вызывающего потока
+    void Record(const char* name, uint64_t beginNs, uint64_t endNs);
+
+    // Имя вызывающего потока на временной шкале
+    void SetThreadName(const char* name);
+
+    // Сохранение зон всех потоков в формате Chrome Trace Event (JSON).
+    // Вызывается, когда потоки не пишут зоны (запись выключена или работа завершена)
+    bool ExportChromeJson(const char* path);
+
+    // Число зон во всех буферах и очистка буферов
+    size_t EventCount();
+    void Clear();
+
+    // Ёмкость буфера одного потока, зон
+    static constexpr size_t THREAD_CAPACITY = 64 * 1024;
+
+private:
+    // Завершённая зона
+    struct Event {
+        const char* name;       // Строка со статическим временем жизни
+        uint64_t beginNs;
+        uint64_t durationNs;
+    };
+
+    // Буфер одного потока
+    struct ThreadBuffer {
+        uint32_t threadId;                  // Номер потока на временной шкале
+        std::string name;                   // Имя потока
+        std::unique_ptr<Event[]> events;    // Кольцо зон (выделяется при первой записи)
+        std::atomic<uint64_t> count;        // Записано зон с начала
+    };
+
+    // Буфер вызывающего потока (создаётся при первом обращении)
+    ThreadBuffer& LocalBuffer();
+
+private:
+    std::chrono::steady_clock::time_point m_start;          // Начало отсчёта времени
+    std::atomic<bool> m_enabled;                            // Запись включена
+    std::mutex m_mutex;                                     // Защищает список буферов
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;   // Буферы всех потоков
+};
+
+// Общая запись зон
+ZoneRecorder& GetZoneRecorder();
+
+// Зона на время жизни объекта
+class TraceZone {
+public:
+    explicit TraceZone(const char* name) :
+        m_name(GetZoneRecorder().IsEnabled() ? name : nullptr),
+        m_beginNs(m_name ? GetZoneRecorder().Now() : 0)
+    {
+    }
+
+    ~TraceZone() {
+        if (m_name) {
+            GetZoneRecorder().Record(m_name, m_beginNs, GetZoneRecorder().Now());
+        }
+    }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_beginNs;
+};
+
+// Зона до конца текущего блока: WATER_TRACE_ZONE("Update").
+// Имя должно быть строковым литералом
+#define WATER_TRACE_CONCAT_INNER(a, b) a##b
+#define WATER_TRACE_CONCAT(a, b) WATER_TRACE_CONCAT_INNER(a, b)
+
+#if WATER_TRACE_ZONES
+#define WATER_TRACE_ZONE(name) TraceZone WATER_TRACE_CONCAT(traceZone_, __LINE__)(name)
+#else
+#define WATER_TRACE_ZONE(name) do {} while (0)
+#endif
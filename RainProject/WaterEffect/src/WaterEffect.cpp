@@ -1,10 +1,12 @@
 #include "WaterEffect.h"
+#include "AllocationTracker.h"
+#include "DiscRasterizer.h"
+#include "Logger.h"
+#include "TraceZones.h"
 #include <chrono>
 #include <algorithm>
 #include <windowsx.h>
 #include <string>
-#include <iostream>
-#include <fstream>
 #include <ctime>
 #include <random>
 
@@ -14,8 +16,73 @@ constexpr int TIMER_ID = 1;
 // Идентификатор таймера для тестовой волны
 constexpr int TEST_WAVE_TIMER_ID = 2;
 
-// Путь к лог-файлу
-const std::string LOG_FILE_PATH = "./water_effect_log.txt";
+// Путь к лог-файлу (сегменты water_effect_log.0.txt, water_effect_log.1.txt, ...)
+const char* const LOG_FILE_PATH = "./water_effect_log.txt";
+
+// Путь к двоичному лог-файлу (читается water_logdecode)
+const char* const LOG_BINARY_FILE_PATH = "./water_effect_log.bin";
+
+// Размер и число сегментов журнала: на диске не больше 16 МБ
+constexpr size_t LOG_SEGMENT_SIZE = 4 * 1024 * 1024;
+constexpr size_t LOG_SEGMENT_COUNT = 4;
+
+// Время от момента start, наносекунды
+uint64_t ElapsedNanoseconds(std::chrono::steady_clock::time_point start)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+// Категории сообщений окна для ограничения журнала
+enum MessageCategory : size_t {
+    MESSAGE_PAINT,
+    MESSAGE_MOUSE_MOVE,
+    MESSAGE_INPUT,
+    MESSAGE_TIMER,
+    MESSAGE_OTHER,          // Редкие сообщения пишутся все
+    MESSAGE_CATEGORY_COUNT
+};
+
+// Имена категорий для сводок журнала
+const char* const MESSAGE_CATEGORY_NAMES[MESSAGE_CATEGORY_COUNT] = {
+    "WM_PAINT", "WM_MOUSEMOVE", "WM_INPUT", "WM_TIMER", "прочие"
+};
+
+// Ограничения категорий: записей в секунду, запас, каждая N-я сверх запаса.
+// Таймер анимации и отрисовка идут с частотой кадров, мышь и Raw Input - сотни раз в секунду
+const LogThrottle::Limit MESSAGE_LIMITS[MESSAGE_CATEGORY_COUNT] = {
+    { 2.0, 10.0, 60 },      // WM_PAINT
+    { 2.0, 20.0, 100 },     // WM_MOUSEMOVE
+    { 2.0, 20.0, 100 },     // WM_INPUT
+    { 2.0, 10.0, 60 },      // WM_TIMER
+    { 0.0, 0.0, 1 },        // Прочие
+};
+
+// Категория сообщения окна
+MessageCategory CategoryOf(UINT uMsg)
+{
+    switch (uMsg) {
+        case WM_PAINT: return MESSAGE_PAINT;
+        case WM_MOUSEMOVE: return MESSAGE_MOUSE_MOVE;
+        case WM_INPUT: return MESSAGE_INPUT;
+        case WM_TIMER: return MESSAGE_TIMER;
+    }
+    return MESSAGE_OTHER;
+}
+
+// Имя сообщения окна для журнала (пустая строка для неизвестных)
+const char* MessageName(UINT uMsg)
+{
+    switch (uMsg) {
+        case WM_PAINT: return " (WM_PAINT)";
+        case WM_LBUTTONDOWN: return " (WM_LBUTTONDOWN)";
+        case WM_MOUSEMOVE: return " (WM_MOUSEMOVE)";
+        case WM_TIMER: return " (WM_TIMER)";
+        case WM_DESTROY: return " (WM_DESTROY)";
+        case WM_INPUT: return " (WM_INPUT)";
+    }
+    return "";
+}
 
 // Конструктор
 WaterEffect::WaterEffect() : 
@@ -23,20 +90,25 @@ WaterEffect::WaterEffect() :
     m_pD2DFactory(nullptr),
     m_pRenderTarget(nullptr),
     m_pBrush(nullptr),
+    m_pHeightBitmap(nullptr),
+    m_heightUpload(EmptyRect()),
+    m_messageLog(MESSAGE_CATEGORY_COUNT),
+    m_logFormat(LogFormat::Text),
+    m_frameStats(new FrameStats()),
+    m_hasLastFrame(false),
+    m_lastFrameAllocations(0),
     m_screenWidth(0),
     m_screenHeight(0),
-    m_timerActive(false)
+    m_timerActive(false),
+    m_animationSleeping(false)
 {
+    for (size_t category = 0; category < MESSAGE_CATEGORY_COUNT; ++category) {
+        m_messageLog.SetLimit(category, MESSAGE_LIMITS[category]);
+    }
+
     // Инициализируем генератор случайных чисел
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
     
-    // Открываем файл для логов
-    std::ofstream logFile(LOG_FILE_PATH, std::ios::out);
-    if (logFile.is_open()) {
-        logFile << "WaterEffect инициализирован" << std::endl;
-        logFile.close();
-    }
-    
     // Удаляем блокирующий диалог
     // MessageBoxW(nullptr, L"WaterEffect инициализирован", L"Статус", MB_OK);
 }
@@ -59,11 +131,36 @@ WaterEffect::~WaterEffect()
         m_pD2DFactory->Release();
         m_pD2DFactory = nullptr;
     }
+
+    // Итоговые процентили времени кадра и остаток журнала
+    ReportFrameStats();
+    GetLogger().Close();
+
+    // Сохраняем зоны времени для просмотра в Perfetto
+    if (!m_zoneTracePath.empty()) {
+        GetZoneRecorder().SetEnabled(false);
+        GetZoneRecorder().ExportChromeJson(m_zoneTracePath.c_str());
+    }
+}
+
+// Запись зон времени с сохранением при завершении
+void WaterEffect::SetZoneTracePath(const char* path)
+{
+    m_zoneTracePath = path ? path : "";
+    GetZoneRecorder().SetThreadName("Окно");
+    GetZoneRecorder().SetEnabled(!m_zoneTracePath.empty());
 }
 
 // Инициализация приложения
 bool WaterEffect::Initialize(HINSTANCE hInstance)
 {
+    // Открываем журнал в выбранном формате: сегменты фиксированного размера пишутся по кругу
+    // через отображение в память и остаются открытыми до завершения работы,
+    // записи уходят в них из фонового потока
+    GetLogger().OpenRotating(m_logFormat == LogFormat::Binary ? LOG_BINARY_FILE_PATH : LOG_FILE_PATH, m_logFormat,
+                             LOG_SEGMENT_SIZE, LOG_SEGMENT_COUNT);
+    WATER_LOG_EVENT(EffectInitialized);
+
     // Регистрируем класс окна
     if (!RegisterWindowClass(hInstance)) {
         MessageBoxW(nullptr, L"Не удалось зарегистрировать класс окна", L"Ошибка", MB_OK | MB_ICONERROR);
@@ -74,6 +171,22 @@ bool WaterEffect::Initialize(HINSTANCE hInstance)
     m_screenWidth = GetSystemMetrics(SM_CXSCREEN);
     m_screenHeight = GetSystemMetrics(SM_CYSCREEN);
 
+    // Симуляция охватывает экран целиком; шаг поля высот выполняется на всех ядрах
+    m_simulation.Initialize(m_screenWidth, m_screenHeight);
+    m_drawList.Reserve(WaterSimulation::WAVE_POOL_CAPACITY);
+
+    // Запись трассы входных событий для последующего воспроизведения
+    if (!m_tracePath.empty()) {
+        TraceHeader header = {};
+        header.screenWidth = static_cast<uint32_t>(m_screenWidth);
+        header.screenHeight = static_cast<uint32_t>(m_screenHeight);
+        header.waveMode = static_cast<uint8_t>(m_simulation.GetWaveMode());
+        header.cellSize = static_cast<uint8_t>(m_simulation.HeightFieldCellSize());
+        if (!m_trace.Open(m_tracePath.c_str(), header)) {
+            MessageBoxW(nullptr, L"Не удалось создать файл трассы", L"Ошибка", MB_OK | MB_ICONERROR);
+        }
+    }
+
     // Создаем окно
     if (!CreateAppWindow()) {
         MessageBoxW(nullptr, L"Не удалось создать окно", L"Ошибка", MB_OK | MB_ICONERROR);
@@ -94,17 +207,9 @@ bool WaterEffect::Initialize(HINSTANCE hInstance)
     rid[0].hwndTarget = m_hwnd;         // Окно, которое будет получать сообщения
 
     if (!RegisterRawInputDevices(rid, 1, sizeof(rid[0]))) {
-        std::ofstream logFile(LOG_FILE_PATH, std::ios::app);
-        if (logFile.is_open()) {
-            logFile << "Не удалось зарегистрировать устройство Raw Input. Код ошибки: " << GetLastError() << std::endl;
-            logFile.close();
-        }
+        WATER_LOG_EVENT(RawInputRegistrationFailed, GetLastError());
     } else {
-        std::ofstream logFile(LOG_FILE_PATH, std::ios::app);
-        if (logFile.is_open()) {
-            logFile << "Устройство Raw Input зарегистрировано успешно" << std::endl;
-            logFile.close();
-        }
+        WATER_LOG_EVENT(RawInputRegistered);
     }
 
     return true;
@@ -117,6 +222,9 @@ int WaterEffect::Run()
     ShowWindow(m_hwnd, SW_SHOW);
     UpdateWindow(m_hwnd);
 
+    // Время, ушедшее на инициализацию, не должно попасть в первый кадр
+    m_simulation.ResetClock();
+
     // Запускаем таймер для анимации
     if (SetTimer(m_hwnd, TIMER_ID, UPDATE_INTERVAL, nullptr) == 0) {
         MessageBoxW(nullptr, L"Не удалось запустить таймер анимации", L"Ошибка", MB_OK | MB_ICONERROR);
@@ -130,11 +238,7 @@ int WaterEffect::Run()
     m_timerActive = true;
 
     // Записываем в лог
-    std::ofstream logFile(LOG_FILE_PATH, std::ios::app);
-    if (logFile.is_open()) {
-        logFile << "Приложение запущено и окно показано" << std::endl;
-        logFile.close();
-    }
+    WATER_LOG_EVENT(AppStarted);
 
     // Добавляем ручное создание первой волны для тестирования
     CreateWave(static_cast<float>(m_screenWidth) / 2, static_cast<float>(m_screenHeight) / 2);
@@ -156,6 +260,9 @@ int WaterEffect::Run()
         m_timerActive = false;
     }
 
+    // Дописываем трассу до конца
+    m_trace.Close();
+
     return static_cast<int>(msg.wParam);
 }
 
@@ -201,11 +308,7 @@ bool WaterEffect::CreateAppWindow()
     if (!m_hwnd) {
         // Оставляем сообщение об ошибке, так как это критично
         MessageBoxW(nullptr, L"Не удалось создать окно", L"Ошибка", MB_OK | MB_ICONERROR);
-        std::ofstream logFile(LOG_FILE_PATH, std::ios::app);
-        if (logFile.is_open()) {
-            logFile << "Не удалось создать окно. Код ошибки: " << GetLastError() << std::endl;
-            logFile.close();
-        }
+        WATER_LOG_EVENT(WindowCreationFailed, GetLastError());
         return false;
     }
 
@@ -216,11 +319,7 @@ bool WaterEffect::CreateAppWindow()
     // MessageBoxW(nullptr, L"Окно создано успешно", L"Статус", MB_OK);
     
     // Записываем в лог
-    std::ofstream logFile(LOG_FILE_PATH, std::ios::app);
-    if (logFile.is_open()) {
-        logFile << "Окно создано успешно" << std::endl;
-        logFile.close();
-    }
+    WATER_LOG_EVENT(WindowCreated);
 
     return true;
 }
@@ -260,13 +359,14 @@ bool WaterEffect::CreateGraphicsResources()
         GetClientRect(m_hwnd, &rc);
         D2D1_SIZE_U size = D2D1::SizeU(rc.right - rc.left, rc.bottom - rc.top);
 
-        // Создаем цель рендеринга для окна
+        // Создаем цель рендеринга для окна. Кадр перерисовывается только в области
+        // DirtyRegion, поэтому остальные пиксели должны сохраняться между кадрами
         hr = m_pD2DFactory->CreateHwndRenderTarget(
             D2D1::RenderTargetProperties(
                 D2D1_RENDER_TARGET_TYPE_DEFAULT,
                 D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
             ),
-            D2D1::HwndRenderTargetProperties(m_hwnd, size),
+            D2D1::HwndRenderTargetProperties(m_hwnd, size, D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS),
             &m_pRenderTarget
         );
 
@@ -277,6 +377,20 @@ bool WaterEffect::CreateGraphicsResources()
                 &m_pBrush
             );
         }
+
+        // Создаем текстуру для поля высот в формате цели рендеринга
+        if (SUCCEEDED(hr) && m_simulation.GetWaveMode() == WaveMode::HeightField) {
+            hr = m_pRenderTarget->CreateBitmap(
+                D2D1::SizeU(m_simulation.GetHeightField().Width(), m_simulation.GetHeightField().Height()),
+                nullptr,
+                0,
+                D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)),
+                &m_pHeightBitmap
+            );
+
+            // Новая текстура пуста - первый кадр передаёт в неё поле высот целиком
+            m_heightUpload = PixelRect{ 0, 0, m_simulation.GetHeightField().Width(), m_simulation.GetHeightField().Height() };
+        }
     }
 
     return SUCCEEDED(hr);
@@ -285,6 +399,12 @@ bool WaterEffect::CreateGraphicsResources()
 // Освобождение графических ресурсов
 void WaterEffect::DiscardGraphicsResources()
 {
+    // Освобождаем текстуру поля высот
+    if (m_pHeightBitmap) {
+        m_pHeightBitmap->Release();
+        m_pHeightBitmap = nullptr;
+    }
+
     // Освобождаем кисть
     if (m_pBrush) {
         m_pBrush->Release();
@@ -301,135 +421,228 @@ void WaterEffect::DiscardGraphicsResources()
 // Обновление анимации
 void WaterEffect::Update()
 {
+    WATER_TRACE_ZONE("WaterEffect::Update");
+    auto updateStart = std::chrono::steady_clock::now();
+
     // Записываем в лог
-    std::ofstream logFile(LOG_FILE_PATH, std::ios::app);
-    if (logFile.is_open()) {
-        logFile << "Update: волн = " << m_waves.size() << std::endl;
-    }
+    WATER_LOG_EVENT(UpdateWaves, m_simulation.WaveCount());
 
-    // Рассчитываем время, прошедшее с предыдущего кадра
-    static auto lastTime = std::chrono::high_resolution_clock::now();
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    float deltaTime = std::chrono::duration_cast<std::chrono::duration<float>>(currentTime - lastTime).count();
-    lastTime = currentTime;
+    m_trace.WriteTick(m_simulation.Now());
+
+    size_t removed = m_simulation.Update();
+    if (removed > 0) {
+        WATER_LOG_EVENT(WavesRemoved, removed);
+    }
 
-    // Ограничиваем deltaTime для предотвращения скачков при отладке
-    deltaTime = std::min(deltaTime, 0.1f);
+    if (m_simulation.GetWaveMode() == WaveMode::HeightField) {
+        WATER_LOG_EVENT(ActiveTiles, m_simulation.GetHeightField().ActiveTileCount(),
+                        m_simulation.GetHeightField().TileCount());
+    }
 
-    // Обновляем все активные волны
-    for (auto it = m_waves.begin(); it != m_waves.end();) {
-        // Увеличиваем радиус волны
-        it->radius += it->speed * deltaTime;
+    m_frameStats->Record(FrameMetric::Update, ElapsedNanoseconds(updateStart));
 
-        // Обновляем прозрачность по мере увеличения радиуса
-        it->opacity = 1.0f - (it->radius / it->maxRadius);
+    // Перерисовываем только изменившуюся часть экрана; если волн не было
+    // ни в прошлом кадре, ни в этом, кадр не строится вовсе
+    if (InvalidateWaves().Empty()) {
+        m_frameStats->RecordPixels(0, static_cast<uint64_t>(m_screenWidth) * static_cast<uint64_t>(m_screenHeight));
+    }
 
-        // Удаляем волны, которые стали полностью прозрачными
-        if (it->opacity <= 0.0f || it->radius >= it->maxRadius) {
-            it = m_waves.erase(it);
-            if (logFile.is_open()) {
-                logFile << "Волна удалена" << std::endl;
-            }
-        } else {
-            ++it;
-        }
+    // Последний кадр очищает экран, после чего анимация засыпает до новой волны
+    if (m_simulation.IsIdle()) {
+        SleepAnimation();
     }
 
-    // Перерисовываем сцену
-    InvalidateRect(m_hwnd, nullptr, FALSE);
+    WATER_LOG_EVENT(InvalidateCalled);
+}
+
+// Пометка изменившейся области окна
+PixelRect WaterEffect::InvalidateWaves()
+{
+    WATER_TRACE_ZONE("InvalidateRect");
+
+    // Поле высот меняется только в закрашенных плитках: на экране перерисовывается
+    // их область, а в текстуру до отрисовки копятся изменённые ячейки
+    PixelRect area = EmptyRect();
+    if (m_simulation.GetWaveMode() == WaveMode::HeightField) {
+        const PixelRect& cells = m_simulation.HeightFrameChanged();
+        m_heightUpload = UnionRect(m_heightUpload, cells);
+        area = UnionRect(m_dirtyRegion.Advance(EmptyRect()),
+                         m_simulation.HeightFieldScreenArea(cells, m_screenWidth, m_screenHeight));
+    } else {
+        m_drawList.Clear();
+        m_simulation.ForEachWave([this](float x, float y, float radius, float opacity) {
+            m_drawList.AddWave(x, y, radius, opacity);
+        });
 
-    if (logFile.is_open()) {
-        logFile << "InvalidateRect вызван" << std::endl;
-        logFile.close();
+        // Стирается и то, что было нарисовано в прошлом кадре, и то, что появилось в этом
+        area = m_dirtyRegion.Advance(DrawListBounds(m_drawList, m_screenWidth, m_screenHeight));
     }
+
+    if (!area.Empty()) {
+        WATER_LOG_EVENT(DirtyRegion, area.x0, area.y0, area.x1, area.y1);
+        RECT rect = { area.x0, area.y0, area.x1, area.y1 };
+        InvalidateRect(m_hwnd, &rect, FALSE);
+    }
+    return area;
 }
 
 // Отрисовка сцены
-void WaterEffect::Render()
+void WaterEffect::Render(const RECT& area)
 {
-    // Записываем в лог
-    std::ofstream logFile(LOG_FILE_PATH, std::ios::app);
-    if (logFile.is_open()) {
-        logFile << "Render: начало отрисовки" << std::endl;
+    WATER_TRACE_ZONE("WaterEffect::Render");
+
+    // Интервал между кадрами и выделения памяти за него (обновление, ввод, журнал);
+    // после сна анимации отсчёт начинается заново
+    auto renderStart = std::chrono::steady_clock::now();
+    uint64_t allocations = AllocationCount();
+    if (m_hasLastFrame) {
+        m_frameStats->Record(FrameMetric::FrameInterval, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(renderStart - m_lastFrameStart).count()));
+        if (ALLOCATION_TRACKING) {
+            m_frameStats->RecordAllocations(allocations - m_lastFrameAllocations);
+        }
     }
+    m_lastFrameStart = renderStart;
+    m_lastFrameAllocations = allocations;
+    m_hasLastFrame = !m_animationSleeping;
 
-    // Создаем графические ресурсы, если они еще не созданы
+    // Записываем в лог
+    WATER_LOG_EVENT(RenderBegin);
+
+    // Создаем графические ресурсы, если они еще не созданы. В новой цели рендеринга
+    // прошлых кадров нет, поэтому первый кадр в ней перерисовывает экран целиком
+    RECT clip = area;
     if (!m_pRenderTarget) {
         HRESULT hr = CreateGraphicsResources();
         if (FAILED(hr)) {
             MessageBoxW(nullptr, L"Не удалось создать ресурсы рендеринга", L"Ошибка", MB_OK);
             return;
         }
+        clip = RECT{ 0, 0, m_screenWidth, m_screenHeight };
     }
 
     // Если ресурсы созданы успешно
     HRESULT hr = S_OK;
 
-    // Начинаем отрисовку
+    // Начинаем отрисовку: очистка и заливка не выходят за область, которую
+    // пометили InvalidateWaves и система, остальной экран остаётся как был
     m_pRenderTarget->BeginDraw();
-    
+    m_pRenderTarget->PushAxisAlignedClip(
+        D2D1::RectF(static_cast<float>(clip.left), static_cast<float>(clip.top),
+                    static_cast<float>(clip.right), static_cast<float>(clip.bottom)),
+        D2D1_ANTIALIAS_MODE_ALIASED
+    );
+    m_frameStats->RecordPixels(
+        static_cast<uint64_t>(std::max<LONG>(clip.right - clip.left, 0)) *
+            static_cast<uint64_t>(std::max<LONG>(clip.bottom - clip.top, 0)),
+        static_cast<uint64_t>(m_screenWidth) * static_cast<uint64_t>(m_screenHeight));
+
     // Очищаем фон (полностью прозрачный)
     m_pRenderTarget->Clear(D2D1::ColorF(0, 0, 0, 0));
 
     // Отрисовываем все активные волны
-    if (logFile.is_open()) {
-        logFile << "Отрисовка " << m_waves.size() << " волн" << std::endl;
-    }
-
-    for (const auto& wave : m_waves) {
-        // Убираем обводку - просто заполняем круг полупрозрачным голубым цветом
-        m_pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::DeepSkyBlue, wave.opacity * 0.3f));
-        m_pRenderTarget->FillEllipse(
-            D2D1::Ellipse(D2D1::Point2F(wave.x, wave.y), wave.radius, wave.radius),
-            m_pBrush
-        );
-        
-        // Дополнительно рисуем более яркий голубой круг в центре для эффекта глубины
-        m_pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::LightBlue, wave.opacity * 0.5f));
-        m_pRenderTarget->FillEllipse(
-            D2D1::Ellipse(D2D1::Point2F(wave.x, wave.y), wave.radius * 0.6f, wave.radius * 0.6f),
-            m_pBrush
-        );
+    if (m_simulation.GetWaveMode() == WaveMode::HeightField) {
+        // Поле высот уже переведено в кадр - в текстуру передаются только изменённые
+        // ячейки, и она растягивается на экран в пределах области отсечения
+        if (m_pHeightBitmap) {
+            const Framebuffer& frame = m_simulation.HeightFrame();
+            int cellSize = m_simulation.HeightFieldCellSize();
+            if (!m_heightUpload.Empty()) {
+                D2D1_RECT_U cells = D2D1::RectU(
+                    static_cast<UINT32>(m_heightUpload.x0), static_cast<UINT32>(m_heightUpload.y0),
+                    static_cast<UINT32>(m_heightUpload.x1), static_cast<UINT32>(m_heightUpload.y1));
+                m_pHeightBitmap->CopyFromMemory(&cells, frame.Row(m_heightUpload.y0) + m_heightUpload.x0,
+                                                static_cast<UINT32>(frame.Pitch()));
+                m_heightUpload = EmptyRect();
+            }
+            m_pRenderTarget->DrawBitmap(
+                m_pHeightBitmap,
+                D2D1::RectF(0.0f, 0.0f,
+                            static_cast<float>(frame.Width() * cellSize),
+                            static_cast<float>(frame.Height() * cellSize)),
+                1.0f,
+                D2D1_BITMAP_INTERPOLATION_MODE_LINEAR
+            );
+        }
+    } else {
+        // Список кругов построен в InvalidateWaves по тому же состоянию волн,
+        // по которому помечена область, поэтому ни один круг не выходит за неё
+        WATER_LOG_EVENT(RenderWaves, m_simulation.WaveCount());
+        DrawDiscs();
     }
+    m_pRenderTarget->PopAxisAlignedClip();
 
     // Завершаем отрисовку
-    hr = m_pRenderTarget->EndDraw();
+    auto presentStart = std::chrono::steady_clock::now();
+    m_frameStats->Record(FrameMetric::Render, static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(presentStart - renderStart).count()));
+    {
+        WATER_TRACE_ZONE("EndDraw");
+        hr = m_pRenderTarget->EndDraw();
+    }
+    m_frameStats->Record(FrameMetric::Present, ElapsedNanoseconds(presentStart));
     
-    if (logFile.is_open()) {
-        logFile << "EndDraw: " << (SUCCEEDED(hr) ? "успешно" : "ошибка") << std::endl;
-        logFile.close();
+    if (SUCCEEDED(hr)) {
+        WATER_LOG_EVENT(EndDrawSucceeded);
+    } else {
+        WATER_LOG_EVENT(EndDrawFailed, hr);
     }
     
-    // Если произошла ошибка, освобождаем ресурсы
+    // Если произошла ошибка, освобождаем ресурсы; новая цель рендеринга
+    // не содержит прошлых кадров, поэтому следующий кадр перерисует экран целиком
     if (FAILED(hr) && hr == (HRESULT)D2DERR_RECREATE_TARGET) {
         DiscardGraphicsResources();
+        m_dirtyRegion.Invalidate(PixelRect{ 0, 0, m_screenWidth, m_screenHeight });
+    }
+}
+
+// Заливка кругов из списка кадра
+void WaterEffect::DrawDiscs()
+{
+    // Direct2D смешивает каждую заливку сам, поэтому волна здесь - два FillEllipse;
+    // программная отрисовка заливает оба круга волны за один проход (FillWave)
+    for (const DiscFill& disc : m_drawList) {
+        m_pBrush->SetColor(D2D1::ColorF(disc.r, disc.g, disc.b, disc.a));
+        m_pRenderTarget->FillEllipse(
+            D2D1::Ellipse(D2D1::Point2F(disc.x, disc.y), disc.radius, disc.radius),
+            m_pBrush
+        );
+    }
+}
+
+// Остановка таймера анимации
+void WaterEffect::SleepAnimation()
+{
+    if (m_timerActive && !m_animationSleeping) {
+        KillTimer(m_hwnd, TIMER_ID);
+        m_animationSleeping = true;
+    }
+}
+
+// Возобновление таймера анимации
+void WaterEffect::WakeAnimation()
+{
+    if (m_timerActive && m_animationSleeping) {
+        SetTimer(m_hwnd, TIMER_ID, UPDATE_INTERVAL, nullptr);
+        m_animationSleeping = false;
     }
 }
 
 // Создание новой волны в указанной точке
-void WaterEffect::CreateWave(float x, float y)
+void WaterEffect::CreateWave(float x, float y, SpawnSource source)
 {
+    WATER_TRACE_ZONE("WaterEffect::CreateWave");
+
     // Записываем в лог
-    std::ofstream logFile(LOG_FILE_PATH, std::ios::app);
-    if (logFile.is_open()) {
-        logFile << "Создание волны в точке: X=" << x << ", Y=" << y << std::endl;
-        logFile.close();
-    }
-
-    // Создаем новую волну
-    Wave wave;
-    wave.x = x;
-    wave.y = y;
-    wave.radius = 0.0f;
-    wave.maxRadius = MAX_WAVE_RADIUS;
-    wave.opacity = 1.0f;
-    wave.speed = WAVE_SPEED * 1.5f; // Увеличиваем скорость для большей заметности
-
-    // Добавляем волну в список
-    m_waves.push_back(wave);
+    WATER_LOG_EVENT(WaveCreated, x, y);
+
+    // Добавляем новую волну
+    m_trace.WriteSpawn(m_simulation.Now(), x, y, source);
+    m_simulation.CreateWave(x, y);
+    WakeAnimation();
     
-    // Принудительно вызываем перерисовку
-    InvalidateRect(m_hwnd, nullptr, FALSE);
+    // Принудительно вызываем перерисовку области новой волны
+    InvalidateWaves();
 }
 
 // Статическая функция обработки сообщений окна
@@ -459,25 +672,70 @@ LRESULT CALLBACK WaterEffect::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LP
     }
 }
 
+// Запись процентилей времени кадра в журнал
+void WaterEffect::ReportFrameStats()
+{
+    for (size_t i = 0; i < static_cast<size_t>(FrameMetric::Count); ++i) {
+        FrameMetric metric = static_cast<FrameMetric>(i);
+        LatencyHistogram::Summary summary = m_frameStats->Histogram(metric).Summarize();
+        if (summary.count > 0) {
+            WATER_LOG_EVENT(FrameStatsReport, FrameStats::MetricName(metric),
+                            static_cast<unsigned long long>(summary.count),
+                            static_cast<double>(summary.p50) / 1000.0, static_cast<double>(summary.p99) / 1000.0,
+                            static_cast<double>(summary.p999) / 1000.0, static_cast<double>(summary.max) / 1000.0);
+        }
+    }
+
+    FrameStats::AllocationSummary allocations = m_frameStats->Allocations();
+    if (allocations.frames > 0) {
+        WATER_LOG_EVENT(FrameAllocationsReport, static_cast<unsigned long long>(allocations.frames),
+                        static_cast<unsigned long long>(allocations.framesWithAllocations),
+                        static_cast<unsigned long long>(allocations.allocations),
+                        static_cast<unsigned long long>(allocations.maxPerFrame));
+    }
+
+    FrameStats::PixelSummary pixels = m_frameStats->Pixels();
+    if (pixels.frames > 0) {
+        WATER_LOG_EVENT(FramePixelsReport, static_cast<unsigned long long>(pixels.frames),
+                        static_cast<unsigned long long>(pixels.skippedFrames),
+                        static_cast<double>(pixels.touched) / static_cast<double>(pixels.frames),
+                        pixels.framePixels > 0
+                            ? 100.0 * static_cast<double>(pixels.touched) / static_cast<double>(pixels.framePixels)
+                            : 0.0,
+                        static_cast<unsigned long long>(pixels.maxPerFrame));
+    }
+}
+
+// Решение, писать ли в журнал очередное сообщение окна
+bool WaterEffect::ShouldLogMessage(UINT uMsg)
+{
+    // Если записи о сообщениях всё равно отсекаются фильтром уровня, ограничитель не нужен
+    if constexpr (LogMessageLevel(LogMessageId::MessageReceived) < LOG_MIN_LEVEL) {
+        UNREFERENCED_PARAMETER(uMsg);
+        return false;
+    } else {
+        if (!GetLogger().IsEnabled(LogMessageLevel(LogMessageId::MessageReceived))) {
+            return false;
+        }
+
+        double now = m_simulation.Now();
+        bool allowed = m_messageLog.Allow(CategoryOf(uMsg), now);
+        m_messageLog.Summarize(now, [](const LogThrottle::Summary& summary) {
+            WATER_LOG_EVENT(MessagesSummary, MESSAGE_CATEGORY_NAMES[summary.category],
+                            summary.seen, summary.interval, summary.logged);
+        });
+        return allowed;
+    }
+}
+
 // Обработчик сообщений для текущего экземпляра
 LRESULT WaterEffect::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
-    // Открываем лог для каждого сообщения
-    std::ofstream logFile(LOG_FILE_PATH, std::ios::app);
-    if (logFile.is_open()) {
-        logFile << "Получено сообщение: " << uMsg;
-        
-        // Добавляем имя сообщения для удобства отладки
-        switch(uMsg) {
-            case WM_PAINT: logFile << " (WM_PAINT)"; break;
-            case WM_LBUTTONDOWN: logFile << " (WM_LBUTTONDOWN)"; break;
-            case WM_MOUSEMOVE: logFile << " (WM_MOUSEMOVE)"; break;
-            case WM_TIMER: logFile << " (WM_TIMER)"; break;
-            case WM_DESTROY: logFile << " (WM_DESTROY)"; break;
-            case WM_INPUT: logFile << " (WM_INPUT)"; break;
-        }
-        
-        logFile << std::endl;
+    // Записываем сообщение в журнал с именем для удобства отладки.
+    // Частые сообщения прореживаются, редкие (клики, создание волн) пишутся всегда
+    bool logMessage = ShouldLogMessage(uMsg);
+    if (logMessage) {
+        WATER_LOG_EVENT(MessageReceived, uMsg, MessageName(uMsg));
     }
 
     switch (uMsg) {
@@ -485,24 +743,24 @@ LRESULT WaterEffect::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM l
         case WM_PAINT: {
             PAINTSTRUCT ps;
             BeginPaint(hwnd, &ps);
-            Render();
+            Render(ps.rcPaint);
             EndPaint(hwnd, &ps);
             
-            if (logFile.is_open()) {
-                logFile << "Выполнена отрисовка" << std::endl;
+            if (logMessage) {
+                WATER_LOG_EVENT(PaintDone);
             }
             return 0;
         }
 
         // Обработка клика мыши через стандартное сообщение
         case WM_LBUTTONDOWN: {
+            WATER_TRACE_ZONE("WM_LBUTTONDOWN");
+
             // Получаем координаты клика
             int xPos = GET_X_LPARAM(lParam);
             int yPos = GET_Y_LPARAM(lParam);
             
-            if (logFile.is_open()) {
-                logFile << "WM_LBUTTONDOWN: x=" << xPos << ", y=" << yPos << std::endl;
-            }
+            WATER_LOG_EVENT(ClickMessage, xPos, yPos);
             
             // Создаем волну в точке клика
             CreateWave(static_cast<float>(xPos), static_cast<float>(yPos));
@@ -513,35 +771,28 @@ LRESULT WaterEffect::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM l
 
         // Обработка Raw Input сообщений (для перехвата событий мыши глобально)
         case WM_INPUT: {
-            UINT dwSize = 0;
-            
-            // Сначала получаем размер структуры
-            GetRawInputData((HRAWINPUT)lParam, RID_INPUT, nullptr, &dwSize, sizeof(RAWINPUTHEADER));
-            
-            if (dwSize > 0) {
-                std::vector<BYTE> rawdata(dwSize);
-                
-                // Теперь получаем саму структуру
-                if (GetRawInputData((HRAWINPUT)lParam, RID_INPUT, rawdata.data(), &dwSize, sizeof(RAWINPUTHEADER)) == dwSize) {
-                    RAWINPUT* raw = (RAWINPUT*)rawdata.data();
-                    
-                    // Проверяем, что это события от мыши и что нажата левая кнопка
-                    if (raw->header.dwType == RIM_TYPEMOUSE && 
-                        raw->data.mouse.usButtonFlags & RI_MOUSE_LEFT_BUTTON_DOWN) {
-                        
-                        // Получаем координаты курсора
-                        POINT pt;
-                        GetCursorPos(&pt);
-                        
-                        // Записываем в лог
-                        if (logFile.is_open()) {
-                            logFile << "WM_INPUT: Клик мыши в точке x=" << pt.x << ", y=" << pt.y << std::endl;
-                        }
-                        
-                        // Создаем волну в точке клика
-                        CreateWave(static_cast<float>(pt.x), static_cast<float>(pt.y));
-                    }
-                }
+            WATER_TRACE_ZONE("WM_INPUT");
+
+            // Зарегистрирована только мышь, а её данные целиком помещаются в RAWINPUT,
+            // поэтому структура читается в буфер на стеке без выделения памяти на каждое сообщение
+            RAWINPUT raw;
+            UINT dwSize = sizeof(raw);
+            UINT copied = GetRawInputData((HRAWINPUT)lParam, RID_INPUT, &raw, &dwSize, sizeof(RAWINPUTHEADER));
+
+            // Проверяем, что это события от мыши и что нажата левая кнопка
+            if (copied != static_cast<UINT>(-1) && copied >= sizeof(RAWINPUTHEADER) &&
+                raw.header.dwType == RIM_TYPEMOUSE &&
+                raw.data.mouse.usButtonFlags & RI_MOUSE_LEFT_BUTTON_DOWN) {
+
+                // Получаем координаты курсора
+                POINT pt;
+                GetCursorPos(&pt);
+
+                // Записываем в лог
+                WATER_LOG_EVENT(RawInputClick, pt.x, pt.y);
+
+                // Создаем волну в точке клика
+                CreateWave(static_cast<float>(pt.x), static_cast<float>(pt.y), SpawnSource::RawInput);
             }
             
             // Передаем сообщение дальше
@@ -554,22 +805,18 @@ LRESULT WaterEffect::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM l
                 // Обновляем анимацию
                 Update();
                 
-                if (logFile.is_open()) {
-                    logFile << "Обновление анимации по таймеру" << std::endl;
+                if (logMessage) {
+                    WATER_LOG_EVENT(AnimationTimer);
                 }
             } else if (wParam == TEST_WAVE_TIMER_ID) {
                 // Создаем тестовую волну в случайной точке экрана
                 float x = static_cast<float>(std::rand() % m_screenWidth);
                 float y = static_cast<float>(std::rand() % m_screenHeight);
                 
-                if (logFile.is_open()) {
-                    logFile << "Создание тестовой волны по таймеру x=" << x << ", y=" << y << std::endl;
-                }
-                
-                CreateWave(x, y);
+                WATER_LOG_EVENT(TestWaveTimer, x, y);
                 
-                // Обновляем окно, чтобы сразу отобразить волну
-                InvalidateRect(hwnd, NULL, FALSE);
+                // Волна сразу помечает свою область для перерисовки
+                CreateWave(x, y, SpawnSource::TestTimer);
             }
             return 0;
         }
@@ -580,13 +827,16 @@ LRESULT WaterEffect::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM l
                 DestroyWindow(hwnd);
                 return 0;
             }
+            // F12 - процентили времени кадра в журнал
+            if (wParam == VK_F12) {
+                ReportFrameStats();
+                return 0;
+            }
             return DefWindowProcW(hwnd, uMsg, wParam, lParam);
 
         // Обработка уничтожения окна
         case WM_DESTROY: {
-            if (logFile.is_open()) {
-                logFile << "Окно уничтожено" << std::endl;
-            }
+            WATER_LOG_EVENT(WindowDestroyed);
             
             // Останавливаем таймер
             if (m_timerActive) {
@@ -604,8 +854,8 @@ LRESULT WaterEffect::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM l
         }
 
         default:
-            if (logFile.is_open()) {
-                logFile << "Сообщение обработано по умолчанию" << std::endl;
+            if (logMessage) {
+                WATER_LOG_EVENT(DefaultMessage);
             }
             return DefWindowProcW(hwnd, uMsg, wParam, lParam);
     }
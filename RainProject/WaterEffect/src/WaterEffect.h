@@ -7,16 +7,16 @@
 #include <dwmapi.h>
 #include <vector>
 #include <memory>
+#include <string>
+#include <chrono>
 
-// Структура для хранения информации о волне
-struct Wave {
-    float x;           // Координата X центра волны
-    float y;           // Координата Y центра волны
-    float radius;      // Текущий радиус волны
-    float maxRadius;   // Максимальный радиус волны
-    float opacity;     // Текущая прозрачность волны (1.0f - непрозрачная, 0.0f - полностью прозрачная)
-    float speed;       // Скорость расширения волны
-};
+#include "WaterSimulation.h"
+#include "WaveDrawList.h"
+#include "DirtyRegion.h"
+#include "InputTrace.h"
+#include "Logger.h"
+#include "LogThrottle.h"
+#include "FrameStats.h"
 
 class WaterEffect {
 public:
@@ -30,7 +30,27 @@ public:
     int Run();
 
     // Создание новой волны в указанной точке
-    void CreateWave(float x, float y);
+    void CreateWave(float x, float y, SpawnSource source = SpawnSource::Click);
+
+    // Выбор способа хранения волн (до вызова Initialize)
+    void SetWaveMode(WaveMode mode) { m_simulation.SetWaveMode(mode); }
+
+    // Размер ячейки поля высот в пикселях (до вызова Initialize)
+    void SetHeightFieldCellSize(int cellSize) { m_simulation.SetHeightFieldCellSize(cellSize); }
+
+    // Подмена источника времени (nullptr - системные часы)
+    void SetTimeSource(TimeSource* source) { m_simulation.SetTimeSource(source); }
+
+    // Запись трассы входных событий в файл (до вызова Initialize)
+    void SetTracePath(const char* path) { m_tracePath = path ? path : ""; }
+
+    // Запись зон времени (Update, Render, ввод, журнал) и сохранение их в файл
+    // формата Chrome Trace Event при завершении; открывается в Perfetto
+    void SetZoneTracePath(const char* path);
+
+    // Формат журнала: текстовые сегменты water_effect_log.N.txt или двоичные water_effect_log.N.bin
+    // (до вызова Initialize, который открывает журнал)
+    void SetLogFormat(LogFormat format) { m_logFormat = format; }
 
 private:
     // Регистрация класса окна
@@ -51,8 +71,19 @@ private:
     // Обновление анимации
     void Update();
     
-    // Отрисовка сцены
-    void Render();
+    // Отрисовка сцены внутри области area (прямоугольник WM_PAINT)
+    void Render(const RECT& area);
+
+    // Построение списка кругов текущего состояния и пометка области окна,
+    // которая изменилась с прошлого кадра; возвращает её (пустая - перерисовка не нужна)
+    PixelRect InvalidateWaves();
+
+    // Заливка кругов из списка кадра
+    void DrawDiscs();
+
+    // Остановка и возобновление таймера анимации, когда волн нет
+    void SleepAnimation();
+    void WakeAnimation();
     
     // Статическая функция для обработки сообщений окна
     static LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
@@ -60,26 +91,44 @@ private:
     // Обработчик сообщений для текущего экземпляра
     LRESULT HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
+    // Решение, писать ли в журнал очередное сообщение окна (частота ограничена по категориям)
+    bool ShouldLogMessage(UINT uMsg);
+
+    // Запись процентилей времени кадра в журнал (при выходе и по F12)
+    void ReportFrameStats();
+
 private:
     HWND m_hwnd;                               // Дескриптор окна
     ID2D1Factory* m_pD2DFactory;               // Фабрика Direct2D
     ID2D1HwndRenderTarget* m_pRenderTarget;    // Цель рендеринга
     ID2D1SolidColorBrush* m_pBrush;            // Кисть для рисования
+    ID2D1Bitmap* m_pHeightBitmap;              // Текстура поля высот (WaveMode::HeightField)
 
-    std::vector<Wave> m_waves;                 // Список активных волн
+    WaterSimulation m_simulation;              // Платформенно-независимая симуляция волн
+    WaveDrawList m_drawList;                   // Круги волн текущего кадра
+    DirtyRegion m_dirtyRegion;                 // Границы волн прошлого кадра для частичной перерисовки
+    PixelRect m_heightUpload;                  // Ячейки кадра поля высот, ещё не переданные в текстуру
+
+    std::string m_tracePath;                   // Путь к файлу трассы (пусто - не записывать)
+    TraceWriter m_trace;                       // Запись трассы входных событий
+    LogThrottle m_messageLog;                  // Ограничение записей о сообщениях окна
+    std::string m_zoneTracePath;               // Файл зон времени (пусто - зоны не пишутся)
+    LogFormat m_logFormat;                     // Формат журнала
+    std::unique_ptr<FrameStats> m_frameStats;  // Гистограммы времени обновления, отрисовки и кадра
+    std::chrono::steady_clock::time_point m_lastFrameStart; // Начало предыдущего кадра
+    bool m_hasLastFrame;                       // Предыдущий кадр был
+    uint64_t m_lastFrameAllocations;           // Выделений памяти к началу предыдущего кадра
     
     // Размеры экрана
     int m_screenWidth;
     int m_screenHeight;
     
-    // Параметры волн
-    static constexpr float MAX_WAVE_RADIUS = 300.0f;    // Максимальный радиус волны
-    static constexpr float WAVE_SPEED = 150.0f;         // Скорость расширения волны (пикселей в секунду)
-    static constexpr float WAVE_FADE_SPEED = 0.8f;      // Скорость затухания волны
-    
     // Частота обновления анимации (мс)
     static constexpr int UPDATE_INTERVAL = 16;          // ~60 FPS
     
     // Флаг для отслеживания активности таймера
     bool m_timerActive;
+
+    // Таймер анимации остановлен, потому что волн нет (WaveMode::Analytic)
+    bool m_animationSleeping;
 }; 
\ No newline at end of file
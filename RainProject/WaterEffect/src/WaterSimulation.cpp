@@ -0,0 +1,137 @@
+#include "WaterSimulation.h"
+#include "TraceZones.h"
+
+// Конструктор
+WaterSimulation::WaterSimulation() :
+    m_waveMode(WaveMode::Integrated),
+    m_waves(WAVE_POOL_CAPACITY),
+    m_waveStore(CREATED_WAVE_SPEED, MAX_WAVE_RADIUS),
+    m_timeSource(&m_steadyTime),
+    m_clock(&m_steadyTime, SIMULATION_TICK, SIMULATION_MAX_STEPS),
+    m_heightFrameChanged(EmptyRect()),
+    m_heightFieldCellSize(HEIGHTFIELD_CELL_SIZE)
+{
+}
+
+// Подмена источника времени
+void WaterSimulation::SetTimeSource(TimeSource* source)
+{
+    m_timeSource = source ? source : &m_steadyTime;
+    m_clock.SetTimeSource(m_timeSource);
+}
+
+// Подготовка к работе на экране заданного размера
+void WaterSimulation::Initialize(int screenWidth, int screenHeight, size_t threadCount)
+{
+    // Сетка поля высот покрывает экран целиком
+    if (m_waveMode == WaveMode::HeightField) {
+        m_heightField.Resize((screenWidth + m_heightFieldCellSize - 1) / m_heightFieldCellSize,
+                             (screenHeight + m_heightFieldCellSize - 1) / m_heightFieldCellSize);
+        m_heightField.Shade(m_heightFrame);
+
+        // Шаг поля высот выполняется на всех ядрах; очереди пула сразу рассчитаны
+        // на все плитки, чтобы рост области волн не выделял память в кадре
+        m_threadPool = std::make_unique<ThreadPool>(threadCount);
+        m_threadPool->Reserve(m_heightField.TileCount(), HeightField::TILES_PER_TASK);
+    }
+
+    m_clock.Reset();
+}
+
+// Создание новой волны в указанной точке экрана
+void WaterSimulation::CreateWave(float x, float y)
+{
+    WATER_TRACE_ZONE("WaterSimulation::CreateWave");
+
+    if (m_waveMode == WaveMode::HeightField) {
+        // Волна - возмущение поверхности в координатах сетки
+        float cellSize = static_cast<float>(m_heightFieldCellSize);
+        m_heightField.AddImpulse(x / cellSize, y / cellSize,
+                                 HEIGHTFIELD_IMPULSE_RADIUS / cellSize, HEIGHTFIELD_IMPULSE_STRENGTH);
+    } else if (m_waveMode == WaveMode::Analytic) {
+        m_waveStore.Add(x, y, Now());
+    } else {
+        m_waves.Add(x, y, MAX_WAVE_RADIUS, CREATED_WAVE_SPEED);
+    }
+}
+
+// Продвижение симуляции к текущему моменту
+size_t WaterSimulation::Update()
+{
+    WATER_TRACE_ZONE("WaterSimulation::Update");
+
+    if (m_waveMode == WaveMode::HeightField) {
+        return UpdateHeightField();
+    }
+
+    if (m_waveMode == WaveMode::Analytic) {
+        // Волны не требуют покадровой записи: снимаем только погасшие по меткам времени
+        return m_waveStore.Update(Now());
+    }
+
+    // Волны продвигаются фиксированными шагами, поэтому результат не зависит
+    // от дрожания таймера; остаток шага учитывается интерполяцией при отрисовке
+    int steps = m_clock.Advance();
+    size_t removed = 0;
+    for (int step = 0; step < steps; ++step) {
+        // Обновляем все активные волны: радиус растёт, прозрачность падает,
+        // полностью прозрачные волны удаляются одним проходом уплотнения
+        removed += m_waves.Update(static_cast<float>(m_clock.Tick()));
+    }
+    return removed;
+}
+
+// Кадры можно не обновлять
+bool WaterSimulation::IsIdle() const
+{
+    if (m_waveMode == WaveMode::HeightField) {
+        return m_heightField.IsCalm();
+    }
+    return m_waveMode == WaveMode::Analytic && m_waveStore.Empty();
+}
+
+// Число живых волн
+size_t WaterSimulation::WaveCount() const
+{
+    if (m_waveMode == WaveMode::Analytic) {
+        return m_waveStore.Size();
+    }
+    return m_waveMode == WaveMode::Integrated ? m_waves.Size() : 0;
+}
+
+// Продвижение поля высот фиксированными шагами
+size_t WaterSimulation::UpdateHeightField()
+{
+    // Шаг симуляции не зависит от частоты таймера: накопившееся время
+    // отрабатывается целыми шагами, но не более SIMULATION_MAX_STEPS за раз
+    int steps = m_clock.Advance();
+    for (int step = 0; step < steps; ++step) {
+        WATER_TRACE_ZONE("HeightField::Step");
+        m_heightField.Step(m_threadPool.get());
+    }
+
+    // Кадр меняется только в закрашенных плитках - остальное не нужно ни передавать
+    // в текстуру, ни перерисовывать на экране
+    m_heightFrameChanged = EmptyRect();
+    if (steps > 0) {
+        WATER_TRACE_ZONE("HeightField::Shade");
+        m_heightField.Shade(m_heightFrame);
+        m_heightFrameChanged = m_heightField.ShadedRect();
+    }
+    return 0;
+}
+
+// Область экрана, на которую влияют ячейки кадра поля высот
+PixelRect WaterSimulation::HeightFieldScreenArea(const PixelRect& cells, int screenWidth, int screenHeight) const
+{
+    if (cells.Empty()) {
+        return EmptyRect();
+    }
+
+    // Кадр растягивается с линейной интерполяцией, поэтому ячейка влияет и на
+    // пиксели соседних ячеек - область расширяется на одну ячейку с каждой стороны
+    int cellSize = m_heightFieldCellSize;
+    PixelRect area = { (cells.x0 - 1) * cellSize, (cells.y0 - 1) * cellSize,
+                       (cells.x1 + 1) * cellSize, (cells.y1 + 1) * cellSize };
+    return IntersectRect(area, PixelRect{ 0, 0, screenWidth, screenHeight });
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "WavePool.h"
+#include "WaveStore.h"
+#include "HeightField.h"
+#include "DirtyRegion.h"
+#include "Framebuffer.h"
+#include "ThreadPool.h"
+#include "SimulationClock.h"
+
+// Способ хранения и обновления волн
+enum class WaveMode {
+    Integrated,     // Радиус и прозрачность каждой волны продвигаются в каждом кадре
+    Analytic,       // Волна хранит только момент рождения, состояние вычисляется при отрисовке
+    HeightField     // Волны распространяются по полю высот (волновое уравнение на сетке)
+};
+
+// Платформенно-независимая симуляция эффекта воды: хранение волн,
+// часы фиксированного шага и поле высот. Окно, ввод и отрисовка через Direct2D
+// остаются в WaterEffect, а воспроизведение трасс управляет симуляцией напрямую
+class WaterSimulation {
+public:
+    WaterSimulation();
+
+    // Выбор способа хранения волн (до вызова Initialize)
+    void SetWaveMode(WaveMode mode) { m_waveMode = mode; }
+    WaveMode GetWaveMode() const { return m_waveMode; }
+
+    // Размер ячейки поля высот в пикселях (до вызова Initialize)
+    void SetHeightFieldCellSize(int cellSize) { m_heightFieldCellSize = cellSize > 0 ? cellSize : 1; }
+    int HeightFieldCellSize() const { return m_heightFieldCellSize; }
+
+    // Подмена источника времени (nullptr - системные часы)
+    void SetTimeSource(TimeSource* source);
+
+    // Подготовка к работе на экране заданного размера.
+    // threadCount - число потоков для шага поля высот (0 - по числу ядер)
+    void Initialize(int screenWidth, int screenHeight, size_t threadCount = 0);
+
+    // Создание новой волны в указанной точке экрана
+    void CreateWave(float x, float y);
+
+    // Продвижение симуляции к текущему моменту источника времени.
+    // Возвращает число удалённых волн
+    size_t Update();
+
+    // Сброс часов: время, прошедшее до этого момента, не попадёт в следующий шаг
+    void ResetClock() { m_clock.Reset(); }
+
+    // Текущее время по источнику времени (секунды)
+    double Now() const { return m_timeSource->Seconds(); }
+
+    // Число живых волн (для поля высот - 0)
+    size_t WaveCount() const;
+
+    // Кадры можно не обновлять: нет ни одной волны (WaveMode::Analytic)
+    // или поверхность успокоилась и её кадр окончательно очищен (WaveMode::HeightField)
+    bool IsIdle() const;
+
+    // Обход волн в состоянии на момент отрисовки: visit(x, y, radius, opacity)
+    template <typename Visitor>
+    void ForEachWave(Visitor&& visit) const;
+
+    // Поле высот и его кадр (WaveMode::HeightField)
+    const HeightField& GetHeightField() const { return m_heightField; }
+    const Framebuffer& HeightFrame() const { return m_heightFrame; }
+
+    // Ячейки кадра поля высот, изменённые последним Update (пусто, если кадр не менялся)
+    const PixelRect& HeightFrameChanged() const { return m_heightFrameChanged; }
+
+    // Область экрана, на которую влияют ячейки cells растянутого кадра поля высот
+    PixelRect HeightFieldScreenArea(const PixelRect& cells, int screenWidth, int screenHeight) const;
+
+    const SimulationClock& Clock() const { return m_clock; }
+
+    // Параметры волн
+    static constexpr float MAX_WAVE_RADIUS = 300.0f;    // Максимальный радиус волны
+    static constexpr float WAVE_SPEED = 150.0f;         // Скорость расширения волны (пикселей в секунду)
+    static constexpr float CREATED_WAVE_SPEED = WAVE_SPEED * 1.5f; // Скорость новых волн (увеличена для большей заметности)
+    static constexpr size_t WAVE_POOL_CAPACITY = 1024;  // Начальная ёмкость пула волн
+
+    // Параметры часов симуляции
+    static constexpr double SIMULATION_TICK = 1.0 / 60.0;   // Фиксированный шаг симуляции (секунды)
+    static constexpr int SIMULATION_MAX_STEPS = 4;          // Максимум шагов за одно обновление
+
+    // Параметры поля высот
+    static constexpr int HEIGHTFIELD_CELL_SIZE = 2;                 // Размер ячейки по умолчанию (пикселей)
+    static constexpr float HEIGHTFIELD_IMPULSE_RADIUS = 24.0f;      // Радиус возмущения от волны (пикселей)
+    static constexpr float HEIGHTFIELD_IMPULSE_STRENGTH = 96.0f;    // Высота возмущения
+
+private:
+    // Продвижение поля высот фиксированными шагами
+    size_t UpdateHeightField();
+
+private:
+    WaveMode m_waveMode;                       // Способ хранения волн
+    WavePool m_waves;                          // Пул активных волн (WaveMode::Integrated)
+    WaveStore m_waveStore;                     // Волны по моменту рождения (WaveMode::Analytic)
+
+    SteadyTimeSource m_steadyTime;             // Системные часы (источник времени по умолчанию)
+    TimeSource* m_timeSource;                  // Текущий источник времени
+    SimulationClock m_clock;                   // Часы фиксированного шага (Integrated и HeightField)
+
+    HeightField m_heightField;                 // Поле высот (WaveMode::HeightField)
+    std::unique_ptr<ThreadPool> m_threadPool;  // Потоки для параллельного шага поля высот
+    Framebuffer m_heightFrame;                 // Кадр поля высот для передачи в текстуру
+    PixelRect m_heightFrameChanged;            // Ячейки кадра, изменённые последним Update
+    int m_heightFieldCellSize;                 // Размер ячейки поля высот в пикселях
+};
+
+// Обход волн в состоянии на момент отрисовки
+template <typename Visitor>
+void WaterSimulation::ForEachWave(Visitor&& visit) const
+{
+    if (m_waveMode == WaveMode::Analytic) {
+        // Радиус и прозрачность вычисляются по возрасту волны прямо при отрисовке
+        m_waveStore.ForEachWave(Now(), visit);
+    } else if (m_waveMode == WaveMode::Integrated) {
+        // Между шагами симуляции волна рисуется в промежуточном состоянии
+        // между предыдущим и последним шагом, поэтому движение плавное на любой частоте кадров
+        float lag = static_cast<float>((1.0 - m_clock.Alpha()) * m_clock.Tick());
+        m_waves.ForEachInterpolated(lag, visit);
+    }
+}
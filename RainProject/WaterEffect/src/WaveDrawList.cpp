@@ -0,0 +1,26 @@
+#include "WaveDrawList.h"
+
+namespace {
+
+// Заливка цветом 0xRRGGBB с прозрачностью, как D2D1::ColorF(rgb, alpha)
+DiscFill MakeDisc(float x, float y, float radius, uint32_t rgb, float alpha)
+{
+    const float scale = 1.0f / 255.0f;
+    return DiscFill{ x, y, radius,
+                     static_cast<float>((rgb >> 16) & 0xFF) * scale,
+                     static_cast<float>((rgb >> 8) & 0xFF) * scale,
+                     static_cast<float>(rgb & 0xFF) * scale,
+                     alpha };
+}
+
+} // namespace
+
+// Добавление волны
+void WaveDrawList::AddWave(float x, float y, float radius, float opacity)
+{
+    // Убираем обводку - просто заполняем круг полупрозрачным голубым цветом
+    m_discs.push_back(MakeDisc(x, y, radius, OUTER_COLOR, opacity * OUTER_OPACITY));
+
+    // Дополнительно рисуем более яркий голубой круг в центре для эффекта глубины
+    m_discs.push_back(MakeDisc(x, y, radius * INNER_RADIUS, INNER_COLOR, opacity * INNER_OPACITY));
+}
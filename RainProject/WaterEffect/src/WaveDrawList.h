@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Заливка круга однотонной кистью: то, что Render() передаёт в FillEllipse.
+// Цвет хранится как в D2D1::ColorF - компоненты 0..1 без предумножения и альфа отдельно
+struct DiscFill {
+    float x;        // Центр
+    float y;
+    float radius;   // Радиус
+    float r;        // Цвет кисти
+    float g;
+    float b;
+    float a;        // Прозрачность кисти
+};
+
+// Список заливок кадра в порядке отрисовки.
+// Render() в приложении и отрисовка без окна строят кадр из одного и того же списка,
+// поэтому цвета и радиусы кругов волны заданы в одном месте. Список очищается
+// каждый кадр без освобождения памяти и растёт только при новом наибольшем числе волн
+class WaveDrawList {
+public:
+    // Запас места под заданное число волн
+    void Reserve(size_t waves) { m_discs.reserve(waves * DISCS_PER_WAVE); }
+
+    // Начало нового кадра
+    void Clear() { m_discs.clear(); }
+
+    // Добавление волны: внешний круг DeepSkyBlue и более яркий внутренний LightBlue
+    void AddWave(float x, float y, float radius, float opacity);
+
+    const DiscFill* Data() const { return m_discs.data(); }
+    size_t Size() const { return m_discs.size(); }
+    bool Empty() const { return m_discs.empty(); }
+
+    // Круги волны по её номеру: внешний и внутренний с тем же центром и меньшим радиусом
+    // (программная отрисовка заливает их за один проход)
+    size_t WaveCount() const { return m_discs.size() / DISCS_PER_WAVE; }
+    const DiscFill& Outer(size_t wave) const { return m_discs[wave * DISCS_PER_WAVE]; }
+    const DiscFill& Inner(size_t wave) const { return m_discs[wave * DISCS_PER_WAVE + 1]; }
+
+    const DiscFill* begin() const { return m_discs.data(); }
+    const DiscFill* end() const { return m_discs.data() + m_discs.size(); }
+
+    // Кругов на одну волну
+    static constexpr size_t DISCS_PER_WAVE = 2;
+
+    // Вид волны: цвета D2D1::ColorF::DeepSkyBlue и D2D1::ColorF::LightBlue (0xRRGGBB),
+    // доля прозрачности волны и доля радиуса для каждого круга
+    static constexpr uint32_t OUTER_COLOR = 0x00BFFF;
+    static constexpr float OUTER_OPACITY = 0.3f;
+    static constexpr uint32_t INNER_COLOR = 0xADD8E6;
+    static constexpr float INNER_OPACITY = 0.5f;
+    static constexpr float INNER_RADIUS = 0.6f;
+
+private:
+    std::vector<DiscFill> m_discs;
+};
@@ -0,0 +1,200 @@
+#include "WaveKernels.h"
+#include "CpuFeatures.h"
+
+#if WATER_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Подсчёт установленных битов
+size_t PopCount(uint64_t value)
+{
+    size_t count = 0;
+    while (value) {
+        value &= value - 1;
+        ++count;
+    }
+    return count;
+}
+
+// Обнуление маски перед заполнением
+void ClearMask(uint64_t* retireMask, size_t count)
+{
+    size_t words = RetireMaskWords(count);
+    for (size_t w = 0; w < words; ++w) {
+        retireMask[w] = 0;
+    }
+}
+
+// Скалярная обработка диапазона [begin, end), общая для эталона и хвостов SIMD-ядер
+void IntegrateRange(float* radius, float* opacity, const float* maxRadius, const float* speed,
+                    size_t begin, size_t end, float deltaTime, uint64_t* retireMask)
+{
+    for (size_t i = begin; i < end; ++i) {
+        float newRadius = radius[i] + speed[i] * deltaTime;
+        radius[i] = newRadius;
+        opacity[i] = 1.0f - (newRadius / maxRadius[i]);
+        uint64_t retired = newRadius >= maxRadius[i] ? 1u : 0u;
+        retireMask[i >> 6] |= retired << (i & 63);
+    }
+}
+
+// Число погасших волн по готовой маске
+size_t CountRetired(const uint64_t* retireMask, size_t count)
+{
+    size_t retired = 0;
+    size_t words = RetireMaskWords(count);
+    for (size_t w = 0; w < words; ++w) {
+        retired += PopCount(retireMask[w]);
+    }
+    return retired;
+}
+
+#if WATER_X86
+
+// SSE2: по 4 волны за итерацию
+WATER_TARGET("sse2")
+size_t IntegrateWavesSse2(float* radius, float* opacity, const float* maxRadius,
+                          const float* speed, size_t count, float deltaTime,
+                          uint64_t* retireMask)
+{
+    ClearMask(retireMask, count);
+
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 r = _mm_add_ps(_mm_loadu_ps(radius + i), _mm_mul_ps(_mm_loadu_ps(speed + i), dt));
+        __m128 m = _mm_loadu_ps(maxRadius + i);
+        _mm_storeu_ps(radius + i, r);
+        _mm_storeu_ps(opacity + i, _mm_sub_ps(one, _mm_div_ps(r, m)));
+
+        uint64_t bits = static_cast<unsigned int>(_mm_movemask_ps(_mm_cmpge_ps(r, m)));
+        retireMask[i >> 6] |= bits << (i & 63);
+    }
+
+    IntegrateRange(radius, opacity, maxRadius, speed, i, count, deltaTime, retireMask);
+    return CountRetired(retireMask, count);
+}
+
+// AVX2: по 8 волн за итерацию
+WATER_TARGET("avx2")
+size_t IntegrateWavesAvx2(float* radius, float* opacity, const float* maxRadius,
+                          const float* speed, size_t count, float deltaTime,
+                          uint64_t* retireMask)
+{
+    ClearMask(retireMask, count);
+
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 r = _mm256_add_ps(_mm256_loadu_ps(radius + i), _mm256_mul_ps(_mm256_loadu_ps(speed + i), dt));
+        __m256 m = _mm256_loadu_ps(maxRadius + i);
+        _mm256_storeu_ps(radius + i, r);
+        _mm256_storeu_ps(opacity + i, _mm256_sub_ps(one, _mm256_div_ps(r, m)));
+
+        uint64_t bits = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(r, m, _CMP_GE_OQ)));
+        retireMask[i >> 6] |= bits << (i & 63);
+    }
+
+    IntegrateRange(radius, opacity, maxRadius, speed, i, count, deltaTime, retireMask);
+    return CountRetired(retireMask, count);
+}
+
+// AVX-512: по 16 волн за итерацию, маска сравнения сразу даёт биты
+WATER_TARGET("avx512f")
+size_t IntegrateWavesAvx512(float* radius, float* opacity, const float* maxRadius,
+                            const float* speed, size_t count, float deltaTime,
+                            uint64_t* retireMask)
+{
+    ClearMask(retireMask, count);
+
+    const __m512 dt = _mm512_set1_ps(deltaTime);
+    const __m512 one = _mm512_set1_ps(1.0f);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 r = _mm512_add_ps(_mm512_loadu_ps(radius + i), _mm512_mul_ps(_mm512_loadu_ps(speed + i), dt));
+        __m512 m = _mm512_loadu_ps(maxRadius + i);
+        _mm512_storeu_ps(radius + i, r);
+        _mm512_storeu_ps(opacity + i, _mm512_sub_ps(one, _mm512_div_ps(r, m)));
+
+        uint64_t bits = static_cast<unsigned int>(_mm512_cmp_ps_mask(r, m, _CMP_GE_OQ));
+        retireMask[i >> 6] |= bits << (i & 63);
+    }
+
+    IntegrateRange(radius, opacity, maxRadius, speed, i, count, deltaTime, retireMask);
+    return CountRetired(retireMask, count);
+}
+
+#endif
+
+const WaveKernel SCALAR_KERNEL = { "scalar", IntegrateWavesScalar };
+#if WATER_X86
+const WaveKernel SSE2_KERNEL = { "sse2", IntegrateWavesSse2 };
+const WaveKernel AVX2_KERNEL = { "avx2", IntegrateWavesAvx2 };
+const WaveKernel AVX512_KERNEL = { "avx512", IntegrateWavesAvx512 };
+#endif
+
+// Выбор самого широкого поддерживаемого ядра
+const WaveKernel& SelectWaveKernel()
+{
+#if WATER_X86
+    const CpuFeatures& cpu = GetCpuFeatures();
+    if (cpu.avx512) {
+        return AVX512_KERNEL;
+    }
+    if (cpu.avx2) {
+        return AVX2_KERNEL;
+    }
+    if (cpu.sse2) {
+        return SSE2_KERNEL;
+    }
+#endif
+    return SCALAR_KERNEL;
+}
+
+} // namespace
+
+// Эталонная скалярная реализация
+size_t IntegrateWavesScalar(float* radius, float* opacity, const float* maxRadius,
+                            const float* speed, size_t count, float deltaTime,
+                            uint64_t* retireMask)
+{
+    ClearMask(retireMask, count);
+    IntegrateRange(radius, opacity, maxRadius, speed, 0, count, deltaTime, retireMask);
+    return CountRetired(retireMask, count);
+}
+
+// Лучшее ядро для текущего процессора
+const WaveKernel& GetWaveKernel()
+{
+    static const WaveKernel& kernel = SelectWaveKernel();
+    return kernel;
+}
+
+// Все ядра, поддерживаемые текущим процессором
+size_t GetAvailableWaveKernels(const WaveKernel** kernels, size_t maxKernels)
+{
+    size_t count = 0;
+    if (count < maxKernels) {
+        kernels[count++] = &SCALAR_KERNEL;
+    }
+#if WATER_X86
+    const CpuFeatures& cpu = GetCpuFeatures();
+    if (cpu.sse2 && count < maxKernels) {
+        kernels[count++] = &SSE2_KERNEL;
+    }
+    if (cpu.avx2 && count < maxKernels) {
+        kernels[count++] = &AVX2_KERNEL;
+    }
+    if (cpu.avx512 && count < maxKernels) {
+        kernels[count++] = &AVX512_KERNEL;
+    }
+#endif
+    return count;
+}
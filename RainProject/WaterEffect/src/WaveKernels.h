@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Ядро интегрирования волн: radius += speed * dt, opacity = 1 - radius / maxRadius.
+// Для каждой волны, достигшей максимального радиуса, в retireMask выставляется бит
+// (маска содержит (count + 63) / 64 слов и полностью перезаписывается).
+// Возвращает число погасших волн
+typedef size_t (*WaveIntegrateFn)(float* radius, float* opacity, const float* maxRadius,
+                                  const float* speed, size_t count, float deltaTime,
+                                  uint64_t* retireMask);
+
+struct WaveKernel {
+    const char* name;       // Имя набора команд
+    WaveIntegrateFn integrate;
+};
+
+// Эталонная скалярная реализация
+size_t IntegrateWavesScalar(float* radius, float* opacity, const float* maxRadius,
+                            const float* speed, size_t count, float deltaTime,
+                            uint64_t* retireMask);
+
+// Лучшее ядро для текущего процессора (выбирается один раз по CPUID)
+const WaveKernel& GetWaveKernel();
+
+// Все ядра, поддерживаемые текущим процессором, от скалярного к самому широкому.
+// Возвращает их количество
+size_t GetAvailableWaveKernels(const WaveKernel** kernels, size_t maxKernels);
+
+// Число слов маски для указанного числа волн
+inline size_t RetireMaskWords(size_t count)
+{
+    return (count + 63) / 64;
+}
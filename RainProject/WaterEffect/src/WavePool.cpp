@@ -0,0 +1,139 @@
+#include "WavePool.h"
+#include "WaveKernels.h"
+
+// Конструктор
+WavePool::WavePool() :
+    m_count(0)
+{
+}
+
+// Конструктор с предварительным резервированием
+WavePool::WavePool(size_t capacity) :
+    m_count(0)
+{
+    Reserve(capacity);
+}
+
+// Резервирование памяти под указанное число волн
+void WavePool::Reserve(size_t capacity)
+{
+    if (capacity <= m_x.size()) {
+        return;
+    }
+
+    // Массивы всегда имеют размер ёмкости, чтобы Add не трогал аллокатор
+    m_x.resize(capacity);
+    m_y.resize(capacity);
+    m_radius.resize(capacity);
+    m_maxRadius.resize(capacity);
+    m_opacity.resize(capacity);
+    m_speed.resize(capacity);
+    m_retireMask.resize(RetireMaskWords(capacity));
+}
+
+// Добавление новой волны
+size_t WavePool::Add(float x, float y, float maxRadius, float speed, float radius)
+{
+    // Рост ёмкости вдвое происходит только при переполнении
+    if (m_count == m_x.size()) {
+        Reserve(m_count < 16 ? 16 : m_count * 2);
+    }
+
+    size_t index = m_count++;
+    m_x[index] = x;
+    m_y[index] = y;
+    m_radius[index] = radius;
+    m_maxRadius[index] = maxRadius;
+    m_opacity[index] = 1.0f - radius / maxRadius;
+    m_speed[index] = speed;
+    return index;
+}
+
+// Удаление волны по индексу (swap-and-pop)
+void WavePool::Retire(size_t index)
+{
+    if (index >= m_count) {
+        return;
+    }
+
+    size_t last = --m_count;
+    if (index != last) {
+        MoveSlot(last, index);
+    }
+}
+
+// Удаление всех погасших волн
+size_t WavePool::Compact()
+{
+    // Всё до первой погасшей волны остаётся на месте
+    size_t write = 0;
+    while (write < m_count && !IsRetired(write)) {
+        ++write;
+    }
+
+    // Дальше каждая волна копируется в позицию write без ветвлений,
+    // а write сдвигается только для живых волн
+    for (size_t read = write + 1; read < m_count; ++read) {
+        bool alive = !IsRetired(read);
+        MoveSlot(read, write);
+        write += alive ? 1 : 0;
+    }
+
+    size_t removed = m_count - write;
+    m_count = write;
+    return removed;
+}
+
+// Продвижение всех волн на deltaTime секунд
+size_t WavePool::Update(float deltaTime)
+{
+    size_t retired = GetWaveKernel().integrate(
+        m_radius.data(), m_opacity.data(), m_maxRadius.data(), m_speed.data(),
+        m_count, deltaTime, m_retireMask.data());
+
+    // Проход уплотнения нужен только в кадрах, где что-то погасло
+    return retired > 0 ? CompactByMask() : 0;
+}
+
+// Копирование всех полей волны из одного слота в другой
+void WavePool::MoveSlot(size_t from, size_t to)
+{
+    m_x[to] = m_x[from];
+    m_y[to] = m_y[from];
+    m_radius[to] = m_radius[from];
+    m_maxRadius[to] = m_maxRadius[from];
+    m_opacity[to] = m_opacity[from];
+    m_speed[to] = m_speed[from];
+}
+
+// Уплотнение по маске погасших волн
+size_t WavePool::CompactByMask()
+{
+    const uint64_t* mask = m_retireMask.data();
+
+    // Пропускаем нулевые слова маски: всё до первой погасшей волны остаётся на месте
+    size_t word = 0;
+    size_t words = RetireMaskWords(m_count);
+    while (word < words && mask[word] == 0) {
+        ++word;
+    }
+    if (word == words) {
+        return 0;
+    }
+
+    size_t write = word * 64;
+    while (((mask[word] >> (write & 63)) & 1u) == 0) {
+        ++write;
+    }
+
+    // Дальше каждая волна копируется в позицию write без ветвлений
+    for (size_t read = write + 1; read < m_count; ++read) {
+        uint64_t retired = (mask[read >> 6] >> (read & 63)) & 1u;
+        MoveSlot(read, write);
+        write += static_cast<size_t>(retired ^ 1u);
+    }
+
+    size_t removed = m_count - write;
+    m_count = write;
+    return removed;
+}
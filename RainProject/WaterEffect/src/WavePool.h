@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Пул волн в формате "структура массивов" (SoA).
+// Каждое поле волны хранится в отдельном непрерывном массиве, поэтому
+// проход обновления читает и пишет только нужные данные подряд.
+// Удаление одной волны выполняется за O(1) (swap-and-pop), а массовое
+// удаление погасших волн - одним линейным проходом уплотнения.
+// Интегрирование выполняет SIMD-ядро, выбранное по возможностям процессора.
+class WavePool {
+public:
+    WavePool();
+    explicit WavePool(size_t capacity);
+
+    // Резервирование памяти под указанное число волн
+    void Reserve(size_t capacity);
+
+    // Добавление новой волны с начальным радиусом (по умолчанию 0), возвращает её индекс
+    size_t Add(float x, float y, float maxRadius, float speed, float radius = 0.0f);
+
+    // Удаление волны по индексу: на её место переносится последняя волна
+    void Retire(size_t index);
+
+    // Удаление всех погасших волн одним проходом с сохранением порядка остальных.
+    // Возвращает число удалённых волн
+    size_t Compact();
+
+    // Продвижение всех волн на deltaTime секунд с удалением погасших.
+    // Возвращает число удалённых волн
+    size_t Update(float deltaTime);
+
+    // Удаление всех волн без освобождения памяти
+    void Clear() { m_count = 0; }
+
+    size_t Size() const { return m_count; }
+    bool Empty() const { return m_count == 0; }
+    size_t Capacity() const { return m_x.size(); }
+
+    // Доступ к массивам полей (первые Size() элементов действительны)
+    const float* X() const { return m_x.data(); }
+    const float* Y() const { return m_y.data(); }
+    const float* Radius() const { return m_radius.data(); }
+    const float* MaxRadius() const { return m_maxRadius.data(); }
+    const float* Opacity() const { return m_opacity.data(); }
+    const float* Speed() const { return m_speed.data(); }
+
+    // Обход живых волн в состоянии на lagTime секунд раньше текущего:
+    // visit(x, y, radius, opacity). Радиус и прозрачность меняются линейно,
+    // поэтому это точная интерполяция между предыдущим и последним шагом
+    template <typename Visitor>
+    void ForEachInterpolated(float lagTime, Visitor&& visit) const;
+
+private:
+    // Погасла ли волна с указанным индексом
+    bool IsRetired(size_t index) const {
+        return m_opacity[index] <= 0.0f || m_radius[index] >= m_maxRadius[index];
+    }
+
+    // Копирование всех полей волны из одного слота в другой
+    void MoveSlot(size_t from, size_t to);
+
+    // Уплотнение по маске погасших волн, заполненной ядром интегрирования
+    size_t CompactByMask();
+
+private:
+    std::vector<float> m_x;          // Координаты X центров волн
+    std::vector<float> m_y;          // Координаты Y центров волн
+    std::vector<float> m_radius;     // Текущие радиусы
+    std::vector<float> m_maxRadius;  // Максимальные радиусы
+    std::vector<float> m_opacity;    // Текущие прозрачности
+    std::vector<float> m_speed;      // Скорости расширения
+    std::vector<uint64_t> m_retireMask; // Биты погасших волн за последний Update
+
+    size_t m_count;                  // Число живых волн
+};
+
+// Обход живых волн в интерполированном состоянии
+template <typename Visitor>
+void WavePool::ForEachInterpolated(float lagTime, Visitor&& visit) const
+{
+    for (size_t i = 0; i < m_count; ++i) {
+        // Волна, добавленная после последнего шага, ещё не начала расширяться
+        float radius = m_radius[i] - m_speed[i] * lagTime;
+        radius = radius > 0.0f ? radius : 0.0f;
+        visit(m_x[i], m_y[i], radius, 1.0f - radius / m_maxRadius[i]);
+    }
+}
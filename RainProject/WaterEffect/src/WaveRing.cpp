@@ -0,0 +1,150 @@
+#include "WaveRing.h"
+
+// Конструктор
+WaveRing::WaveRing(size_t capacity) :
+    m_ringHead(0),
+    m_blocksInUse(0),
+    m_headOffset(0),
+    m_size(0),
+    m_peakSize(capacity)
+{
+    m_ring.resize(1, nullptr);
+    ReserveForSize(capacity);
+}
+
+// Добавление волны в хвост
+void WaveRing::PushBack(float x, float y, double birthTime)
+{
+    // Блоки выделяются только при новом наибольшем числе волн, поэтому,
+    // пока волн не больше, чем уже было, добавление не выделяет память
+    if (m_size >= m_peakSize) {
+        m_peakSize = m_size + 1;
+        ReserveForSize(m_peakSize);
+    }
+
+    // Хвост упёрся в конец последнего блока - подключаем следующий
+    size_t position = m_headOffset + m_size;
+    if (position == m_blocksInUse * BLOCK_SIZE) {
+        AppendBlock(AcquireBlock());
+    }
+
+    Slot slot = Locate(m_size);
+    slot.block->x[slot.offset] = x;
+    slot.block->y[slot.offset] = y;
+    slot.block->birthTime[slot.offset] = birthTime;
+    ++m_size;
+}
+
+// Удаление всех волн, рождённых не позже указанного момента
+size_t WaveRing::DropBornUntil(double birthTime)
+{
+    // Двоичный поиск первой волны, рождённой позже birthTime
+    size_t low = 0;
+    size_t high = m_size;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (BirthTime(middle) <= birthTime) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    size_t removed = low;
+    if (removed == 0) {
+        return 0;
+    }
+
+    // Сдвигаем голову и возвращаем полностью освободившиеся блоки
+    m_headOffset += removed;
+    m_size -= removed;
+
+    size_t releasedBlocks = m_headOffset >> BLOCK_SHIFT;
+    if (m_size == 0) {
+        // Пустое кольцо начинается с начала первого блока
+        releasedBlocks = m_blocksInUse;
+        m_headOffset = 0;
+    } else {
+        m_headOffset &= BLOCK_SIZE - 1;
+    }
+
+    for (size_t i = 0; i < releasedBlocks; ++i) {
+        m_freeBlocks.push_back(m_ring[m_ringHead]);
+        m_ring[m_ringHead] = nullptr;
+        m_ringHead = (m_ringHead + 1) & (m_ring.size() - 1);
+    }
+    m_blocksInUse -= releasedBlocks;
+
+    return removed;
+}
+
+// Удаление всех волн
+void WaveRing::Clear()
+{
+    while (m_blocksInUse > 0) {
+        m_freeBlocks.push_back(m_ring[m_ringHead]);
+        m_ring[m_ringHead] = nullptr;
+        m_ringHead = (m_ringHead + 1) & (m_ring.size() - 1);
+        --m_blocksInUse;
+    }
+    m_headOffset = 0;
+    m_size = 0;
+}
+
+// Резервирование блоков под заданное число волн
+void WaveRing::ReserveForSize(size_t size)
+{
+    // Голова может стоять в любом месте первого блока, поэтому в худшем случае
+    // записи занимают на блок больше, чем ceil(size / BLOCK_SIZE)
+    size_t blocks = (size + BLOCK_SIZE - 1) / BLOCK_SIZE + 1;
+    if (blocks <= m_storage.size()) {
+        return;
+    }
+
+    // Место в списке свободных блоков и в кольце указателей резервируется сразу,
+    // чтобы возврат и подключение блоков не выделяли память
+    m_freeBlocks.reserve(blocks);
+    while (m_storage.size() < blocks) {
+        m_storage.push_back(std::make_unique<Block>());
+        m_freeBlocks.push_back(m_storage.back().get());
+    }
+    GrowRing(blocks);
+}
+
+// Взятие свободного блока
+WaveRing::Block* WaveRing::AcquireBlock()
+{
+    // Свободный блок есть всегда: PushBack резервирует блоки на худший случай
+    Block* block = m_freeBlocks.back();
+    m_freeBlocks.pop_back();
+    return block;
+}
+
+// Расширение кольца указателей до заданного числа блоков
+void WaveRing::GrowRing(size_t blocks)
+{
+    // Кольцо удваивается с раскладкой указателей по порядку.
+    // Перемещаются только указатели, сами записи остаются на месте
+    size_t ringSize = m_ring.size();
+    while (ringSize < blocks) {
+        ringSize *= 2;
+    }
+    if (ringSize == m_ring.size()) {
+        return;
+    }
+
+    std::vector<Block*> ring(ringSize, nullptr);
+    for (size_t i = 0; i < m_blocksInUse; ++i) {
+        ring[i] = m_ring[(m_ringHead + i) & (m_ring.size() - 1)];
+    }
+    m_ring.swap(ring);
+    m_ringHead = 0;
+}
+
+// Добавление блока в хвост кольца указателей
+void WaveRing::AppendBlock(Block* block)
+{
+    // Кольцо не меньше числа выделенных блоков (GrowRing), поэтому место в нём всегда есть
+    m_ring[(m_ringHead + m_blocksInUse) & (m_ring.size() - 1)] = block;
+    ++m_blocksInUse;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Кольцевой буфер волн в порядке создания (FIFO).
+// Данные лежат в блоках фиксированного размера; кольцо хранит только указатели
+// на блоки, поэтому при росте ёмкости живые записи не перемещаются.
+// Удаление старых волн лишь сдвигает индекс головы, а граница живых волн
+// находится двоичным поиском по моментам рождения
+class WaveRing {
+public:
+    static constexpr size_t BLOCK_SHIFT = 10;
+    static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_SHIFT;   // Записей в блоке
+
+    explicit WaveRing(size_t capacity = BLOCK_SIZE);
+
+    WaveRing(const WaveRing&) = delete;
+    WaveRing& operator=(const WaveRing&) = delete;
+
+    // Добавление волны в хвост (моменты рождения не должны убывать)
+    void PushBack(float x, float y, double birthTime);
+
+    // Удаление всех волн, рождённых не позже указанного момента.
+    // Возвращает число удалённых волн
+    size_t DropBornUntil(double birthTime);
+
+    // Удаление всех волн без освобождения памяти
+    void Clear();
+
+    size_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+    size_t Capacity() const { return m_storage.size() * BLOCK_SIZE; }
+
+    // Доступ к волне по номеру, начиная с самой старой
+    float X(size_t index) const {
+        Slot slot = Locate(index);
+        return slot.block->x[slot.offset];
+    }
+    float Y(size_t index) const {
+        Slot slot = Locate(index);
+        return slot.block->y[slot.offset];
+    }
+    double BirthTime(size_t index) const {
+        Slot slot = Locate(index);
+        return slot.block->birthTime[slot.offset];
+    }
+
+    // Обход всех волн от самой старой: visit(x, y, birthTime).
+    // Записи читаются подряд внутри каждого блока, без пересчёта адреса на каждую
+    template <typename Visitor>
+    void ForEach(Visitor&& visit) const;
+
+private:
+    // Блок записей в формате "структура массивов"
+    struct Block {
+        float x[BLOCK_SIZE];
+        float y[BLOCK_SIZE];
+        double birthTime[BLOCK_SIZE];
+    };
+
+    // Положение записи: блок и смещение внутри него
+    struct Slot {
+        Block* block;
+        size_t offset;
+    };
+
+    Slot Locate(size_t index) const {
+        size_t position = m_headOffset + index;
+        size_t ringIndex = (m_ringHead + (position >> BLOCK_SHIFT)) & (m_ring.size() - 1);
+        return { m_ring[ringIndex], position & (BLOCK_SIZE - 1) };
+    }
+
+    // Резервирование блоков под заданное число волн при любом положении головы
+    void ReserveForSize(size_t size);
+
+    // Взятие свободного блока
+    Block* AcquireBlock();
+
+    // Расширение кольца указателей до заданного числа блоков
+    void GrowRing(size_t blocks);
+
+    // Добавление блока в хвост кольца указателей
+    void AppendBlock(Block* block);
+
+private:
+    std::vector<std::unique_ptr<Block>> m_storage;   // Все выделенные блоки (владение)
+    std::vector<Block*> m_freeBlocks;                // Блоки, не занятые живыми записями
+    std::vector<Block*> m_ring;                      // Кольцо указателей на занятые блоки (размер - степень двойки)
+    size_t m_ringHead;                               // Индекс первого занятого блока в кольце
+    size_t m_blocksInUse;                            // Число занятых блоков
+    size_t m_headOffset;                             // Смещение самой старой записи в первом блоке
+    size_t m_size;                                   // Число живых записей
+    size_t m_peakSize;                               // Наибольшее число записей, под которое есть блоки
+};
+
+// Обход всех волн от самой старой
+template <typename Visitor>
+void WaveRing::ForEach(Visitor&& visit) const
+{
+    size_t offset = m_headOffset;
+    size_t remaining = m_size;
+    for (size_t b = 0; remaining > 0; ++b) {
+        const Block* block = m_ring[(m_ringHead + b) & (m_ring.size() - 1)];
+        size_t end = offset + remaining < BLOCK_SIZE ? offset + remaining : BLOCK_SIZE;
+        for (size_t i = offset; i < end; ++i) {
+            visit(block->x[i], block->y[i], block->birthTime[i]);
+        }
+        remaining -= end - offset;
+        offset = 0;
+    }
+}
@@ -0,0 +1,79 @@
+#include "WaveStore.h"
+
+#include <algorithm>
+
+// Конструктор
+WaveStore::WaveStore(float speed, float maxRadius) :
+    m_ring(speed, maxRadius),
+    m_uniform(true),
+    m_poolTime(0.0),
+    m_removedOnAdd(0)
+{
+}
+
+// Добавление волны с общими параметрами
+void WaveStore::Add(float x, float y, double now)
+{
+    Add(x, y, now, m_ring.Speed(), m_ring.MaxRadius());
+}
+
+// Добавление волны с собственными параметрами
+void WaveStore::Add(float x, float y, double now, float speed, float maxRadius)
+{
+    bool matchesRing = speed == m_ring.Speed() && maxRadius == m_ring.MaxRadius();
+    if (m_uniform && matchesRing) {
+        m_ring.Add(x, y, now);
+        return;
+    }
+
+    if (m_uniform) {
+        SwitchToPool(now);
+    }
+
+    // Пул хранит состояние на момент m_poolTime: до добавления волны он продвигается
+    // к now, иначе новая волна при следующем Update прошла бы лишнее время.
+    // Волна из прошлого относительно пула рождается с уже пройденным радиусом
+    float radius = 0.0f;
+    if (now > m_poolTime) {
+        m_removedOnAdd += m_pool.Update(static_cast<float>(now - m_poolTime));
+        m_poolTime = now;
+    } else {
+        radius = std::min(speed * static_cast<float>(m_poolTime - now), maxRadius);
+    }
+    m_pool.Add(x, y, maxRadius, speed, radius);
+}
+
+// Продвижение к моменту now
+size_t WaveStore::Update(double now)
+{
+    if (m_uniform) {
+        return m_ring.DropExpired(now);
+    }
+
+    size_t removed = m_pool.Update(static_cast<float>(now - m_poolTime)) + m_removedOnAdd;
+    m_poolTime = now;
+    m_removedOnAdd = 0;
+
+    // Волны с особыми параметрами погасли - возвращаемся к кольцу
+    if (m_pool.Empty()) {
+        m_uniform = true;
+    }
+    return removed;
+}
+
+// Перенос волн из кольца в общий пул
+void WaveStore::SwitchToPool(double now)
+{
+    m_removedOnAdd += m_ring.DropExpired(now);
+    m_pool.Clear();
+    m_pool.Reserve(m_ring.Size() + 1);
+
+    for (size_t i = 0; i < m_ring.Size(); ++i) {
+        AnalyticWave wave = m_ring[i];
+        m_pool.Add(wave.x, wave.y, m_ring.MaxRadius(), m_ring.Speed(), m_ring.RadiusAt(wave, now));
+    }
+
+    m_ring.Clear();
+    m_uniform = false;
+    m_poolTime = now;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+
+#include "AnalyticWaves.h"
+#include "WavePool.h"
+
+// Хранилище волн с выбором представления.
+// Пока все волны имеют общие скорость и максимальный радиус, они лежат
+// в кольцевом буфере по моменту рождения и не требуют покадровой записи.
+// Первая волна с иными параметрами переводит хранилище на общий пул
+// с покадровым интегрированием; когда пул опустеет, хранилище возвращается к кольцу
+class WaveStore {
+public:
+    WaveStore(float speed, float maxRadius);
+
+    // Добавление волны с общими параметрами
+    void Add(float x, float y, double now);
+
+    // Добавление волны с собственными параметрами
+    void Add(float x, float y, double now, float speed, float maxRadius);
+
+    // Продвижение к моменту now и удаление погасших волн.
+    // Возвращает число удалённых волн
+    size_t Update(double now);
+
+    size_t Size() const { return m_uniform ? m_ring.Size() : m_pool.Size(); }
+    bool Empty() const { return Size() == 0; }
+
+    // Используется ли кольцевой буфер (все волны с общими параметрами)
+    bool IsUniform() const { return m_uniform; }
+
+    // Обход живых волн в порядке хранения: visit(x, y, radius, opacity)
+    template <typename Visitor>
+    void ForEachWave(double now, Visitor&& visit) const;
+
+private:
+    // Перенос волн из кольца в общий пул с вычислением их текущего состояния
+    void SwitchToPool(double now);
+
+private:
+    AnalyticWaveList m_ring;    // Волны с общими параметрами
+    WavePool m_pool;            // Волны с собственными скоростями
+    bool m_uniform;             // Активно ли кольцо
+    double m_poolTime;          // Момент, к которому продвинут пул
+    size_t m_removedOnAdd;      // Волны, погасшие при продвижении пула в Add (учитываются в Update)
+};
+
+// Обход живых волн
+template <typename Visitor>
+void WaveStore::ForEachWave(double now, Visitor&& visit) const
+{
+    if (m_uniform) {
+        m_ring.ForEach([&](float x, float y, double birthTime) {
+            AnalyticWave wave = { x, y, birthTime };
+            float opacity = m_ring.OpacityAt(wave, now);
+            if (opacity > 0.0f) {
+                visit(x, y, m_ring.RadiusAt(wave, now), opacity);
+            }
+        });
+        return;
+    }
+
+    const float* x = m_pool.X();
+    const float* y = m_pool.Y();
+    const float* radius = m_pool.Radius();
+    const float* opacity = m_pool.Opacity();
+    for (size_t i = 0; i < m_pool.Size(); ++i) {
+        visit(x[i], y[i], radius[i], opacity[i]);
+    }
+}
@@ -1,18 +1,61 @@
 #include "WaterEffect.h"
+#include "Logger.h"
 #include <windows.h>
 #include <windowsx.h>
+#include <cstring>
+#include <cstdlib>
+#include <string>
 
 // Точка входа в приложение
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 {
     // Предотвращаем предупреждения компилятора о неиспользуемых параметрах
     UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
     UNREFERENCED_PARAMETER(nCmdShow);
 
     // Создаем экземпляр класса эффекта воды
     WaterEffect waterEffect;
 
+    // Выбираем способ хранения волн по аргументам командной строки
+    if (lpCmdLine && std::strstr(lpCmdLine, "--analytic")) {
+        waterEffect.SetWaveMode(WaveMode::Analytic);
+    }
+    if (lpCmdLine && std::strstr(lpCmdLine, "--heightfield")) {
+        waterEffect.SetWaveMode(WaveMode::HeightField);
+    }
+
+    // Размер ячейки поля высот: --cell-size=N (пикселей)
+    const char* cellSize = lpCmdLine ? std::strstr(lpCmdLine, "--cell-size=") : nullptr;
+    if (cellSize) {
+        waterEffect.SetHeightFieldCellSize(std::atoi(cellSize + std::strlen("--cell-size=")));
+    }
+
+    // Запись трассы входных событий: --record=путь (до пробела)
+    const char* record = lpCmdLine ? std::strstr(lpCmdLine, "--record=") : nullptr;
+    if (record) {
+        record += std::strlen("--record=");
+        waterEffect.SetTracePath(std::string(record, std::strcspn(record, " ")).c_str());
+    }
+
+    // Зоны времени для Perfetto: --trace-zones=путь (до пробела), сохраняются при выходе
+    const char* zones = lpCmdLine ? std::strstr(lpCmdLine, "--trace-zones=") : nullptr;
+    if (zones) {
+        zones += std::strlen("--trace-zones=");
+        waterEffect.SetZoneTracePath(std::string(zones, std::strcspn(zones, " ")).c_str());
+    }
+
+    // Двоичный журнал с идентификаторами сообщений: --log-binary
+    if (lpCmdLine && std::strstr(lpCmdLine, "--log-binary")) {
+        waterEffect.SetLogFormat(LogFormat::Binary);
+    }
+
+    // Фильтр журнала во время работы: --log-level=trace|debug|info|warning|error
+    const char* logLevel = lpCmdLine ? std::strstr(lpCmdLine, "--log-level=") : nullptr;
+    LogLevel level = LogLevel::Trace;
+    if (logLevel && ParseLogLevel(logLevel + std::strlen("--log-level="), level)) {
+        GetLogger().SetLevel(level);
+    }
+
     // Инициализируем приложение
     if (!waterEffect.Initialize(hInstance)) {
         MessageBoxW(nullptr, L"Не удалось инициализировать приложение", L"Ошибка", MB_OK | MB_ICONERROR);
@@ -0,0 +1,74 @@
+#include "TestHarness.h"
+#include "WaveStore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr float MAX_WAVE_RADIUS = 300.0f;
+constexpr float WAVE_SPEED = 150.0f * 1.5f;
+constexpr double FRAME_TIME = 0.016;
+
+// Радиусы волн хранилища с неотрицательной координатой X в порядке хранения
+void CollectRadii(const WaveStore& store, double now, std::vector<float>& radii)
+{
+    radii.clear();
+    store.ForEachWave(now, [&](float x, float, float radius, float) {
+        if (x >= 0.0f) {
+            radii.push_back(radius);
+        }
+    });
+}
+
+// Проверка хранилища на пуле: волны с общими параметрами, рождённые между кадрами,
+// расширяются и гаснут так же, как в кольце, где радиус вычисляется по возрасту
+bool CheckPoolMatchesRing()
+{
+    WaveStore ring(WAVE_SPEED, MAX_WAVE_RADIUS);
+    WaveStore pool(WAVE_SPEED, MAX_WAVE_RADIUS);
+
+    // Медленная волна с собственной скоростью держит второе хранилище на пуле
+    pool.Add(-1.0f, -1.0f, 0.0, WAVE_SPEED * 0.01f, MAX_WAVE_RADIUS);
+
+    std::vector<float> ringRadii;
+    std::vector<float> poolRadii;
+    double now = 0.0;
+    float worst = 0.0f;
+    for (int frame = 1; frame <= 240; ++frame) {
+        if (frame % 3 == 0) {
+            double birth = now + FRAME_TIME * (frame % 2 == 0 ? 0.25 : 0.75);
+            ring.Add(static_cast<float>(frame), 0.0f, birth);
+            pool.Add(static_cast<float>(frame), 0.0f, birth);
+        }
+        now += FRAME_TIME;
+        ring.Update(now);
+        pool.Update(now);
+
+        CollectRadii(ring, now, ringRadii);
+        CollectRadii(pool, now, poolRadii);
+        if (pool.IsUniform() || ringRadii.size() != poolRadii.size()) {
+            std::printf("wave_store: кадр %d: %zu волн в пуле вместо %zu\n",
+                        frame, poolRadii.size(), ringRadii.size());
+            return false;
+        }
+        for (size_t i = 0; i < ringRadii.size(); ++i) {
+            worst = std::max(worst, std::fabs(poolRadii[i] - ringRadii[i]));
+        }
+        if (worst > 0.01f) {
+            std::printf("wave_store: кадр %d: радиус в пуле отличается от кольца на %.3f\n", frame, worst);
+            return false;
+        }
+    }
+    std::printf("  wave_store: радиусы пула совпадают с кольцом (наибольшее расхождение %.5f)\n", worst);
+    return true;
+}
+
+} // namespace
+
+// Проверки хранилища волн, заданных моментом рождения
+bool RunAnalyticWaveTests()
+{
+    return CheckPoolMatchesRing();
+}
@@ -0,0 +1,79 @@
+#include "TestHarness.h"
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Точный процентиль отсортированной выборки (то же правило, что у гистограммы)
+uint64_t ExactPercentile(const std::vector<uint64_t>& sorted, double percent)
+{
+    size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+// Проверка гистограммы: процентили отличаются от точных не больше чем на
+// 1/SUB_BUCKET_HALF_COUNT, минимум и максимум точные, слияние равно общей записи
+bool CheckHistogramAccuracy()
+{
+    std::mt19937_64 random(7);
+    std::lognormal_distribution<double> latency(std::log(200000.0), 1.2);    // ~200 мкс с длинным хвостом
+
+    std::unique_ptr<LatencyHistogram> all(new LatencyHistogram());
+    std::unique_ptr<LatencyHistogram> halves[2] = { std::unique_ptr<LatencyHistogram>(new LatencyHistogram()),
+                                                    std::unique_ptr<LatencyHistogram>(new LatencyHistogram()) };
+    std::vector<uint64_t> values(200000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<uint64_t>(latency(random)) + (i % 97);
+        all->Record(values[i]);
+        halves[i % 2]->Record(values[i]);
+    }
+    halves[0]->Merge(*halves[1]);
+    std::sort(values.begin(), values.end());
+
+    const double percents[] = { 0.0, 1.0, 50.0, 90.0, 99.0, 99.9, 99.99, 100.0 };
+    double tolerance = 1.0 / static_cast<double>(LatencyHistogram::SUB_BUCKET_HALF_COUNT);
+    double worst = 0.0;
+    for (double percent : percents) {
+        double exact = static_cast<double>(ExactPercentile(values, percent));
+        double approximate = static_cast<double>(all->Percentile(percent));
+        double error = std::fabs(approximate - exact) / exact;
+        worst = std::max(worst, error);
+        if (error > tolerance || halves[0]->Percentile(percent) != all->Percentile(percent)) {
+            std::printf("latency_histogram: p%g = %.0f вместо %.0f (погрешность %.4f)\n",
+                        percent, approximate, exact, error);
+            return false;
+        }
+    }
+    if (all->Min() != values.front() || all->Max() != values.back() || all->Count() != values.size()) {
+        std::printf("latency_histogram: минимум, максимум или число записей не совпадают\n");
+        return false;
+    }
+
+    // Значения за пределами диапазона не ломают счётчики
+    LatencyHistogram& edge = *halves[1];
+    edge.Reset();
+    edge.Record(0);
+    edge.Record(1);
+    edge.Record(UINT64_MAX);
+    if (edge.Count() != 3 || edge.Min() != 0 || edge.Max() != LatencyHistogram::MAX_VALUE ||
+        edge.Percentile(100.0) != LatencyHistogram::MAX_VALUE) {
+        std::printf("latency_histogram: крайние значения учтены неверно\n");
+        return false;
+    }
+    std::printf("  latency_histogram: наибольшая погрешность процентиля %.4f (допуск %.4f), %zu байт\n",
+                worst, tolerance, sizeof(LatencyHistogram));
+    return true;
+}
+
+} // namespace
+
+// Проверки гистограмм времени кадра
+bool RunFrameStatsTests()
+{
+    return CheckHistogramAccuracy();
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdio>
+
+// Наборы проверок по подсистемам. Каждая проверка печатает причину сбоя и возвращает false;
+// набор выполняет все свои проверки и возвращает false, если не прошла хотя бы одна
+bool RunWavePoolTests();
+bool RunWaveKernelTests();
+bool RunAnalyticWaveTests();
+bool RunHeightFieldTests();
+bool RunSimulationTests();
+bool RunRasterizerTests();
+bool RunLoggerTests();
+bool RunTraceZoneTests();
+bool RunFrameStatsTests();
+
+// Не даёт компилятору выбросить вычисление, результат которого не используется
+template <typename T>
+void DoNotOptimize(T value)
+{
+    static volatile T sink;
+    sink = value;
+    (void)sink;
+}
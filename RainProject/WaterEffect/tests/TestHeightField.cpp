@@ -0,0 +1,106 @@
+#include "TestHarness.h"
+#include "HeightField.h"
+#include "HeightFieldKernels.h"
+#include "ThreadPool.h"
+
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Сверка ядра с эталонной скалярной реализацией на нескольких шагах
+bool CheckParity(const HeightFieldKernel& kernel)
+{
+    const size_t width = 1027;
+    const size_t stride = width + 2;
+    const size_t rows = 3;
+
+    std::mt19937 rng(777);
+    std::uniform_real_distribution<float> value(-50.0f, 50.0f);
+
+    std::vector<float> current(stride * rows);
+    std::vector<float> reference(stride);
+    for (float& cell : current) {
+        cell = value(rng);
+    }
+    for (float& cell : reference) {
+        cell = value(rng);
+    }
+    std::vector<float> candidate = reference;
+
+    for (int step = 0; step < 16; ++step) {
+        float expected = StepHeightFieldRowScalar(&current[1], &current[stride + 1], &current[2 * stride + 1],
+                                                  &reference[1], width, 0.98f);
+        float actual = kernel.stepRow(&current[1], &current[stride + 1], &current[2 * stride + 1],
+                                      &candidate[1], width, 0.98f);
+        if (expected != actual ||
+            std::memcmp(reference.data(), candidate.data(), stride * sizeof(float)) != 0) {
+            std::printf("heightfield_kernel.%s: расхождение с эталоном на шаге %d\n", kernel.name, step);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Поле с волнами по всей площади: все плитки активны
+void Excite(HeightField& field)
+{
+    for (int y = 16; y < field.Height(); y += HeightField::TILE_SIZE) {
+        for (int x = 16; x < field.Width(); x += HeightField::TILE_SIZE) {
+            field.AddImpulse(static_cast<float>(x), static_cast<float>(y), 12.0f, 96.0f);
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        field.Step();
+    }
+}
+
+// Параллельный шаг должен совпадать с последовательным побитово
+bool CheckParallelParity(ThreadPool& pool)
+{
+    HeightField serial;
+    HeightField parallel;
+    serial.Resize(643, 357);
+    parallel.Resize(643, 357);
+    Excite(serial);
+    Excite(parallel);
+
+    for (int step = 0; step < 32; ++step) {
+        serial.Step();
+        parallel.Step(&pool);
+    }
+
+    for (int y = 0; y < serial.Height(); ++y) {
+        for (int x = 0; x < serial.Width(); ++x) {
+            if (serial.At(x, y) != parallel.At(x, y)) {
+                std::printf("heightfield.parallel: расхождение в ячейке (%d, %d)\n", x, y);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// Проверки поля высот: ядра шага против скалярного эталона и параллельный шаг
+// против последовательного на разном числе потоков
+bool RunHeightFieldTests()
+{
+    const HeightFieldKernel* kernels[8];
+    size_t kernelCount = GetAvailableHeightFieldKernels(kernels, 8);
+
+    bool passed = true;
+    for (size_t k = 0; k < kernelCount; ++k) {
+        passed = CheckParity(*kernels[k]) && passed;
+    }
+
+    size_t maxThreads = std::thread::hardware_concurrency();
+    for (size_t threads : { size_t(1), size_t(2), size_t(4), maxThreads > 0 ? maxThreads : size_t(1) }) {
+        ThreadPool pool(threads);
+        passed = CheckParallelParity(pool) && passed;
+    }
+    return passed;
+}
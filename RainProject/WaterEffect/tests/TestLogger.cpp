@@ -0,0 +1,459 @@
+#include "TestHarness.h"
+#include "LogThrottle.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Временный файл журнала для проверок
+const char* const TEST_LOG_PATH = "./water_tests_log.txt";
+
+// Временный двоичный файл журнала
+const char* const TEST_BINARY_LOG_PATH = "./water_tests_log.bin";
+
+// Временный журнал из сегментов
+const char* const TEST_ROTATING_LOG_PATH = "./water_tests_rotating.txt";
+
+// Число строк в файле
+size_t CountLines(const char* path)
+{
+    FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+
+    size_t lines = 0;
+    char buffer[4096];
+    size_t read = 0;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (size_t i = 0; i < read; ++i) {
+            lines += buffer[i] == '\n' ? 1 : 0;
+        }
+    }
+    std::fclose(file);
+    return lines;
+}
+
+// Проверка журнала: несколько потоков пишут одновременно, каждая принятая
+// запись попадает в файл, каждая непринятая учтена в счётчике потерь
+bool CheckLoggerAccounting()
+{
+    const size_t threadCount = 4;
+    const size_t perThread = 20000;
+
+    Logger logger;
+    if (!logger.Open(TEST_LOG_PATH)) {
+        std::printf("logger: не удалось открыть %s\n", TEST_LOG_PATH);
+        return false;
+    }
+
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < threadCount; ++t) {
+        producers.emplace_back([&logger, t]() {
+            for (size_t i = 0; i < perThread; ++i) {
+                logger.Printf("Поток %zu, запись %zu", t, i);
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+
+    logger.Flush();
+    uint64_t written = logger.Written();
+    uint64_t dropped = logger.Dropped();
+    logger.Close();
+
+    // Строка о потерях добавляется к записям, если что-то было отброшено
+    size_t lines = CountLines(TEST_LOG_PATH);
+    size_t reportLines = lines - static_cast<size_t>(written);
+    if (written + dropped != threadCount * perThread || lines < written || (dropped == 0 && reportLines != 0)) {
+        std::printf("logger: учёт записей не сходится (принято %llu, потеряно %llu, строк %zu)\n",
+                    static_cast<unsigned long long>(written), static_cast<unsigned long long>(dropped), lines);
+        return false;
+    }
+    std::printf("  logger: %zu записей из %zu потоков, потеряно %llu\n",
+                threadCount * perThread, threadCount, static_cast<unsigned long long>(dropped));
+    return true;
+}
+
+// Закрытие во время записи: каждая запись, которую принял Printf, попадает в файл,
+// даже если позиция в очереди выдана производителю перед самым закрытием
+bool CheckCloseWhileWriting()
+{
+    const size_t threadCount = 4;
+    for (int round = 0; round < 20; ++round) {
+        Logger logger;
+        if (!logger.Open(TEST_LOG_PATH)) {
+            std::printf("logger: не удалось открыть %s\n", TEST_LOG_PATH);
+            return false;
+        }
+
+        std::atomic<uint64_t> accepted(0);
+        std::vector<std::thread> producers;
+        for (size_t t = 0; t < threadCount; ++t) {
+            producers.emplace_back([&logger, &accepted, t]() {
+                for (size_t i = 0;; ++i) {
+                    if (logger.Printf("Поток %zu, запись %zu", t, i)) {
+                        accepted.fetch_add(1, std::memory_order_relaxed);
+                    } else if (!logger.IsOpen()) {
+                        break;
+                    }
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        logger.Close();
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+
+        if (logger.Written() != accepted.load()) {
+            std::printf("logger: после Close записано %llu из %llu принятых записей\n",
+                        static_cast<unsigned long long>(logger.Written()),
+                        static_cast<unsigned long long>(accepted.load()));
+            return false;
+        }
+    }
+    return true;
+}
+
+// Проверка фильтров уровня: записи ниже LOG_MIN_LEVEL вырезаны вместе с аргументами,
+// записи ниже уровня во время работы не вычисляют аргументы
+bool CheckLogLevelFiltering()
+{
+    Logger& logger = GetLogger();
+    logger.Open(TEST_LOG_PATH);
+
+    int evaluated = 0;
+    logger.SetLevel(LogLevel::Trace);
+    WATER_LOG_TRACE("trace %d", ++evaluated);
+    int expected = LOG_MIN_LEVEL <= LogLevel::Trace ? 1 : 0;
+
+    logger.SetLevel(LogLevel::Error);
+    WATER_LOG_INFO("info %d", ++evaluated);
+    WATER_LOG_ERROR("error %d", ++evaluated);
+    expected += 1;
+
+    logger.SetLevel(LogLevel::Trace);
+    logger.Close();
+
+    if (evaluated != expected) {
+        std::printf("logger: фильтр уровней вычислил %d аргументов вместо %d\n", evaluated, expected);
+        return false;
+    }
+    std::printf("  logger: минимальный уровень сборки %d\n", static_cast<int>(LOG_MIN_LEVEL));
+    return true;
+}
+
+// Содержимое файла целиком
+std::string ReadFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Длительная проверка журнала из сегментов: несколько потоков пишут без потерь
+// (повторяя запись при переполнении очереди), сегменты много раз сменяются по кругу.
+// На диске остаётся не больше segmentCount сегментов не больше segmentSize байт,
+// в них только целые строки, а записи каждого потока идут по возрастанию
+// и заканчиваются последней записанной
+bool CheckRotatingLogSoak()
+{
+    const size_t threadCount = 4;
+    const size_t perThread = 100000;
+    const size_t segmentSize = 256 * 1024;
+    const size_t segmentCount = 3;
+
+    Logger logger;
+    if (!logger.OpenRotating(TEST_ROTATING_LOG_PATH, LogFormat::Text, segmentSize, segmentCount)) {
+        std::printf("logger: не удалось открыть сегменты %s\n", TEST_ROTATING_LOG_PATH);
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < threadCount; ++t) {
+        producers.emplace_back([&logger, t]() {
+            for (size_t i = 0; i < perThread; ++i) {
+                while (!logger.Printf("Поток %zu, запись %zu", t, i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    logger.Flush();
+    uint64_t written = logger.Written();
+    uint64_t rotations = logger.Rotations();
+    logger.Close();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Сегменты от самого старого к текущему
+    size_t current = static_cast<size_t>(rotations % segmentCount);
+    std::vector<size_t> last(threadCount, 0);
+    std::vector<bool> seen(threadCount, false);
+    bool valid = written == threadCount * perThread && rotations >= 2 * segmentCount;
+    size_t diskBytes = 0;
+    for (size_t k = 1; k <= segmentCount && valid; ++k) {
+        std::string path = MappedLogFile::SegmentPath(TEST_ROTATING_LOG_PATH, (current + k) % segmentCount);
+        std::string content = ReadFile(path);
+        diskBytes += content.size();
+        valid = !content.empty() && content.size() <= segmentSize && content.back() == '\n' &&
+                content.find('\0') == std::string::npos;
+
+        size_t lineStart = 0;
+        while (valid && lineStart < content.size()) {
+            size_t lineEnd = content.find('\n', lineStart);
+            std::string line = content.substr(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+
+            unsigned long long thread = 0;
+            unsigned long long index = 0;
+            if (std::sscanf(line.c_str(), "Поток %llu, запись %llu", &thread, &index) == 2 && thread < threadCount) {
+                valid = !seen[thread] || index > last[thread];
+                seen[thread] = true;
+                last[thread] = static_cast<size_t>(index);
+            } else {
+                valid = line.compare(0, std::strlen("Журнал: потеряно"), "Журнал: потеряно") == 0;
+            }
+        }
+    }
+    // Поток, закончивший раньше других, мог целиком уйти в затёртые сегменты,
+    // но если его записи остались, то последняя из них тоже на месте
+    valid = valid && std::find(seen.begin(), seen.end(), true) != seen.end();
+    for (size_t t = 0; t < threadCount && valid; ++t) {
+        valid = !seen[t] || last[t] == perThread - 1;
+    }
+    for (size_t i = segmentCount; i < segmentCount + 2; ++i) {
+        valid = valid && !std::ifstream(MappedLogFile::SegmentPath(TEST_ROTATING_LOG_PATH, i)).good();
+    }
+
+    // Двоичные сегменты читаются по отдельности: каждый начинается с заголовка
+    bool binaryValid = logger.OpenRotating(TEST_ROTATING_LOG_PATH, LogFormat::Binary, 64 * 1024, 2);
+    for (size_t i = 0; i < 20000 && binaryValid; ++i) {
+        while (!logger.Event<LogMessageId::ActiveTiles>(i, static_cast<size_t>(2040))) {
+            std::this_thread::yield();
+        }
+    }
+    logger.Close();
+    size_t binaryRecords = 0;
+    for (size_t segment = 0; segment < 2 && binaryValid; ++segment) {
+        std::string content = ReadFile(MappedLogFile::SegmentPath(TEST_ROTATING_LOG_PATH, segment));
+        binaryValid = content.size() >= sizeof(LogFileHeader) && content.compare(0, 4, "WLOG") == 0;
+        size_t offset = sizeof(LogFileHeader);
+        while (binaryValid && offset < content.size()) {
+            LogRecordHeader record = {};
+            char text[256];
+            size_t textLength = 0;
+            std::memcpy(&record, content.data() + offset, std::min(sizeof(record), content.size() - offset));
+            offset += sizeof(record);
+            binaryValid = offset + record.length <= content.size() &&
+                          FormatLogEvent(reinterpret_cast<const uint8_t*>(content.data() + offset), record.length,
+                                         text, sizeof(text), textLength);
+            offset += record.length;
+            ++binaryRecords;
+        }
+        std::remove(MappedLogFile::SegmentPath(TEST_ROTATING_LOG_PATH, segment).c_str());
+    }
+    for (size_t segment = 0; segment < segmentCount; ++segment) {
+        std::remove(MappedLogFile::SegmentPath(TEST_ROTATING_LOG_PATH, segment).c_str());
+    }
+
+    if (!valid || !binaryValid) {
+        std::printf("logger: сегменты журнала повреждены (записано %llu, смен сегмента %llu, двоичных записей %zu)\n",
+                    static_cast<unsigned long long>(written), static_cast<unsigned long long>(rotations),
+                    binaryRecords);
+        return false;
+    }
+    std::printf("  logger: %zu записей за %.2f с, смен сегмента %llu, на диске %zu байт из %zu\n",
+                threadCount * perThread, seconds, static_cast<unsigned long long>(rotations), diskBytes,
+                segmentSize * segmentCount);
+    return true;
+}
+
+// Одинаковый набор записей для текстового и двоичного журнала
+void WriteSampleRecords(Logger& logger)
+{
+    logger.Event<LogMessageId::EffectInitialized>();
+    logger.Event<LogMessageId::RawInputRegistrationFailed>(1400ul);
+    logger.Event<LogMessageId::UpdateWaves>(static_cast<size_t>(12));
+    logger.Event<LogMessageId::ActiveTiles>(static_cast<size_t>(3), static_cast<size_t>(2040));
+    logger.Event<LogMessageId::EndDrawFailed>(static_cast<long>(0x8899000C));
+    logger.Event<LogMessageId::WaveCreated>(640.5f, -12.25f);
+    logger.Event<LogMessageId::MessageReceived>(15u, " (WM_PAINT)");
+    logger.Event<LogMessageId::ClickMessage>(-5, 700);
+    logger.Event<LogMessageId::RawInputClick>(-1l, 1079l);
+    logger.Event<LogMessageId::FreeText>("");
+    logger.Printf("Текст, %d%% \"в кавычках\"", 42);
+}
+
+// Проверка двоичного журнала: после декодирования тех же записей получается
+// тот же текст, что пишет текстовый журнал
+bool CheckBinaryLogRoundTrip()
+{
+    Logger logger;
+    if (!logger.Open(TEST_LOG_PATH)) {
+        std::printf("logger: не удалось открыть %s\n", TEST_LOG_PATH);
+        return false;
+    }
+    WriteSampleRecords(logger);
+    logger.Close();
+
+    if (!logger.Open(TEST_BINARY_LOG_PATH, false, LogFormat::Binary)) {
+        std::printf("logger: не удалось открыть %s\n", TEST_BINARY_LOG_PATH);
+        return false;
+    }
+    WriteSampleRecords(logger);
+    logger.Close();
+
+    std::string expected;
+    std::ifstream textFile(TEST_LOG_PATH, std::ios::binary);
+    expected.assign(std::istreambuf_iterator<char>(textFile), std::istreambuf_iterator<char>());
+
+    std::string decoded;
+    size_t records = 0;
+    bool valid = false;
+    FILE* file = std::fopen(TEST_BINARY_LOG_PATH, "rb");
+    LogFileHeader header = {};
+    if (file && std::fread(&header, sizeof(header), 1, file) == 1 && std::memcmp(header.magic, "WLOG", 4) == 0 &&
+        header.version == LOG_FILE_VERSION && header.messageCount == static_cast<uint32_t>(LogMessageId::Count)) {
+        valid = true;
+        LogRecordHeader record = {};
+        uint8_t payload[Logger::MAX_RECORD_LENGTH + 4];
+        char text[512];
+        while (valid && std::fread(&record, sizeof(record), 1, file) == 1) {
+            size_t textLength = 0;
+            valid = record.length <= sizeof(payload) &&
+                    std::fread(payload, 1, record.length, file) == record.length &&
+                    FormatLogEvent(payload, record.length, text, sizeof(text), textLength);
+            decoded.append(text, textLength);
+            decoded.push_back('\n');
+            ++records;
+        }
+    }
+    if (file) {
+        std::fclose(file);
+    }
+    std::remove(TEST_BINARY_LOG_PATH);
+
+    if (!valid || decoded != expected) {
+        std::printf("logger: двоичный журнал после декодирования не совпадает с текстовым\n--- текст:\n%s--- декодер:\n%s",
+                    expected.c_str(), decoded.c_str());
+        return false;
+    }
+    std::printf("  logger: двоичный журнал, %zu записей совпали с текстовым\n", records);
+    return true;
+}
+
+// Проверка ограничителя: поток 1000 сообщений в секунду даёт ограниченное число записей
+// и сводку за окно, а редкие сообщения другой категории проходят все
+bool CheckLogThrottle()
+{
+    const LogThrottle::Limit floodLimit = { 2.0, 20.0, 100 };
+    LogThrottle throttle(2);
+    throttle.SetLimit(0, floodLimit);
+
+    const double duration = 25.0;
+    const double step = 0.001;
+    uint64_t floodLogged = 0;
+    uint64_t rareLogged = 0;
+    uint64_t rareSeen = 0;
+    uint64_t summarySeen = 0;
+    uint64_t summaryLogged = 0;
+    size_t summaries = 0;
+    for (size_t i = 0; i * step < duration; ++i) {
+        double now = static_cast<double>(i) * step;
+        floodLogged += throttle.Allow(0, now) ? 1 : 0;
+        if (i % 1500 == 0) {
+            ++rareSeen;
+            rareLogged += throttle.Allow(1, now) ? 1 : 0;
+        }
+        throttle.Summarize(now, [&](const LogThrottle::Summary& summary) {
+            ++summaries;
+            summarySeen += summary.category == 0 ? summary.seen : 0;
+            summaryLogged += summary.category == 0 ? summary.logged : 0;
+        });
+    }
+
+    // Записано не больше запаса, пополнения и выборки сверх ведра
+    uint64_t floodSeen = static_cast<uint64_t>(duration / step);
+    double bound = floodLimit.burst + floodLimit.ratePerSecond * duration +
+                   static_cast<double>(floodSeen) / floodLimit.sampleEvery + 1.0;
+    if (static_cast<double>(floodLogged) > bound || rareLogged != rareSeen || summaries != 2 ||
+        summarySeen < 19990 || summarySeen > 20010 || summaryLogged > floodLogged) {
+        std::printf("log_throttle: записано %llu из %llu (предел %.0f), редких %llu из %llu, сводок %zu\n",
+                    static_cast<unsigned long long>(floodLogged), static_cast<unsigned long long>(floodSeen), bound,
+                    static_cast<unsigned long long>(rareLogged), static_cast<unsigned long long>(rareSeen), summaries);
+        return false;
+    }
+    std::printf("  log_throttle: из %llu сообщений за %.0f с записано %llu\n",
+                static_cast<unsigned long long>(floodSeen), duration, static_cast<unsigned long long>(floodLogged));
+    return true;
+}
+
+// Сбой открытия следующего сегмента: записи теряются, но журнал не перестаёт писать -
+// сегмент открывается повторно через RETRY_INTERVAL, и в него попадает отчёт о потерях
+bool CheckSegmentRetry()
+{
+    std::string blocked = MappedLogFile::SegmentPath(TEST_ROTATING_LOG_PATH, 1);
+    Logger logger;
+    bool valid = logger.OpenRotating(TEST_ROTATING_LOG_PATH, LogFormat::Text, 4096, 2);
+
+    // Каталог на месте сегмента не даёт создать файл
+    std::error_code error;
+    valid = valid && std::filesystem::create_directory(blocked, error);
+    for (size_t i = 0; i < 1000 && valid; ++i) {
+        logger.Printf("Запись %zu", i);
+    }
+    logger.Flush();
+    uint64_t lost = logger.Dropped();
+    std::filesystem::remove(blocked, error);
+
+    std::this_thread::sleep_for(MappedLogFile::RETRY_INTERVAL + std::chrono::milliseconds(100));
+    logger.Printf("После сбоя");
+    logger.Flush();
+    logger.Close();
+
+    std::string content = ReadFile(blocked);
+    std::string report = "Журнал: потеряно записей: " + std::to_string(lost) + "\n";
+    for (size_t segment = 0; segment < 2; ++segment) {
+        std::remove(MappedLogFile::SegmentPath(TEST_ROTATING_LOG_PATH, segment).c_str());
+    }
+    if (!valid || lost == 0 || content.find("После сбоя\n") == std::string::npos ||
+        content.find(report) == std::string::npos) {
+        std::printf("logger: после сбоя сегмента журнал не восстановился (потеряно %llu)\n",
+                    static_cast<unsigned long long>(lost));
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// Проверки журнала: учёт записей, фильтры уровня, двоичный формат, ограничитель
+// и длительная запись в сегменты по кругу
+bool RunLoggerTests()
+{
+    bool passed = CheckLoggerAccounting();
+    passed = CheckCloseWhileWriting() && passed;
+    passed = CheckLogLevelFiltering() && passed;
+    passed = CheckBinaryLogRoundTrip() && passed;
+    passed = CheckLogThrottle() && passed;
+    passed = CheckRotatingLogSoak() && passed;
+    passed = CheckSegmentRetry() && passed;
+    std::remove(TEST_LOG_PATH);
+    std::remove(TEST_BINARY_LOG_PATH);
+    return passed;
+}
@@ -0,0 +1,355 @@
+#include "TestHarness.h"
+#include "DirtyRegion.h"
+#include "DiscRasterizer.h"
+#include "SpanKernels.h"
+#include "ThreadPool.h"
+#include "TileRenderer.h"
+#include "WaterSimulation.h"
+#include "WaveDrawList.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int SCREEN_WIDTH = 1920;
+constexpr int SCREEN_HEIGHT = 1080;
+
+// Волны установившегося режима: радиусы равномерно от нуля до максимума,
+// прозрачность убывает с радиусом, как у настоящих волн
+void FillDrawList(WaveDrawList& list, size_t waves, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> x(0.0f, static_cast<float>(SCREEN_WIDTH));
+    std::uniform_real_distribution<float> y(0.0f, static_cast<float>(SCREEN_HEIGHT));
+    std::uniform_real_distribution<float> radius(0.0f, WaterSimulation::MAX_WAVE_RADIUS);
+
+    list.Clear();
+    for (size_t i = 0; i < waves; ++i) {
+        float r = radius(random);
+        list.AddWave(x(random), y(random), r, 1.0f - r / WaterSimulation::MAX_WAVE_RADIUS);
+    }
+}
+
+// Проверка растеризатора на известных значениях
+bool CheckRasterizer()
+{
+    Framebuffer frame(64, 64);
+    WaveDrawList list;
+    list.AddWave(32.0f, 32.0f, 20.0f, 1.0f);
+    RasterizeDrawList(frame, list);
+
+    // Центр покрыт обоими кругами полностью: LightBlue 0.5 поверх DeepSkyBlue 0.3
+    PremultipliedColor outer = PremultiplyDisc(list.Data()[0]);
+    PremultipliedColor inner = PremultiplyDisc(list.Data()[1]);
+    uint32_t expected = BlendOver(BlendOver(0u, outer, 255), inner, 255);
+    if (frame.Row(32)[32] != expected || expected != PackBgra(87, 137, 153, 166)) {
+        std::printf("raster: цвет центра волны 0x%08x, ожидалось 0x%08x\n", frame.Row(32)[32], expected);
+        return false;
+    }
+
+    // Кольцо между кругами покрыто только внешним, угол кадра не тронут
+    if (frame.Row(32)[32 + 16] != BlendOver(0u, outer, 255) || frame.Row(0)[0] != 0u) {
+        std::printf("raster: неверное покрытие кольца или фона\n");
+        return false;
+    }
+
+    // Предумноженный кадр: ни одна компонента не превышает альфу, даже при наложении многих волн
+    Framebuffer busy(SCREEN_WIDTH / 4, SCREEN_HEIGHT / 4);
+    FillDrawList(list, 200, 3);
+    RasterizeDrawList(busy, list);
+    for (int y = 0; y < busy.Height(); ++y) {
+        for (int x = 0; x < busy.Width(); ++x) {
+            uint32_t pixel = busy.Row(y)[x];
+            uint32_t a = pixel >> 24;
+            if (((pixel >> 16) & 0xFF) > a || ((pixel >> 8) & 0xFF) > a || (pixel & 0xFF) > a) {
+                std::printf("raster: пиксель (%d, %d) 0x%08x не предумножен\n", x, y, pixel);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Случайный предумноженный пиксель
+uint32_t RandomPremultiplied(std::mt19937& random)
+{
+    std::uniform_int_distribution<uint32_t> byte(0, 255);
+    uint32_t a = byte(random);
+    return PackBgra(byte(random) * a / 255, byte(random) * a / 255, byte(random) * a / 255, a);
+}
+
+// Сверка ядра заливки отрезка со скалярным эталоном: длины отрезков и смещения от начала
+// строки разные, чтобы проверить и основной цикл, и хвосты
+bool CheckSpanKernel(const SpanKernel& kernel)
+{
+    std::mt19937 random(41);
+    std::vector<uint32_t> reference(96);
+    std::vector<uint32_t> candidate(96);
+    for (int round = 0; round < 400; ++round) {
+        for (uint32_t& pixel : reference) {
+            pixel = RandomPremultiplied(random);
+        }
+        candidate = reference;
+        uint32_t color = RandomPremultiplied(random);
+        size_t offset = random() % 8;
+        size_t count = random() % (reference.size() - offset);
+
+        BlendSpanScalar(reference.data() + offset, count, color);
+        kernel.blendSpan(candidate.data() + offset, count, color);
+        if (reference != candidate) {
+            std::printf("span_kernel.%s: расхождение с эталоном (цвет 0x%08x, %zu пикселей)\n",
+                        kernel.name, color, count);
+            return false;
+        }
+
+        // Два цвета за один проход - то же, что два наложения подряд
+        uint32_t second = RandomPremultiplied(random);
+        BlendSpanScalar(reference.data() + offset, count, color);
+        BlendSpanScalar(reference.data() + offset, count, second);
+        kernel.blendSpan2(candidate.data() + offset, count, color, second);
+        if (reference != candidate) {
+            std::printf("span_kernel.%s: наложение двух цветов 0x%08x, 0x%08x расходится с эталоном (%zu пикселей)\n",
+                        kernel.name, color, second, count);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Построчная заливка с ядром kernel должна совпадать с попиксельной побитово:
+// круги с дробными центрами и радиусами, меньше пикселя, у краёв и за краями кадра
+bool CheckSpanFill(const SpanKernel& kernel)
+{
+    const int width = 203;
+    const int height = 117;
+    Framebuffer reference(width, height);
+    Framebuffer candidate(width, height);
+
+    std::mt19937 random(43);
+    std::uniform_real_distribution<float> x(-40.0f, width + 40.0f);
+    std::uniform_real_distribution<float> y(-40.0f, height + 40.0f);
+    std::uniform_real_distribution<float> radius(0.0f, 90.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int i = 0; i < 2000; ++i) {
+        // Каждый десятый круг - меньше пары пикселей
+        float r = i % 10 == 0 ? radius(random) / 45.0f : radius(random);
+        DiscFill disc = { x(random), y(random), r, unit(random), unit(random), unit(random), unit(random) };
+        FillDiscReference(reference, disc);
+        FillDisc(candidate, disc, kernel);
+    }
+
+    for (int row = 0; row < height; ++row) {
+        if (std::memcmp(reference.Row(row), candidate.Row(row), width * sizeof(uint32_t)) != 0) {
+            for (int column = 0; column < width; ++column) {
+                if (reference.Row(row)[column] != candidate.Row(row)[column]) {
+                    std::printf("raster.%s: пиксель (%d, %d) 0x%08x, у эталона 0x%08x\n", kernel.name,
+                                column, row, candidate.Row(row)[column], reference.Row(row)[column]);
+                    break;
+                }
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+// Первое расхождение кадров или false, если кадры совпадают
+bool FindMismatch(const Framebuffer& reference, const Framebuffer& candidate, int& column, int& row)
+{
+    for (row = 0; row < reference.Height(); ++row) {
+        if (std::memcmp(reference.Row(row), candidate.Row(row), reference.Width() * sizeof(uint32_t)) != 0) {
+            for (column = 0; reference.Row(row)[column] == candidate.Row(row)[column]; ++column) {
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// Заливка волны за один проход должна совпадать с двумя попиксельными заливками кругов
+// побитово: волны с дробными центрами, маленькие (внутренний круг меньше пикселя),
+// прозрачные, у краёв и за краями кадра, а также с отсечением по прямоугольнику
+bool CheckWaveFill(const SpanKernel& kernel)
+{
+    const int width = 203;
+    const int height = 117;
+    Framebuffer reference(width, height);
+    Framebuffer candidate(width, height);
+    Framebuffer referenceClipped(width, height);
+    Framebuffer candidateClipped(width, height);
+
+    std::mt19937 random(47);
+    std::uniform_real_distribution<float> x(-40.0f, width + 40.0f);
+    std::uniform_real_distribution<float> y(-40.0f, height + 40.0f);
+    std::uniform_real_distribution<float> radius(0.0f, 90.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int> clipX(0, width);
+    std::uniform_int_distribution<int> clipY(0, height);
+    WaveDrawList list;
+    for (int i = 0; i < 2000; ++i) {
+        float r = i % 10 == 0 ? radius(random) / 20.0f : radius(random);
+        float opacity = i % 50 == 0 ? 0.0f : unit(random);
+        list.Clear();
+        list.AddWave(x(random), y(random), r, opacity);
+        const DiscFill& outer = list.Outer(0);
+        const DiscFill& inner = list.Inner(0);
+
+        FillDiscReference(reference, outer);
+        FillDiscReference(reference, inner);
+        FillWave(candidate, outer, inner, kernel);
+
+        int x0 = clipX(random);
+        int x1 = clipX(random);
+        int y0 = clipY(random);
+        int y1 = clipY(random);
+        if (x0 > x1) {
+            std::swap(x0, x1);
+        }
+        if (y0 > y1) {
+            std::swap(y0, y1);
+        }
+        FillDiscClipped(referenceClipped, outer, x0, y0, x1, y1, kernel);
+        FillDiscClipped(referenceClipped, inner, x0, y0, x1, y1, kernel);
+        FillWaveClipped(candidateClipped, outer, inner, x0, y0, x1, y1, kernel);
+    }
+
+    int column = 0;
+    int row = 0;
+    if (FindMismatch(reference, candidate, column, row)) {
+        std::printf("raster.wave.%s: пиксель (%d, %d) 0x%08x, у двух заливок 0x%08x\n", kernel.name,
+                    column, row, candidate.Row(row)[column], reference.Row(row)[column]);
+        return false;
+    }
+    if (FindMismatch(referenceClipped, candidateClipped, column, row)) {
+        std::printf("raster.wave.%s: с отсечением пиксель (%d, %d) 0x%08x, у двух заливок 0x%08x\n", kernel.name,
+                    column, row, candidateClipped.Row(row)[column], referenceClipped.Row(row)[column]);
+        return false;
+    }
+    return true;
+}
+
+// Кадр двумя заливками на волну, как в Render() приложения: эталон для быстрых путей
+void RasterizeDiscs(Framebuffer& frame, const WaveDrawList& list)
+{
+    frame.Clear();
+    for (const DiscFill& disc : list) {
+        FillDisc(frame, disc);
+    }
+}
+
+// Кадр по плиткам должен совпадать с последовательной заливкой побитово,
+// в том числе когда размер кадра не кратен плитке
+bool CheckTiledRender(ThreadPool& pool)
+{
+    const int width = SCREEN_WIDTH / 2 + 13;
+    const int height = SCREEN_HEIGHT / 2 + 7;
+    WaveDrawList list;
+    FillDrawList(list, 300, 5);
+
+    Framebuffer reference(width, height);
+    Framebuffer tiled(width, height);
+    RasterizeDiscs(reference, list);
+
+    TileRenderer renderer;
+    renderer.Resize(width, height);
+    tiled.Clear(0xFFFFFFFFu);
+    renderer.Render(tiled, list, &pool);
+
+    for (int y = 0; y < height; ++y) {
+        if (std::memcmp(reference.Row(y), tiled.Row(y), width * sizeof(uint32_t)) != 0) {
+            std::printf("raster.tiled: расхождение с последовательной заливкой в строке %d (%zu потоков)\n",
+                        y, pool.ThreadCount());
+            return false;
+        }
+    }
+    return true;
+}
+
+// Перерисовка только области DirtyRegion должна давать те же кадры, что и полная:
+// волны растут, смещаются, пропадают по одной, а после последней идут пустые кадры
+bool CheckDirtyRender(ThreadPool& pool)
+{
+    const int width = SCREEN_WIDTH / 2 + 13;
+    const int height = SCREEN_HEIGHT / 2 + 7;
+    Framebuffer reference(width, height);
+    Framebuffer partial(width, height);
+    TileRenderer renderer;
+    renderer.Resize(width, height);
+    DirtyRegion region;
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> x(-50.0f, width + 50.0f);
+    std::uniform_real_distribution<float> y(-50.0f, height + 50.0f);
+    std::vector<float> centers;
+    for (int i = 0; i < 6; ++i) {
+        centers.push_back(x(random));
+        centers.push_back(y(random));
+    }
+
+    WaveDrawList list;
+    for (int frame = 0; frame < 60; ++frame) {
+        list.Clear();
+        for (size_t wave = 0; wave < centers.size() / 2; ++wave) {
+            // Волна wave живёт кадры [wave * 3, 30 + wave * 4)
+            int age = frame - static_cast<int>(wave) * 3;
+            if (age >= 0 && age < 30 + static_cast<int>(wave)) {
+                float radius = 1.5f + static_cast<float>(age) * 7.3f;
+                list.AddWave(centers[wave * 2] + age * 0.7f, centers[wave * 2 + 1],
+                             radius, 1.0f - radius / WaterSimulation::MAX_WAVE_RADIUS);
+            }
+        }
+
+        RasterizeDiscs(reference, list);
+        PixelRect area = region.Advance(DrawListBounds(list, width, height));
+        renderer.Render(partial, list, &pool, area);
+        if (renderer.TouchedPixels() != area.Area()) {
+            std::printf("raster.dirty: перерисовано %llu пикселей вместо %llu\n",
+                        static_cast<unsigned long long>(renderer.TouchedPixels()),
+                        static_cast<unsigned long long>(area.Area()));
+            return false;
+        }
+        for (int row = 0; row < height; ++row) {
+            if (std::memcmp(reference.Row(row), partial.Row(row), width * sizeof(uint32_t)) != 0) {
+                std::printf("raster.dirty: расхождение с полной перерисовкой в кадре %d, строке %d\n", frame, row);
+                return false;
+            }
+        }
+    }
+
+    // Без волн в двух кадрах подряд перерисовывать нечего
+    if (!region.Advance(EmptyRect()).Empty()) {
+        std::printf("raster.dirty: непустая область без волн\n");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// Проверки программной растеризации: известные значения, каждое ядро заливки против
+// попиксельного эталона, отрисовка по плиткам и области перерисовки против заливки целиком.
+// Плитки сверяются и на числе потоков больше числа ядер: порядок выполнения тогда перемешивается сильнее
+bool RunRasterizerTests()
+{
+    bool passed = CheckRasterizer();
+
+    const SpanKernel* kernels[8];
+    size_t kernelCount = GetAvailableSpanKernels(kernels, 8);
+    for (size_t k = 0; k < kernelCount; ++k) {
+        passed = CheckSpanKernel(*kernels[k]) && passed;
+        passed = CheckSpanFill(*kernels[k]) && passed;
+        passed = CheckWaveFill(*kernels[k]) && passed;
+    }
+
+    size_t maxThreads = std::thread::hardware_concurrency();
+    for (size_t threads : { size_t(2), size_t(4), maxThreads > 0 ? maxThreads : size_t(1) }) {
+        ThreadPool pool(threads);
+        passed = CheckTiledRender(pool) && passed;
+        passed = CheckDirtyRender(pool) && passed;
+    }
+    return passed;
+}
@@ -0,0 +1,82 @@
+#include "TestHarness.h"
+#include "AllocationTracker.h"
+#include "FrameRunner.h"
+#include "WaterSimulation.h"
+
+namespace {
+
+constexpr int SCREEN_WIDTH = 1920;
+constexpr int SCREEN_HEIGHT = 1080;
+
+// Проверка: кадр в установившемся режиме не выделяет память.
+// Волны появляются с постоянной частотой, поэтому после прогрева их число не растёт,
+// и все пулы, блоки и очереди потоков уже имеют нужный размер
+bool CheckSteadyStateAllocations()
+{
+    if (!ALLOCATION_TRACKING) {
+        std::printf("  allocations: подсчёт выключен (WATER_TRACK_ALLOCATIONS=OFF), проверка пропущена\n");
+        return true;
+    }
+
+    // Счётчик должен видеть выделения, иначе проверка ниже ничего не доказывает.
+    // Явный вызов operator new компилятор не вправе убрать, в отличие от выражения new
+    uint64_t before = AllocationCount();
+    void* probe = ::operator new(64);
+    DoNotOptimize(probe);
+    ::operator delete(probe);
+    if (AllocationCount() - before != 1) {
+        std::printf("allocations: operator new не подсчитывается\n");
+        return false;
+    }
+
+    const int warmupFrames = 200;
+    const int measuredFrames = 200;
+    const int wavesPerFrame = 30;
+    for (WaveMode mode : { WaveMode::Integrated, WaveMode::Analytic, WaveMode::HeightField }) {
+        ManualTimeSource time;
+        WaterSimulation simulation;
+        simulation.SetWaveMode(mode);
+        simulation.SetTimeSource(&time);
+        simulation.Initialize(SCREEN_WIDTH, SCREEN_HEIGHT, 2);
+
+        size_t spawned = 0;
+        float checksum = 0.0f;
+        auto frame = [&]() {
+            for (int i = 0; i < wavesPerFrame; ++i, ++spawned) {
+                simulation.CreateWave(static_cast<float>((spawned * 97) % SCREEN_WIDTH),
+                                      static_cast<float>((spawned * 53) % SCREEN_HEIGHT));
+            }
+            time.Advance(WaterSimulation::SIMULATION_TICK);
+            simulation.Update();
+            simulation.ForEachWave([&](float, float, float radius, float opacity) {
+                checksum += radius * opacity;
+            });
+        };
+
+        for (int i = 0; i < warmupFrames; ++i) {
+            frame();
+        }
+        uint64_t start = AllocationCount();
+        for (int i = 0; i < measuredFrames; ++i) {
+            frame();
+        }
+        uint64_t allocations = AllocationCount() - start;
+        DoNotOptimize(checksum);
+
+        if (allocations != 0) {
+            std::printf("allocations: режим %s выделил память %llu раз за %d кадров установившегося режима\n",
+                        WaveModeName(mode), static_cast<unsigned long long>(allocations), measuredFrames);
+            return false;
+        }
+    }
+    std::printf("  allocations: 0 выделений за %d кадров в каждом режиме\n", measuredFrames);
+    return true;
+}
+
+} // namespace
+
+// Проверки симуляции целиком
+bool RunSimulationTests()
+{
+    return CheckSteadyStateAllocations();
+}
@@ -0,0 +1,92 @@
+#include "TestHarness.h"
+#include "TraceZones.h"
+
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Временный файл зон
+const char* const TEST_ZONES_PATH = "./water_tests_zones.json";
+
+// Число вхождений подстроки
+size_t CountOccurrences(const std::string& text, const std::string& pattern)
+{
+    size_t count = 0;
+    for (size_t position = text.find(pattern); position != std::string::npos;
+         position = text.find(pattern, position + pattern.size())) {
+        ++count;
+    }
+    return count;
+}
+
+// Проверка записи зон: вложенные зоны двух потоков попадают в экспорт
+// с именами потоков, а выключенная запись не оставляет ни одной зоны
+bool CheckTraceZoneExport()
+{
+    if (!WATER_TRACE_ZONES) {
+        std::printf("  trace_zones: вырезаны из сборки (WATER_TRACE_ZONES=0)\n");
+        return true;
+    }
+
+    ZoneRecorder& recorder = GetZoneRecorder();
+    recorder.Clear();
+
+    recorder.SetEnabled(false);
+    {
+        WATER_TRACE_ZONE("test.disabled");
+    }
+    if (recorder.EventCount() != 0) {
+        std::printf("trace_zones: выключенная запись оставила %zu зон\n", recorder.EventCount());
+        return false;
+    }
+
+    const size_t frames = 100;
+    recorder.SetEnabled(true);
+    auto frame = []() {
+        WATER_TRACE_ZONE("test.frame");
+        {
+            WATER_TRACE_ZONE("test.update");
+        }
+        WATER_TRACE_ZONE("test.render");
+    };
+    std::thread worker([&]() {
+        recorder.SetThreadName("test \"worker\"");
+        for (size_t i = 0; i < frames; ++i) {
+            frame();
+        }
+    });
+    for (size_t i = 0; i < frames; ++i) {
+        frame();
+    }
+    worker.join();
+    recorder.SetEnabled(false);
+
+    bool exported = recorder.ExportChromeJson(TEST_ZONES_PATH);
+    std::ifstream file(TEST_ZONES_PATH, std::ios::binary);
+    std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove(TEST_ZONES_PATH);
+
+    size_t expected = 2 * frames * 3;
+    if (!exported || recorder.EventCount() != expected ||
+        CountOccurrences(json, "\"ph\":\"X\"") != expected ||
+        CountOccurrences(json, "\"name\":\"test.update\"") != 2 * frames ||
+        CountOccurrences(json, "test \\\"worker\\\"") != 1 ||
+        json.compare(0, 2, "{\"") != 0 || json.find("\n]}\n") == std::string::npos) {
+        std::printf("trace_zones: экспорт не совпадает (зон %zu из %zu)\n", recorder.EventCount(), expected);
+        return false;
+    }
+    recorder.Clear();
+    std::printf("  trace_zones: %zu зон двух потоков сохранены в формате Chrome Trace Event\n", expected);
+    return true;
+}
+
+} // namespace
+
+// Проверки зон времени
+bool RunTraceZoneTests()
+{
+    return CheckTraceZoneExport();
+}
@@ -0,0 +1,79 @@
+#include "TestHarness.h"
+#include "WaveKernels.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr float MAX_WAVE_RADIUS = 300.0f;
+constexpr float WAVE_SPEED = 150.0f * 1.5f;
+constexpr float FRAME_TIME = 0.016f;
+
+// Состояние волн для одного прогона ядра
+struct KernelState {
+    std::vector<float> radius;
+    std::vector<float> opacity;
+    std::vector<float> maxRadius;
+    std::vector<float> speed;
+    std::vector<uint64_t> retireMask;
+
+    explicit KernelState(size_t count) :
+        radius(count), opacity(count), maxRadius(count), speed(count), retireMask(RetireMaskWords(count))
+    {
+        std::mt19937 rng(12345);
+        std::uniform_real_distribution<float> age(0.0f, 1.0f);
+        for (size_t i = 0; i < count; ++i) {
+            maxRadius[i] = MAX_WAVE_RADIUS;
+            speed[i] = WAVE_SPEED * (0.5f + age(rng));
+            radius[i] = MAX_WAVE_RADIUS * age(rng);
+            opacity[i] = 1.0f - radius[i] / maxRadius[i];
+        }
+    }
+
+    size_t Step(const WaveKernel& kernel, float deltaTime)
+    {
+        return kernel.integrate(radius.data(), opacity.data(), maxRadius.data(), speed.data(),
+                                radius.size(), deltaTime, retireMask.data());
+    }
+};
+
+// Сверка ядра с эталонной скалярной реализацией: радиусы, прозрачности и маска
+// должны совпадать побитово. Нечётный размер проверяет и обработку хвоста
+bool CheckParity(const WaveKernel& kernel)
+{
+    const size_t count = 1027;
+    KernelState reference(count);
+    KernelState candidate(count);
+    const WaveKernel scalar = { "scalar", IntegrateWavesScalar };
+
+    for (int step = 0; step < 120; ++step) {
+        size_t expected = reference.Step(scalar, FRAME_TIME);
+        size_t actual = candidate.Step(kernel, FRAME_TIME);
+        if (expected != actual ||
+            std::memcmp(reference.radius.data(), candidate.radius.data(), count * sizeof(float)) != 0 ||
+            std::memcmp(reference.opacity.data(), candidate.opacity.data(), count * sizeof(float)) != 0 ||
+            std::memcmp(reference.retireMask.data(), candidate.retireMask.data(),
+                        reference.retireMask.size() * sizeof(uint64_t)) != 0) {
+            std::printf("wave_kernel.%s: расхождение с эталоном на шаге %d\n", kernel.name, step);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// Проверки ядер интегрирования волн: каждое доступное ядро против скалярного эталона
+bool RunWaveKernelTests()
+{
+    const WaveKernel* kernels[8];
+    size_t kernelCount = GetAvailableWaveKernels(kernels, 8);
+
+    bool passed = true;
+    for (size_t k = 0; k < kernelCount; ++k) {
+        passed = CheckParity(*kernels[k]) && passed;
+    }
+    return passed;
+}
@@ -0,0 +1,190 @@
+#include "TestHarness.h"
+#include "WavePool.h"
+#include "SimulationClock.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Параметры волны, совпадающие с WaterEffect::CreateWave
+constexpr float MAX_WAVE_RADIUS = 300.0f;
+constexpr float WAVE_SPEED = 150.0f * 1.5f;
+constexpr float FRAME_TIME = 0.016f;
+
+// Прежнее AoS-представление волны - эталон порядка и удаления
+struct LegacyWave {
+    float x;
+    float y;
+    float radius;
+    float maxRadius;
+    float opacity;
+    float speed;
+};
+
+// Скорость k-й волны с разбросом, как при серии кликов
+float SpeedFor(size_t k)
+{
+    return WAVE_SPEED * (0.5f + static_cast<float>(k % 97) / 97.0f);
+}
+
+// Прежний алгоритм обновления: erase посреди вектора для каждой погасшей волны
+void UpdateLegacy(std::vector<LegacyWave>& waves, float deltaTime)
+{
+    for (auto it = waves.begin(); it != waves.end();) {
+        it->radius += it->speed * deltaTime;
+        it->opacity = 1.0f - (it->radius / it->maxRadius);
+        if (it->opacity <= 0.0f || it->radius >= it->maxRadius) {
+            it = waves.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Прогон пула на часах фиксированного шага до указанного числа шагов.
+// frameTime() задаёт интервал до следующего кадра
+template <typename FrameTime>
+void RunOnClock(WavePool& pool, uint64_t targetSteps, FrameTime&& frameTime)
+{
+    ManualTimeSource time;
+    SimulationClock clock(&time, 1.0 / 60.0, 4);
+    for (size_t i = 0; i < 16; ++i) {
+        pool.Add(static_cast<float>(i), 0.0f, MAX_WAVE_RADIUS, SpeedFor(i));
+    }
+
+    uint64_t done = 0;
+    while (done < targetSteps) {
+        time.Advance(frameTime());
+        for (int steps = clock.Advance(); steps > 0 && done < targetSteps; --steps, ++done) {
+            pool.Update(static_cast<float>(clock.Tick()));
+        }
+    }
+}
+
+// Проверка часов: состояние зависит только от числа шагов, а не от дрожания кадров
+bool CheckClockDeterminism()
+{
+    const uint64_t targetSteps = 90;
+
+    WavePool steady(16);
+    RunOnClock(steady, targetSteps, []() { return 1.0 / 60.0; });
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> jitter(0.002, 0.045);
+    WavePool jittered(16);
+    RunOnClock(jittered, targetSteps, [&]() { return jitter(random); });
+
+    if (steady.Size() != jittered.Size() ||
+        std::memcmp(steady.Radius(), jittered.Radius(), steady.Size() * sizeof(float)) != 0) {
+        std::printf("simulation_clock: состояние зависит от интервалов кадров\n");
+        return false;
+    }
+
+    // Долгая пауза отрабатывается не более чем maxSteps шагами, остальное отбрасывается
+    ManualTimeSource time;
+    SimulationClock clock(&time, 0.01, 4);
+    time.Advance(1.005);
+    int steps = clock.Advance();
+    if (steps != 4 || clock.SkippedSteps() != 96 || clock.Alpha() < 0.0f || clock.Alpha() >= 1.0f) {
+        std::printf("simulation_clock: ограничение шагов не сработало (%d шагов, %llu отброшено)\n",
+                    steps, static_cast<unsigned long long>(clock.SkippedSteps()));
+        return false;
+    }
+    return true;
+}
+
+// Координаты X волн пула в порядке хранения (в проверках X служит номером волны)
+std::vector<float> PoolIds(const WavePool& pool)
+{
+    return std::vector<float>(pool.X(), pool.X() + pool.Size());
+}
+
+// Проверка удаления волн: Retire переносит последнюю волну на место удалённой,
+// Compact и уплотнение по маске в Update убирают ровно погасшие волны с сохранением порядка
+bool CheckRemoval()
+{
+    WavePool pool(16);
+    for (size_t i = 0; i < 10; ++i) {
+        pool.Add(static_cast<float>(i), 0.0f, MAX_WAVE_RADIUS, WAVE_SPEED);
+    }
+    pool.Retire(3);
+    pool.Retire(pool.Size() - 1);
+    pool.Retire(pool.Size());
+    if (PoolIds(pool) != std::vector<float>{ 0.0f, 1.0f, 2.0f, 9.0f, 4.0f, 5.0f, 6.0f, 7.0f }) {
+        std::printf("wave_pool: Retire нарушил порядок или число волн (%zu)\n", pool.Size());
+        return false;
+    }
+
+    // Погасшие волны добавляются сразу с максимальным радиусом
+    std::vector<float> alive;
+    pool.Clear();
+    for (size_t i = 0; i < 200; ++i) {
+        bool retired = i % 3 == 0 || (i >= 64 && i < 130);
+        pool.Add(static_cast<float>(i), 0.0f, MAX_WAVE_RADIUS, WAVE_SPEED, retired ? MAX_WAVE_RADIUS : 0.0f);
+        if (!retired) {
+            alive.push_back(static_cast<float>(i));
+        }
+    }
+    size_t removed = pool.Compact();
+    if (removed != 200 - alive.size() || PoolIds(pool) != alive) {
+        std::printf("wave_pool: Compact удалил %zu волн вместо %zu или нарушил порядок\n",
+                    removed, 200 - alive.size());
+        return false;
+    }
+
+    // Уплотнение по маске сравнивается с прежним erase, который сохраняет порядок
+    std::vector<LegacyWave> legacy;
+    pool.Clear();
+    for (size_t i = 0; i < 300; ++i) {
+        float radius = MAX_WAVE_RADIUS - static_cast<float>(i % 7) * 3.0f;
+        pool.Add(static_cast<float>(i), 0.0f, MAX_WAVE_RADIUS, WAVE_SPEED, radius);
+        legacy.push_back({ static_cast<float>(i), 0.0f, radius, MAX_WAVE_RADIUS, 1.0f - radius / MAX_WAVE_RADIUS, WAVE_SPEED });
+    }
+    removed = pool.Update(FRAME_TIME);
+    UpdateLegacy(legacy, FRAME_TIME);
+    std::vector<float> expected;
+    for (const LegacyWave& wave : legacy) {
+        expected.push_back(wave.x);
+    }
+    if (removed != 300 - expected.size() || PoolIds(pool) != expected) {
+        std::printf("wave_pool: уплотнение по маске удалило %zu волн вместо %zu или нарушило порядок\n",
+                    removed, 300 - expected.size());
+        return false;
+    }
+    return true;
+}
+
+// Пул фиксированного размера в установившемся режиме не растёт
+bool CheckSteadyCapacity()
+{
+    const size_t count = 1000;
+    WavePool pool(count);
+    size_t spawned = 0;
+    for (; spawned < count; ++spawned) {
+        pool.Add(0.0f, 0.0f, MAX_WAVE_RADIUS, SpeedFor(spawned));
+    }
+    for (int frame = 0; frame < 400; ++frame) {
+        pool.Update(FRAME_TIME);
+        while (pool.Size() < count) {
+            pool.Add(0.0f, 0.0f, MAX_WAVE_RADIUS, SpeedFor(spawned++));
+        }
+    }
+    if (pool.Capacity() != count) {
+        std::printf("wave_pool: неожиданный рост ёмкости %zu -> %zu\n", count, pool.Capacity());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// Проверки пула волн и часов симуляции
+bool RunWavePoolTests()
+{
+    bool passed = CheckClockDeterminism();
+    passed = CheckRemoval() && passed;
+    passed = CheckSteadyCapacity() && passed;
+    return passed;
+}
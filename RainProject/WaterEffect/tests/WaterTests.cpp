@@ -0,0 +1,58 @@
+#include "TestHarness.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+// Набор проверок подсистемы
+struct TestSuite {
+    const char* name;
+    bool (*run)();
+};
+
+const TestSuite TEST_SUITES[] = {
+    { "wave_pool", RunWavePoolTests },
+    { "wave_kernel", RunWaveKernelTests },
+    { "analytic_waves", RunAnalyticWaveTests },
+    { "heightfield", RunHeightFieldTests },
+    { "simulation", RunSimulationTests },
+    { "raster", RunRasterizerTests },
+    { "logger", RunLoggerTests },
+    { "trace_zones", RunTraceZoneTests },
+    { "frame_stats", RunFrameStatsTests },
+};
+
+} // namespace
+
+// Точка входа проверок: без аргументов выполняются все наборы, иначе - только названный
+// (так каждый набор регистрируется в ctest отдельным тестом)
+int main(int argc, char** argv)
+{
+    const char* only = argc == 2 ? argv[1] : nullptr;
+    if (argc > 2) {
+        std::printf("Использование: water_tests [набор]\n");
+        return 2;
+    }
+
+    size_t run = 0;
+    size_t failed = 0;
+    for (const TestSuite& suite : TEST_SUITES) {
+        if (only && std::strcmp(only, suite.name) != 0) {
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool passed = suite.run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("[%s] %s (%.2f с)\n", passed ? "  OK  " : " FAIL ", suite.name, seconds);
+        ++run;
+        failed += passed ? 0 : 1;
+    }
+
+    if (run == 0) {
+        std::printf("Неизвестный набор проверок: %s\n", only);
+        return 2;
+    }
+    return failed > 0 ? 1 : 0;
+}
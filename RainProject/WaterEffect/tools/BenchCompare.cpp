@@ -0,0 +1,471 @@
+// Сравнение двух прогонов water_bench (файлы --json) для поиска регрессий.
+// Для каждого замера, который есть в обоих файлах, повторы сравниваются
+// U-критерием Манна-Уитни: он не предполагает нормального распределения
+// времени и устойчив к редким выбросам. Регрессия - замер стал медленнее
+// больше чем на порог (по медианам) и различие значимо на уровне alpha.
+// При малом числе повторов без совпадающих значений p-значение считается точно,
+// иначе - нормальным приближением с поправкой на совпадения.
+// Код возврата: 0 - регрессий нет, 1 - есть регрессии, 2 - ошибка входных данных
+// или повторов слишком мало, чтобы регрессия могла быть найдена.
+//
+// Использование:
+//   water_benchcompare <база.json> <текущий.json> [--threshold=5] [--alpha=0.05] [--filter=подстрока]
+//
+// При alpha = 0.05 различие вообще может стать значимым только от 4 повторов с каждой
+// стороны (двусторонний точный критерий), поэтому water_bench лучше запускать
+// с --repetitions=10 и привязкой к процессору (--pin: привязывается только главный поток,
+// рабочие потоки многопоточных замеров распределяются по всем процессорам).
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Значение JSON (только то, что нужно для файлов water_bench)
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    double number = 0.0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    // Поле объекта или nullptr
+    const JsonValue* Find(const char* name) const {
+        for (const auto& member : members) {
+            if (member.first == name) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// Разбор JSON рекурсивным спуском
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : m_cursor(text.c_str()), m_end(text.c_str() + text.size()) {}
+
+    // Разбор документа целиком; false при синтаксической ошибке
+    bool Parse(JsonValue& value) {
+        if (!ParseValue(value, 0)) {
+            return false;
+        }
+        SkipSpace();
+        return m_cursor == m_end;
+    }
+
+private:
+    void SkipSpace() {
+        while (m_cursor < m_end && (*m_cursor == ' ' || *m_cursor == '\t' || *m_cursor == '\n' || *m_cursor == '\r')) {
+            ++m_cursor;
+        }
+    }
+
+    bool Consume(char expected) {
+        SkipSpace();
+        if (m_cursor < m_end && *m_cursor == expected) {
+            ++m_cursor;
+            return true;
+        }
+        return false;
+    }
+
+    bool ConsumeWord(const char* word) {
+        size_t length = std::strlen(word);
+        if (static_cast<size_t>(m_end - m_cursor) >= length && std::strncmp(m_cursor, word, length) == 0) {
+            m_cursor += length;
+            return true;
+        }
+        return false;
+    }
+
+    // Строка; экранирование \uXXXX сохраняется как есть (имена замеров - ASCII)
+    bool ParseString(std::string& out) {
+        if (!Consume('"')) {
+            return false;
+        }
+        out.clear();
+        while (m_cursor < m_end && *m_cursor != '"') {
+            if (*m_cursor == '\\' && m_cursor + 1 < m_end) {
+                ++m_cursor;
+                char escaped = *m_cursor;
+                out.push_back(escaped == 'n' ? '\n' : escaped == 't' ? '\t' : escaped);
+            } else {
+                out.push_back(*m_cursor);
+            }
+            ++m_cursor;
+        }
+        return Consume('"');
+    }
+
+    bool ParseValue(JsonValue& value, int depth) {
+        static constexpr int MAX_DEPTH = 32;
+        SkipSpace();
+        if (m_cursor >= m_end || depth > MAX_DEPTH) {
+            return false;
+        }
+
+        char c = *m_cursor;
+        if (c == '{') {
+            value.type = JsonValue::Type::Object;
+            ++m_cursor;
+            if (Consume('}')) {
+                return true;
+            }
+            do {
+                std::pair<std::string, JsonValue> member;
+                if (!ParseString(member.first) || !Consume(':') || !ParseValue(member.second, depth + 1)) {
+                    return false;
+                }
+                value.members.push_back(std::move(member));
+            } while (Consume(','));
+            return Consume('}');
+        }
+        if (c == '[') {
+            value.type = JsonValue::Type::Array;
+            ++m_cursor;
+            if (Consume(']')) {
+                return true;
+            }
+            do {
+                value.items.emplace_back();
+                if (!ParseValue(value.items.back(), depth + 1)) {
+                    return false;
+                }
+            } while (Consume(','));
+            return Consume(']');
+        }
+        if (c == '"') {
+            value.type = JsonValue::Type::String;
+            return ParseString(value.text);
+        }
+        if (ConsumeWord("true")) {
+            value.type = JsonValue::Type::Bool;
+            value.number = 1.0;
+            return true;
+        }
+        if (ConsumeWord("false")) {
+            value.type = JsonValue::Type::Bool;
+            return true;
+        }
+        if (ConsumeWord("null")) {
+            value.type = JsonValue::Type::Null;
+            return true;
+        }
+
+        // strtod читает и nan/inf, которых нет в JSON, но water_bench их не пишет
+        char* end = nullptr;
+        value.type = JsonValue::Type::Number;
+        value.number = std::strtod(m_cursor, &end);
+        if (end == m_cursor) {
+            return false;
+        }
+        m_cursor = end;
+        return true;
+    }
+
+private:
+    const char* m_cursor;
+    const char* m_end;
+};
+
+// Повторы одного замера: время на элемент в наносекундах
+struct BenchSamples {
+    std::string name;
+    std::vector<double> nsPerItem;
+};
+
+// Чтение результатов water_bench; false с сообщением об ошибке
+bool LoadResults(const char* path, std::vector<BenchSamples>& results)
+{
+    FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        std::fprintf(stderr, "Не удалось открыть %s\n", path);
+        return false;
+    }
+    std::string text;
+    char buffer[65536];
+    size_t read = 0;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, read);
+    }
+    std::fclose(file);
+
+    JsonValue root;
+    if (!JsonParser(text).Parse(root)) {
+        std::fprintf(stderr, "%s: не JSON\n", path);
+        return false;
+    }
+    const JsonValue* benchmarks = root.Find("benchmarks");
+    if (!benchmarks || benchmarks->type != JsonValue::Type::Array) {
+        std::fprintf(stderr, "%s: нет массива benchmarks (файл не от water_bench --json)\n", path);
+        return false;
+    }
+
+    for (const JsonValue& benchmark : benchmarks->items) {
+        const JsonValue* name = benchmark.Find("name");
+        const JsonValue* samples = benchmark.Find("ns_per_item");
+        if (!name || name->type != JsonValue::Type::String || !samples || samples->type != JsonValue::Type::Array) {
+            std::fprintf(stderr, "%s: замер без name или ns_per_item\n", path);
+            return false;
+        }
+        BenchSamples result;
+        result.name = name->text;
+        for (const JsonValue& sample : samples->items) {
+            if (sample.type == JsonValue::Type::Number) {
+                result.nsPerItem.push_back(sample.number);
+            }
+        }
+        if (!result.nsPerItem.empty()) {
+            results.push_back(std::move(result));
+        }
+    }
+    return true;
+}
+
+// Медиана значений (копия сортируется)
+double Median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : 0.5 * (values[middle - 1] + values[middle]);
+}
+
+// Точное распределение U при отсутствии совпадений: число перестановок
+// выборок размеров n1 и n2 с каждым значением U (рекуррентно по размерам)
+std::vector<double> ExactUDistribution(size_t n1, size_t n2)
+{
+    size_t maxU = n1 * n2;
+    // counts[a][b] - распределение для выборок a и b, хранится по слоям a
+    std::vector<std::vector<std::vector<double>>> counts(n1 + 1, std::vector<std::vector<double>>(n2 + 1));
+    for (size_t a = 0; a <= n1; ++a) {
+        for (size_t b = 0; b <= n2; ++b) {
+            std::vector<double>& current = counts[a][b];
+            current.assign(a * b + 1, 0.0);
+            if (a == 0 || b == 0) {
+                current[0] = 1.0;
+                continue;
+            }
+            // Наибольший элемент из первой выборки добавляет b к U, из второй - ничего
+            const std::vector<double>& fromFirst = counts[a - 1][b];
+            const std::vector<double>& fromSecond = counts[a][b - 1];
+            for (size_t u = 0; u < current.size(); ++u) {
+                double count = 0.0;
+                if (u >= b && u - b < fromFirst.size()) {
+                    count += fromFirst[u - b];
+                }
+                if (u < fromSecond.size()) {
+                    count += fromSecond[u];
+                }
+                current[u] = count;
+            }
+        }
+    }
+    std::vector<double> distribution = counts[n1][n2];
+    distribution.resize(maxU + 1, 0.0);
+    return distribution;
+}
+
+// Двустороннее p-значение U-критерия Манна-Уитни для выборок x и y
+double MannWhitneyPValue(const std::vector<double>& x, const std::vector<double>& y)
+{
+    static constexpr size_t EXACT_LIMIT = 20;   // Наибольший размер выборки для точного расчёта
+
+    size_t n1 = x.size();
+    size_t n2 = y.size();
+
+    // Совместное ранжирование; совпадающим значениям - средний ранг
+    std::vector<std::pair<double, int>> all;
+    all.reserve(n1 + n2);
+    for (double value : x) {
+        all.push_back({ value, 0 });
+    }
+    for (double value : y) {
+        all.push_back({ value, 1 });
+    }
+    std::sort(all.begin(), all.end());
+
+    double rankSumX = 0.0;
+    double tieTerm = 0.0;       // Сумма t^3 - t по группам совпадений
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) {
+            ++j;
+        }
+        double rank = 0.5 * static_cast<double>(i + 1 + j);
+        for (size_t k = i; k < j; ++k) {
+            if (all[k].second == 0) {
+                rankSumX += rank;
+            }
+        }
+        double t = static_cast<double>(j - i);
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+
+    double u = rankSumX - static_cast<double>(n1 * (n1 + 1)) / 2.0;
+    double mean = static_cast<double>(n1 * n2) / 2.0;
+
+    if (tieTerm == 0.0 && n1 <= EXACT_LIMIT && n2 <= EXACT_LIMIT) {
+        std::vector<double> distribution = ExactUDistribution(n1, n2);
+        double total = 0.0;
+        for (double count : distribution) {
+            total += count;
+        }
+        // Вероятность значения U не ближе к центру, чем наблюдаемое, с обеих сторон
+        double distance = std::fabs(u - mean);
+        double tail = 0.0;
+        for (size_t k = 0; k < distribution.size(); ++k) {
+            if (std::fabs(static_cast<double>(k) - mean) >= distance - 1e-9) {
+                tail += distribution[k];
+            }
+        }
+        return std::min(1.0, tail / total);
+    }
+
+    double n = static_cast<double>(n1 + n2);
+    double variance = static_cast<double>(n1 * n2) / 12.0 * ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+    if (variance <= 0.0) {
+        return 1.0;
+    }
+    // Поправка на непрерывность
+    double z = (std::fabs(u - mean) - 0.5) / std::sqrt(variance);
+    return z <= 0.0 ? 1.0 : std::erfc(z / std::sqrt(2.0));
+}
+
+// Наименьшее достижимое p-значение при отсутствии совпадений
+double MinimumPValue(size_t n1, size_t n2)
+{
+    // Две крайние перестановки из C(n1 + n2, n1)
+    double combinations = 1.0;
+    for (size_t k = 1; k <= n1; ++k) {
+        combinations = combinations * static_cast<double>(n2 + k) / static_cast<double>(k);
+    }
+    return 2.0 / combinations;
+}
+
+// Параметры сравнения
+struct CompareOptions {
+    const char* baselinePath = nullptr;
+    const char* currentPath = nullptr;
+    const char* filter = nullptr;   // Подстрока имени замера
+    double threshold = 5.0;         // Порог замедления, проценты
+    double alpha = 0.05;            // Уровень значимости
+};
+
+// Значение ключа вида --name=value или nullptr
+const char* OptionValue(const char* argument, const char* name)
+{
+    size_t length = std::strlen(name);
+    if (std::strncmp(argument, name, length) == 0 && argument[length] == '=') {
+        return argument + length + 1;
+    }
+    return nullptr;
+}
+
+// Разбор командной строки
+bool ParseOptions(int argc, char** argv, CompareOptions& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* value = nullptr;
+        if ((value = OptionValue(argv[i], "--threshold"))) {
+            options.threshold = std::atof(value);
+        } else if ((value = OptionValue(argv[i], "--alpha"))) {
+            options.alpha = std::atof(value);
+            if (options.alpha <= 0.0 || options.alpha >= 1.0) {
+                return false;
+            }
+        } else if ((value = OptionValue(argv[i], "--filter"))) {
+            options.filter = value;
+        } else if (argv[i][0] == '-') {
+            return false;
+        } else if (!options.baselinePath) {
+            options.baselinePath = argv[i];
+        } else if (!options.currentPath) {
+            options.currentPath = argv[i];
+        } else {
+            return false;
+        }
+    }
+    return options.baselinePath && options.currentPath;
+}
+
+} // namespace
+
+// Точка входа
+int main(int argc, char** argv)
+{
+    CompareOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "Использование: water_benchcompare <база.json> <текущий.json> "
+                             "[--threshold=проценты] [--alpha=0.05] [--filter=подстрока]\n");
+        return 2;
+    }
+
+    std::vector<BenchSamples> baseline;
+    std::vector<BenchSamples> current;
+    if (!LoadResults(options.baselinePath, baseline) || !LoadResults(options.currentPath, current)) {
+        return 2;
+    }
+
+    std::printf("%-44s %12s %12s %9s %9s\n", "benchmark", "base ns", "current ns", "change", "p");
+
+    size_t compared = 0;
+    size_t regressions = 0;
+    size_t improvements = 0;
+    size_t underpowered = 0;
+    for (const BenchSamples& before : baseline) {
+        if (options.filter && before.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        auto after = std::find_if(current.begin(), current.end(),
+                                  [&](const BenchSamples& result) { return result.name == before.name; });
+        if (after == current.end()) {
+            std::printf("%-44s нет в %s\n", before.name.c_str(), options.currentPath);
+            continue;
+        }
+
+        double medianBefore = Median(before.nsPerItem);
+        double medianAfter = Median(after->nsPerItem);
+        double change = medianBefore > 0.0 ? 100.0 * (medianAfter - medianBefore) / medianBefore : 0.0;
+        double p = MannWhitneyPValue(before.nsPerItem, after->nsPerItem);
+        if (MinimumPValue(before.nsPerItem.size(), after->nsPerItem.size()) > options.alpha) {
+            ++underpowered;
+        }
+
+        const char* verdict = "";
+        if (p < options.alpha && change > options.threshold) {
+            verdict = "  РЕГРЕССИЯ";
+            ++regressions;
+        } else if (p < options.alpha && change < -options.threshold) {
+            verdict = "  ускорение";
+            ++improvements;
+        }
+        ++compared;
+
+        std::printf("%-44s %12.3f %12.3f %+8.1f%% %9.4f%s\n",
+                    before.name.c_str(), medianBefore, medianAfter, change, p, verdict);
+    }
+
+    std::printf("\nСравнено замеров: %zu, регрессий: %zu, ускорений: %zu (порог %.1f%%, alpha %.3g)\n",
+                compared, regressions, improvements, options.threshold, options.alpha);
+    if (regressions > 0) {
+        return 1;
+    }
+
+    // Без регрессий ответ "регрессий нет" верен, только если они могли быть найдены
+    if (underpowered > 0) {
+        std::fprintf(stderr, "Замеров со слишком малым числом повторов для alpha %.3g: %zu "
+                             "(запустите water_bench с --repetitions=10)\n", options.alpha, underpowered);
+        return 2;
+    }
+    return 0;
+}
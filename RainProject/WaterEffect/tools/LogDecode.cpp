@@ -0,0 +1,132 @@
+// Чтение двоичного журнала (сегменты water_effect_log.N.bin) без приложения.
+// Записи содержат только идентификатор сообщения и сырые аргументы,
+// текст собирается здесь по той же таблице LogMessages.h, с которой журнал записан.
+// Время записей отсчитывается от открытия журнала, поэтому сегменты можно
+// передать вместе в любом порядке и отсортировать вывод по первому столбцу.
+//
+// Использование:
+//   water_logdecode <сегмент.bin>... [--csv]
+
+#include "LogMessages.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Вывод строки в поле CSV: кавычки удваиваются
+void PrintCsvField(const char* text)
+{
+    std::putchar('"');
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"') {
+            std::putchar('"');
+        }
+        std::putchar(*c);
+    }
+    std::putchar('"');
+}
+
+// Чтение и вывод всех записей; false, если файл повреждён
+bool DecodeLog(FILE* file, bool csv)
+{
+    LogFileHeader header = {};
+    if (std::fread(&header, sizeof(header), 1, file) != 1 || std::memcmp(header.magic, "WLOG", 4) != 0) {
+        std::fprintf(stderr, "Файл не является двоичным журналом\n");
+        return false;
+    }
+    if (header.version != LOG_FILE_VERSION) {
+        std::fprintf(stderr, "Неподдерживаемая версия журнала: %u\n", header.version);
+        return false;
+    }
+    // Сообщения только добавляются в конец таблицы, поэтому более старый журнал читается,
+    // а в более новом могут встретиться неизвестные идентификаторы
+    if (header.messageCount > static_cast<uint32_t>(LogMessageId::Count)) {
+        std::fprintf(stderr, "Журнал записан более новой таблицей сообщений (%u > %u)\n",
+                     header.messageCount, static_cast<unsigned>(LogMessageId::Count));
+    }
+
+    size_t records = 0;
+    size_t corrupt = 0;
+    LogRecordHeader record = {};
+    uint8_t payload[65536];
+    char text[1024];
+    while (std::fread(&record, sizeof(record), 1, file) == 1) {
+        // Пустая запись - незаписанный хвост сегмента после аварийного завершения
+        if (record.length == 0) {
+            break;
+        }
+        if (std::fread(payload, 1, record.length, file) != record.length) {
+            std::fprintf(stderr, "Журнал обрезан после записи %zu\n", records);
+            return false;
+        }
+        ++records;
+
+        uint16_t id = 0;
+        if (record.length >= sizeof(id)) {
+            std::memcpy(&id, payload, sizeof(id));
+        }
+        size_t textLength = 0;
+        if (!FormatLogEvent(payload, record.length, text, sizeof(text), textLength)) {
+            ++corrupt;
+            std::snprintf(text, sizeof(text), "<повреждённая запись, id=%u, %u байт>",
+                          static_cast<unsigned>(id), static_cast<unsigned>(record.length));
+            id = static_cast<uint16_t>(LogMessageId::Count);
+        }
+
+        bool known = id < static_cast<uint16_t>(LogMessageId::Count);
+        const char* level = known ? LogLevelName(LOG_MESSAGES[id].level) : "?";
+        const char* name = known ? LOG_MESSAGES[id].name : "?";
+        double timeUs = static_cast<double>(record.timeNs) / 1000.0;
+        if (csv) {
+            std::printf("%.3f,%s,%s,", timeUs, level, name);
+            PrintCsvField(text);
+            std::putchar('\n');
+        } else {
+            std::printf("%12.3f %-7s %-26s %s\n", timeUs, level, name, text);
+        }
+    }
+
+    if (corrupt > 0) {
+        std::fprintf(stderr, "Повреждённых записей: %zu из %zu\n", corrupt, records);
+    }
+    return true;
+}
+
+} // namespace
+
+// Точка входа
+int main(int argc, char** argv)
+{
+    std::vector<const char*> paths;
+    bool csv = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        std::fprintf(stderr, "Использование: water_logdecode <сегмент.bin>... [--csv]\n");
+        return 2;
+    }
+
+    if (csv) {
+        std::printf("time_us,level,message,text\n");
+    }
+
+    bool ok = true;
+    for (const char* path : paths) {
+        FILE* file = std::fopen(path, "rb");
+        if (!file) {
+            std::fprintf(stderr, "Не удалось открыть %s\n", path);
+            ok = false;
+            continue;
+        }
+        ok = DecodeLog(file, csv) && ok;
+        std::fclose(file);
+    }
+    return ok ? 0 : 1;
+}
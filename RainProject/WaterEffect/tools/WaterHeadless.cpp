@@ -0,0 +1,145 @@
+// Эффект воды без окна, Win32 и Direct2D.
+// Симуляция идёт кадрами с заданной частотой по собственным часам, волны появляются
+// со случайными интервалами (пуассоновский поток с постоянным зерном), а кадр строится
+// в памяти (FrameRunner): круги из того же списка заливок, что и в Render(), растеризуются
+// программно по плиткам на --threads потоках в кадр BGRA с предумноженной альфой
+// (или строится кадр поля высот). Перерисовывается только область, где волны были
+// в прошлом кадре или есть в этом, а без волн кадр не строится. Время кадра
+// идёт в гистограммы (FrameStats), в конце печатается пропускная способность.
+// Часы не ждут настоящего времени, поэтому прогон длится столько, сколько занимает работа.
+//
+// Использование:
+//   water_headless [--width=W] [--height=H] [--duration=S] [--spawn-rate=R] [--threads=N]
+//                  [--fps=F] [--mode=integrated|analytic|heightfield] [--cell-size=N]
+
+#include "AllocationTracker.h"
+#include "FrameRunner.h"
+#include "SimulationClock.h"
+#include "WaterSimulation.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+// Параметры командной строки
+struct HeadlessOptions {
+    int width = 1920;                   // Размер экрана
+    int height = 1080;
+    double duration = 10.0;             // Длительность прогона по часам симуляции, секунды
+    double spawnRate = 20.0;            // Волн в секунду
+    size_t threads = 0;                 // Потоки симуляции и отрисовки (0 - по числу ядер)
+    double fps = 60.0;                  // Частота кадров
+    WaveMode mode = WaveMode::Integrated;
+    int cellSize = WaterSimulation::HEIGHTFIELD_CELL_SIZE;
+};
+
+// Разбор командной строки
+bool ParseOptions(int argc, char** argv, HeadlessOptions& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* value = nullptr;
+        if ((value = OptionValue(argv[i], "--width"))) {
+            options.width = std::atoi(value);
+        } else if ((value = OptionValue(argv[i], "--height"))) {
+            options.height = std::atoi(value);
+        } else if ((value = OptionValue(argv[i], "--duration"))) {
+            options.duration = std::atof(value);
+        } else if ((value = OptionValue(argv[i], "--spawn-rate"))) {
+            options.spawnRate = std::atof(value);
+        } else if ((value = OptionValue(argv[i], "--threads"))) {
+            options.threads = static_cast<size_t>(std::strtoul(value, nullptr, 10));
+        } else if ((value = OptionValue(argv[i], "--fps"))) {
+            options.fps = std::atof(value);
+        } else if ((value = OptionValue(argv[i], "--cell-size"))) {
+            options.cellSize = std::atoi(value);
+        } else if ((value = OptionValue(argv[i], "--mode"))) {
+            if (!ParseWaveMode(value, options.mode)) {
+                std::fprintf(stderr, "Неизвестный режим: %s\n", value);
+                return false;
+            }
+        } else {
+            std::fprintf(stderr, "Неизвестный аргумент: %s\n", argv[i]);
+            return false;
+        }
+    }
+    if (options.width <= 0 || options.height <= 0 || options.duration <= 0.0 ||
+        options.fps <= 0.0 || options.spawnRate < 0.0) {
+        std::fprintf(stderr, "Размер экрана, длительность и частота кадров должны быть положительными\n");
+        return false;
+    }
+    return true;
+}
+
+// Прогон эффекта
+int RunHeadless(const HeadlessOptions& options)
+{
+    ManualTimeSource time;
+    WaterSimulation simulation;
+    simulation.SetWaveMode(options.mode);
+    simulation.SetHeightFieldCellSize(options.cellSize);
+    simulation.SetTimeSource(&time);
+    simulation.Initialize(options.width, options.height, options.threads);
+
+    FrameRunner runner;
+    runner.Initialize(simulation, options.width, options.height, options.threads,
+                      ALLOCATION_TRACKING ? AllocationCount : nullptr);
+
+    // Клики по экрану: интервалы между волнами распределены экспоненциально
+    std::mt19937 random(1);
+    std::exponential_distribution<double> spawnGap(options.spawnRate > 0.0 ? options.spawnRate : 1.0);
+    std::uniform_real_distribution<float> px(0.0f, static_cast<float>(options.width));
+    std::uniform_real_distribution<float> py(0.0f, static_cast<float>(options.height));
+    double nextSpawn = options.spawnRate > 0.0 ? spawnGap(random) : options.duration;
+
+    const double frameInterval = 1.0 / options.fps;
+    size_t spawns = 0;
+
+    auto runStart = std::chrono::steady_clock::now();
+    for (double now = frameInterval; now <= options.duration;
+         now = frameInterval * static_cast<double>(runner.Frames() + 1)) {
+        while (nextSpawn <= now) {
+            time.Set(nextSpawn);
+            simulation.CreateWave(px(random), py(random));
+            nextSpawn += spawnGap(random);
+            ++spawns;
+        }
+        time.Set(now);
+        runner.RunFrame();
+    }
+    double runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+
+    size_t frames = runner.Frames();
+    const Framebuffer& frame = runner.Frame();
+    double simulated = frameInterval * static_cast<double>(frames);
+    double perSecond = runSeconds > 0.0 ? 1.0 / runSeconds : 0.0;
+    std::printf("Экран:          %dx%d, режим %s, %.0f кадров/с\n",
+                options.width, options.height, WaveModeName(options.mode), options.fps);
+    std::printf("Событий:        %zu кадров, %zu волн, до %zu волн одновременно\n", frames, spawns, runner.MaxWaves());
+    std::printf("Время:          %.3f с симуляции за %.3f с (x%.1f)\n",
+                simulated, runSeconds, simulated * perSecond);
+    std::printf("Пропускная:     %.0f кадров/с, %.0f кругов/с, %.1f Мпикс/с\n",
+                static_cast<double>(frames) * perSecond, static_cast<double>(runner.Discs()) * perSecond,
+                static_cast<double>(frame.Width()) * frame.Height() * static_cast<double>(frames) * perSecond / 1e6);
+    runner.Stats().Print(stdout);
+    std::printf("Контрольная сумма: %.6e\n", runner.Checksum());
+    return runner.ReportSteadyAllocations() ? 0 : 1;
+}
+
+} // namespace
+
+// Точка входа
+int main(int argc, char** argv)
+{
+    HeadlessOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr,
+            "Использование:\n"
+            "  water_headless [--width=W] [--height=H] [--duration=S] [--spawn-rate=R] [--threads=N]\n"
+            "                 [--fps=F] [--mode=integrated|analytic|heightfield] [--cell-size=N]\n");
+        return 1;
+    }
+    return RunHeadless(options);
+}
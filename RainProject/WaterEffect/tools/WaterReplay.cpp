@@ -0,0 +1,211 @@
+// Воспроизведение трассы входных событий без окна и Direct2D.
+// Симуляция продвигается по меткам времени из трассы так быстро, как позволяет
+// процессор. Кадр строится в памяти так же, как в water_headless (FrameRunner): круги волн
+// растеризуются по плиткам в области перерисовки (или строится кадр поля высот).
+// Время обновления, отрисовки и интервал между кадрами сводятся в гистограммы (FrameStats).
+// Тот же файл трассы даёт тот же результат, поэтому жалобу на производительность
+// можно превратить в повторяемый замер.
+//
+// Использование:
+//   water_replay <трасса.bin> [--mode=integrated|analytic|heightfield] [--threads=N] [--zones=зоны.json]
+//   water_replay --generate=<трасса.bin> [--duration=S] [--spawn-rate=R] [--width=W] [--height=H]
+
+#include "AllocationTracker.h"
+#include "FrameRunner.h"
+#include "InputTrace.h"
+#include "SimulationClock.h"
+#include "TraceZones.h"
+#include "WaterSimulation.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+// Параметры командной строки
+struct ReplayOptions {
+    const char* tracePath = nullptr;    // Трасса для воспроизведения
+    const char* generatePath = nullptr; // Куда записать синтетическую трассу
+    const char* mode = nullptr;         // Переопределение режима из заголовка трассы
+    const char* zonesPath = nullptr;    // Куда сохранить зоны времени (Chrome Trace Event)
+    size_t threads = 0;                 // Потоки шага поля высот и отрисовки (0 - по числу ядер)
+    double duration = 10.0;             // Длительность синтетической трассы, секунды
+    double spawnRate = 20.0;            // Волн в секунду в синтетической трассе
+    int width = 1920;                   // Размер экрана синтетической трассы
+    int height = 1080;
+};
+
+// Разбор командной строки
+bool ParseOptions(int argc, char** argv, ReplayOptions& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* value = nullptr;
+        if ((value = OptionValue(argv[i], "--generate"))) {
+            options.generatePath = value;
+        } else if ((value = OptionValue(argv[i], "--mode"))) {
+            options.mode = value;
+        } else if ((value = OptionValue(argv[i], "--zones"))) {
+            options.zonesPath = value;
+        } else if ((value = OptionValue(argv[i], "--threads"))) {
+            options.threads = static_cast<size_t>(std::strtoul(value, nullptr, 10));
+        } else if ((value = OptionValue(argv[i], "--duration"))) {
+            options.duration = std::atof(value);
+        } else if ((value = OptionValue(argv[i], "--spawn-rate"))) {
+            options.spawnRate = std::atof(value);
+        } else if ((value = OptionValue(argv[i], "--width"))) {
+            options.width = std::atoi(value);
+        } else if ((value = OptionValue(argv[i], "--height"))) {
+            options.height = std::atoi(value);
+        } else if (argv[i][0] != '-' && !options.tracePath) {
+            options.tracePath = argv[i];
+        } else {
+            std::fprintf(stderr, "Неизвестный аргумент: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return options.tracePath || options.generatePath;
+}
+
+// Запись синтетической трассы: тики 60 Гц с дрожанием и случайные клики
+int GenerateTrace(const ReplayOptions& options)
+{
+    TraceHeader header = {};
+    header.screenWidth = static_cast<uint32_t>(options.width);
+    header.screenHeight = static_cast<uint32_t>(options.height);
+    header.waveMode = static_cast<uint8_t>(WaveMode::Integrated);
+    header.cellSize = static_cast<uint8_t>(WaterSimulation::HEIGHTFIELD_CELL_SIZE);
+
+    TraceWriter writer;
+    if (!writer.Open(options.generatePath, header)) {
+        std::fprintf(stderr, "Не удалось создать файл трассы %s\n", options.generatePath);
+        return 1;
+    }
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> tickJitter(0.014, 0.019);
+    std::exponential_distribution<double> spawnGap(options.spawnRate > 0.0 ? options.spawnRate : 1.0);
+    std::uniform_real_distribution<float> px(0.0f, static_cast<float>(options.width));
+    std::uniform_real_distribution<float> py(0.0f, static_cast<float>(options.height));
+
+    size_t ticks = 0;
+    size_t spawns = 0;
+    double nextSpawn = options.spawnRate > 0.0 ? spawnGap(random) : options.duration;
+    for (double time = 0.0; time < options.duration; time += tickJitter(random)) {
+        while (nextSpawn <= time) {
+            writer.WriteSpawn(nextSpawn, px(random), py(random), SpawnSource::Click);
+            nextSpawn += spawnGap(random);
+            ++spawns;
+        }
+        writer.WriteTick(time);
+        ++ticks;
+    }
+
+    writer.Close();
+    std::printf("Трасса %s: %zu тиков, %zu волн, %.1f с\n", options.generatePath, ticks, spawns, options.duration);
+    return 0;
+}
+
+// Воспроизведение трассы
+int ReplayTrace(const ReplayOptions& options)
+{
+    TraceReader reader;
+    if (!reader.Open(options.tracePath)) {
+        std::fprintf(stderr, "Не удалось прочитать трассу %s\n", options.tracePath);
+        return 1;
+    }
+
+    const TraceHeader& header = reader.Header();
+    if (header.waveMode > static_cast<uint8_t>(WaveMode::HeightField)) {
+        std::fprintf(stderr, "Неизвестный режим в заголовке трассы: %u\n", header.waveMode);
+        return 1;
+    }
+    WaveMode mode = static_cast<WaveMode>(header.waveMode);
+    if (options.mode && !ParseWaveMode(options.mode, mode)) {
+        std::fprintf(stderr, "Неизвестный режим: %s\n", options.mode);
+        return 1;
+    }
+
+    // Зоны времени пишутся только по запросу, иначе они стоят одной проверки на зону
+    GetZoneRecorder().SetThreadName("Воспроизведение");
+    GetZoneRecorder().SetEnabled(options.zonesPath != nullptr);
+
+    // Время симуляции берётся только из трассы
+    ManualTimeSource time;
+    WaterSimulation simulation;
+    simulation.SetWaveMode(mode);
+    simulation.SetHeightFieldCellSize(header.cellSize);
+    simulation.SetTimeSource(&time);
+    simulation.Initialize(static_cast<int>(header.screenWidth), static_cast<int>(header.screenHeight), options.threads);
+
+    // Кадры строятся в памяти так же, как в water_headless
+    FrameRunner runner;
+    runner.Initialize(simulation, static_cast<int>(header.screenWidth), static_cast<int>(header.screenHeight),
+                      options.threads, ALLOCATION_TRACKING ? AllocationCount : nullptr);
+    size_t spawns = 0;
+    double traceEnd = 0.0;
+
+    auto replayStart = std::chrono::steady_clock::now();
+    TraceEvent event;
+    while (reader.Next(event)) {
+        time.Set(event.time);
+        traceEnd = event.time;
+
+        if (event.type == TraceEventType::Spawn) {
+            simulation.CreateWave(event.x, event.y);
+            ++spawns;
+            continue;
+        }
+
+        runner.RunFrame();
+    }
+    double replaySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replayStart).count();
+
+    std::printf("Трасса:         %s (%ux%u, режим %s)\n", options.tracePath,
+                header.screenWidth, header.screenHeight, WaveModeName(mode));
+    std::printf("Событий:        %zu кадров, %zu волн, до %zu волн одновременно\n",
+                runner.Frames(), spawns, runner.MaxWaves());
+    std::printf("Время:          %.3f с трассы за %.3f с (x%.1f)\n",
+                traceEnd, replaySeconds, replaySeconds > 0.0 ? traceEnd / replaySeconds : 0.0);
+    runner.Stats().Print(stdout);
+    std::printf("Шагов:          %llu (отброшено %llu)\n",
+                static_cast<unsigned long long>(simulation.Clock().Steps()),
+                static_cast<unsigned long long>(simulation.Clock().SkippedSteps()));
+    std::printf("Контрольная сумма: %.6e\n", runner.Checksum());
+    bool steady = runner.ReportSteadyAllocations();
+
+    if (options.zonesPath) {
+        GetZoneRecorder().SetEnabled(false);
+        if (!GetZoneRecorder().ExportChromeJson(options.zonesPath)) {
+            std::fprintf(stderr, "Не удалось сохранить зоны в %s\n", options.zonesPath);
+            return 1;
+        }
+        std::printf("Зоны:           %zu в %s\n", GetZoneRecorder().EventCount(), options.zonesPath);
+    }
+
+    return steady ? 0 : 1;
+}
+
+} // namespace
+
+// Точка входа
+int main(int argc, char** argv)
+{
+    ReplayOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr,
+            "Использование:\n"
+            "  water_replay <трасса.bin> [--mode=integrated|analytic|heightfield] [--threads=N] [--zones=зоны.json]\n"
+            "  water_replay --generate=<трасса.bin> [--duration=S] [--spawn-rate=R] [--width=W] [--height=H]\n");
+        return 1;
+    }
+
+    if (options.generatePath) {
+        int result = GenerateTrace(options);
+        if (result != 0 || !options.tracePath) {
+            return result;
+        }
+    }
+    return ReplayTrace(options);
+}